@@ -124,10 +124,9 @@ namespace Splines {
 
   void
   AkimaSpline::build() {
-    string const msg{ fmt::format("AkimaSpline[{}]::build():", m_name ) };
-    UTILS_ASSERT( m_npts > 1, "{} npts = {} not enought points\n", msg, m_npts );
-    Utils::check_NaN( m_X, msg+" X ", m_npts, __LINE__, __FILE__ );
-    Utils::check_NaN( m_Y, msg+" Y ", m_npts, __LINE__, __FILE__ );
+    UTILS_ASSERT( m_npts > 1, "AkimaSpline[{}]::build(): npts = {} not enought points\n", m_name, m_npts );
+    check_NaN( m_X, m_npts, "AkimaSpline", "X", __LINE__, __FILE__ );
+    check_NaN( m_Y, m_npts, "AkimaSpline", "Y", __LINE__, __FILE__ );
     integer ibegin{0};
     integer iend{0};
 
@@ -141,7 +140,7 @@ namespace Splines {
       ibegin = iend;
     } while ( iend < m_npts );
 
-    Utils::check_NaN( m_Yp, msg+" Yp", m_npts, __LINE__, __FILE__ );
+    check_NaN( m_Yp, m_npts, "AkimaSpline", "Yp", __LINE__, __FILE__ );
     m_search.must_reset();
   }
 
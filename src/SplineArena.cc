@@ -0,0 +1,77 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+
+#include "Splines.hh"
+
+namespace Splines {
+
+  SplineArena::SplineArena(
+    size_t                      initial_bytes,
+    std::pmr::memory_resource * upstream
+  )
+  : m_resource( initial_bytes, upstream )
+  , m_splines( &m_resource )
+  {}
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  SplineArena::SplineArena(
+    void                      * buffer,
+    size_t                      bytes,
+    std::pmr::memory_resource * upstream
+  )
+  : m_resource( buffer, bytes, upstream )
+  , m_splines( &m_resource )
+  {}
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineArena::release() {
+    // destroy in reverse order of construction, memory is not freed one by one
+    for ( auto it{ m_splines.rbegin() }; it != m_splines.rend(); ++it ) (*it)->~Spline();
+    m_splines.clear();
+    m_splines.shrink_to_fit(); // the vector storage lives in the arena too
+    m_resource.release();
+    m_bytes = 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type *
+  SplineArena::alloc_real( integer n ) {
+    UTILS_ASSERT( n >= 0, "SplineArena::alloc_real( n = {} ), n must be >= 0\n", n );
+    size_t const bytes{ static_cast<size_t>(n)*sizeof(real_type) };
+    m_bytes += bytes;
+    return static_cast<real_type*>( m_resource.allocate( bytes, alignof(real_type) ) );
+  }
+
+}
+
+// EOF: SplineArena.cc
@@ -0,0 +1,314 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+
+#include "Splines.hh"
+
+namespace Splines {
+
+  // members built (or query chunks evaluated) by each task
+  static integer const bank_build_chunk{ 256 };
+  static integer const bank_eval_chunk{ 4096 };
+
+  SplineBank::SplineBank( string_view name, integer num_threads )
+  : m_name( name )
+  , m_pool( new WorkStealingPool( num_threads ) )
+  {}
+
+  SplineBank::~SplineBank() {}
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineBank::setup( SplineType1D type ) {
+    UTILS_ASSERT(
+      type == SplineType1D::LINEAR || type == SplineType1D::CUBIC  ||
+      type == SplineType1D::AKIMA  || type == SplineType1D::BESSEL ||
+      type == SplineType1D::PCHIP  || type == SplineType1D::HERMITE,
+      "SplineBank[{}]::setup( {} ), type not supported\n", m_name, to_string(type)
+    );
+    m_type = type;
+    this->clear();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineBank::reserve( integer nspl, integer npts ) {
+    m_offset.reserve( size_t(nspl+1) );
+    m_X.reserve( size_t(npts) );
+    m_Y.reserve( size_t(npts) );
+    if ( !is_linear() ) m_Yp.reserve( size_t(npts) );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineBank::clear() {
+    m_offset.assign( 1, 0 );
+    m_X.clear();
+    m_Y.clear();
+    m_Yp.clear();
+    m_built = false;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineBank::check_id( integer id, char const where[] ) const {
+    UTILS_ASSERT(
+      m_built && id >= 0 && id < num_splines(),
+      "SplineBank[{}]::{}( id = {} ), id must be in [0,{}) and the bank built\n",
+      m_name, where, id, num_splines()
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineBank::check_nodes(
+    integer         id,
+    real_type const x[],
+    integer         n,
+    char const      where[]
+  ) const {
+    UTILS_ASSERT(
+      n >= 2, "SplineBank[{}]::{}, member {} has npts = {}, must be >= 2\n",
+      m_name, where, id, n
+    );
+    for ( integer i{1}; i < n; ++i ) {
+      UTILS_ASSERT(
+        x[i-1] < x[i],
+        "SplineBank[{}]::{}, member {}: nodes must be strictly increasing, X[{}] = {} >= X[{}] = {}\n",
+        m_name, where, id, i-1, x[i-1], i, x[i]
+      );
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  SplineBank::add( real_type const x[], real_type const y[], integer n ) {
+    UTILS_ASSERT(
+      m_type != SplineType1D::HERMITE,
+      "SplineBank[{}]::add( x, y, n ), HERMITE members need the slopes\n", m_name
+    );
+    check_nodes( num_splines(), x, n, "add" );
+    m_X.insert( m_X.end(), x, x+n );
+    m_Y.insert( m_Y.end(), y, y+n );
+    if ( !is_linear() ) m_Yp.resize( m_Yp.size()+size_t(n) );
+    m_offset.push_back( m_offset.back()+n );
+    m_built = false;
+    return num_splines()-1;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  SplineBank::add(
+    real_type const x[],
+    real_type const y[],
+    real_type const yp[],
+    integer         n
+  ) {
+    UTILS_ASSERT(
+      m_type == SplineType1D::HERMITE,
+      "SplineBank[{}]::add( x, y, yp, n ), available only for HERMITE members\n", m_name
+    );
+    check_nodes( num_splines(), x, n, "add" );
+    m_X.insert( m_X.end(), x, x+n );
+    m_Y.insert( m_Y.end(), y, y+n );
+    m_Yp.insert( m_Yp.end(), yp, yp+n );
+    m_offset.push_back( m_offset.back()+n );
+    m_built = false;
+    return num_splines()-1;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineBank::run( integer ntasks, std::function<void(integer)> const & task ) const {
+    // the pool runs one job at a time: a caller finding it busy does
+    // the job in its own thread instead of waiting for the other batch
+    std::unique_lock<std::mutex> lock( m_run_mutex, std::try_to_lock );
+    if ( lock.owns_lock() ) m_pool->run( ntasks, task );
+    else for ( integer t{0}; t < ntasks; ++t ) task( t );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineBank::build_member( integer id, vector<real_type> & work ) {
+    size_t    const i0 { size_t(m_offset[size_t(id)]) };
+    integer   const n  { num_points( id ) };
+    real_type const * X{ m_X.data()  + i0 };
+    real_type const * Y{ m_Y.data()  + i0 };
+    real_type       * Yp{ m_Yp.data() + i0 };
+    switch ( m_type ) {
+    case SplineType1D::CUBIC:
+      CubicSpline_build( X, Y, Yp, n, m_bc0, m_bcn );
+      break;
+    case SplineType1D::AKIMA:
+      if ( work.size() < size_t(n) ) work.resize( size_t(n) );
+      Akima_build( X, Y, Yp, work.data(), n );
+      break;
+    case SplineType1D::BESSEL:
+      Bessel_build( X, Y, Yp, n );
+      break;
+    case SplineType1D::PCHIP:
+      Pchip_build( X, Y, Yp, n );
+      break;
+    default: // LINEAR and HERMITE: nothing to do
+      break;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineBank::build() {
+    integer const nspl{ num_splines() };
+    if ( !is_linear() && m_type != SplineType1D::HERMITE ) {
+      integer const ntasks{ (nspl+bank_build_chunk-1)/bank_build_chunk };
+      run( ntasks, [this,nspl]( integer t ) {
+        vector<real_type> work;
+        integer const id1{ std::min( nspl, (t+1)*bank_build_chunk ) };
+        for ( integer id{t*bank_build_chunk}; id < id1; ++id ) build_member( id, work );
+      } );
+    }
+    m_built = true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineBank::build(
+    integer         nspl,
+    integer   const offset[],
+    real_type const X[],
+    real_type const Y[],
+    real_type const Yp[]
+  ) {
+    UTILS_ASSERT(
+      nspl >= 0 && offset[0] == 0,
+      "SplineBank[{}]::build, nspl = {}, offset[0] = {} (must be 0)\n",
+      m_name, nspl, offset[0]
+    );
+    UTILS_ASSERT(
+      (m_type == SplineType1D::HERMITE) == (Yp != nullptr),
+      "SplineBank[{}]::build, Yp must be given only for HERMITE members\n", m_name
+    );
+    for ( integer id{0}; id < nspl; ++id )
+      check_nodes( id, X+offset[id], offset[id+1]-offset[id], "build" );
+    this->clear();
+    integer const npts{ offset[nspl] };
+    m_offset.assign( offset, offset+nspl+1 );
+    m_X.assign( X, X+npts );
+    m_Y.assign( Y, Y+npts );
+    if      ( Yp != nullptr ) m_Yp.assign( Yp, Yp+npts );
+    else if ( !is_linear()  ) m_Yp.resize( size_t(npts) );
+    this->build();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineBank::eval(
+    integer   const ids[],
+    real_type const xs[],
+    real_type       out[],
+    integer         n,
+    integer         deriv
+  ) const {
+    UTILS_ASSERT(
+      deriv >= 0 && deriv <= 3,
+      "SplineBank[{}]::eval, deriv = {} must be in [0,3]\n", m_name, deriv
+    );
+    if ( n <= 0 ) return;
+    UTILS_ASSERT( m_built, "SplineBank[{}]::eval, bank not built\n", m_name );
+
+    // group the queries by member: counting sort of the indices by `ids`,
+    // when the members are many more than the queries sort them instead
+    integer const nspl{ num_splines() };
+    vector<integer> perm( static_cast<size_t>(n) );
+    for ( integer k{0}; k < n; ++k ) {
+      UTILS_ASSERT(
+        ids[k] >= 0 && ids[k] < nspl,
+        "SplineBank[{}]::eval, ids[{}] = {} must be in [0,{})\n", m_name, k, ids[k], nspl
+      );
+    }
+    if ( nspl <= 4*n ) {
+      vector<integer> cnt( static_cast<size_t>(nspl+1), 0 );
+      for ( integer k{0}; k < n; ++k ) ++cnt[size_t(ids[k])+1];
+      for ( integer id{0}; id < nspl; ++id ) cnt[size_t(id)+1] += cnt[size_t(id)];
+      for ( integer k{0}; k < n; ++k ) perm[size_t(cnt[size_t(ids[k])]++)] = k;
+    } else {
+      for ( integer k{0}; k < n; ++k ) perm[size_t(k)] = k;
+      std::stable_sort(
+        perm.begin(), perm.end(),
+        [ids]( integer a, integer b ) { return ids[a] < ids[b]; }
+      );
+    }
+
+    auto kernel = [&]( integer t ) {
+      integer const k1{ std::min( n, (t+1)*bank_eval_chunk ) };
+      for ( integer k{t*bank_eval_chunk}; k < k1; ++k ) {
+        integer const j{ perm[size_t(k)] };
+        switch ( deriv ) {
+        case 0:  out[j] = eval_der<0>( ids[j], xs[j] ); break;
+        case 1:  out[j] = eval_der<1>( ids[j], xs[j] ); break;
+        case 2:  out[j] = eval_der<2>( ids[j], xs[j] ); break;
+        default: out[j] = eval_der<3>( ids[j], xs[j] ); break;
+        }
+      }
+    };
+    run( (n+bank_eval_chunk-1)/bank_eval_chunk, kernel );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  size_t
+  SplineBank::memory_bytes() const {
+    return sizeof(SplineBank) +
+           m_offset.capacity() * sizeof(integer) +
+           ( m_X.capacity() + m_Y.capacity() + m_Yp.capacity() ) * sizeof(real_type);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  string
+  SplineBank::info() const {
+    return fmt::format(
+      "SplineBank[{}] of type = {}, {} splines, {} points, {} bytes, {} threads",
+      m_name, to_string(m_type), num_splines(), num_points(), memory_bytes(), m_pool->size()
+    );
+  }
+
+}
+
+// EOF: SplineBank.cc
@@ -0,0 +1,373 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cstring>
+#include <limits>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+using namespace std; // load standard namspace
+#endif
+
+namespace Splines {
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  TiledBiCubicSpline::TiledBiCubicSpline( string_view name )
+  : SplineSurf( name )
+  , m_mem_tiled( fmt::format("TiledBiCubicSpline[{}]",name) )
+  {}
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  TiledBiCubicSpline::make_spline() {
+    UTILS_ERROR(
+      "TiledBiCubicSpline[{}]: cannot be built from data in memory,"
+      " use open_grid or open_raster\n", m_name
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  TiledBiCubicSpline::open_source(
+    string_view     file_name,
+    size_t    const offset,
+    integer   const value_size,
+    bool      const by_x_rows,
+    real_type const x[],
+    integer   const nx,
+    real_type const y[],
+    integer   const ny
+  ) {
+    UTILS_ASSERT(
+      nx > 1 && ny > 1,
+      "TiledBiCubicSpline[{}]: bad sizes nx={} ny={}\n", m_name, nx, ny
+    );
+    std::lock_guard<std::mutex> lock(m_file_mutex);
+    if ( m_file.is_open() ) m_file.close();
+    m_file.clear();
+    m_file.open( string(file_name), std::ios::binary );
+    UTILS_ASSERT(
+      m_file.good(), "TiledBiCubicSpline[{}]: cannot open `{}`\n", m_name, file_name
+    );
+    m_file_name  = file_name;
+    m_offset     = offset;
+    m_value_size = value_size;
+    m_by_x_rows  = by_x_rows;
+
+    m_nx = nx;
+    m_ny = ny;
+    m_mem_tiled.reallocate( nx+ny );
+    m_X = m_mem_tiled( nx );
+    m_Y = m_mem_tiled( ny );
+    m_Z = nullptr;
+    std::copy_n( x, nx, m_X );
+    std::copy_n( y, ny, m_Y );
+    m_x_closed = m_y_closed = false;
+    m_search_x.must_reset();
+    m_search_y.must_reset();
+
+    // one pass on the values for z_min/z_max
+    size_t const nn{ size_t(nx)*size_t(ny) };
+    size_t const chunk{ size_t(1) << 20 };
+    vector<char> buffer( chunk*size_t(value_size) );
+    m_file.seekg( std::streamoff(offset) );
+    m_Z_min = std::numeric_limits<real_type>::max();
+    m_Z_max = -m_Z_min;
+    for ( size_t done{0}; done < nn; ) {
+      size_t const n{ std::min( chunk, nn-done ) };
+      m_file.read( buffer.data(), std::streamsize(n*size_t(value_size)) );
+      UTILS_ASSERT(
+        m_file.good(), "TiledBiCubicSpline[{}]: `{}` is truncated\n", m_name, file_name
+      );
+      for ( size_t k{0}; k < n; ++k ) {
+        real_type v;
+        if ( value_size == 4 ) { float f; std::memcpy( &f, buffer.data()+4*k, 4 ); v = f; }
+        else                   { std::memcpy( &v, buffer.data()+8*k, 8 ); }
+        if ( v < m_Z_min ) m_Z_min = v;
+        if ( v > m_Z_max ) m_Z_max = v;
+      }
+      done += n;
+    }
+    setup_tiles();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  TiledBiCubicSpline::open_raster(
+    string_view     file_name,
+    real_type const x[],
+    integer   const nx,
+    real_type const y[],
+    integer   const ny,
+    bool      const single_precision,
+    bool      const fortran_storage,
+    bool      const transposed
+  ) {
+    open_source(
+      file_name, 0, single_precision ? 4 : 8,
+      transposed != fortran_storage, x, nx, y, ny
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  TiledBiCubicSpline::setup_tiles() {
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    m_lru.clear();
+    m_lru_pos.clear();
+    if ( m_nx > 1 && m_ny > 1 ) {
+      m_num_tiles_x = (m_nx-1 + m_tile_nx-1) / m_tile_nx;
+      m_num_tiles_y = (m_ny-1 + m_tile_ny-1) / m_tile_ny;
+    }
+    m_max_tiles = std::max( size_t(1), m_cache_bytes / tile_bytes() );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  size_t
+  TiledBiCubicSpline::tile_bytes() const {
+    // Z, DX, DY, DXY and the axes of a tile with overlap
+    size_t const nx{ size_t(m_tile_nx+3) };
+    size_t const ny{ size_t(m_tile_ny+3) };
+    return ( 4*nx*ny + nx + ny ) * sizeof(real_type) + sizeof(BiCubicSpline);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  TiledBiCubicSpline::set_tile_size( integer const tile_nx, integer const tile_ny ) {
+    UTILS_ASSERT(
+      tile_nx > 1 && tile_ny > 1,
+      "TiledBiCubicSpline[{}]::set_tile_size({},{}) sizes must be > 1\n",
+      m_name, tile_nx, tile_ny
+    );
+    m_tile_nx = tile_nx;
+    m_tile_ny = tile_ny;
+    setup_tiles();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  TiledBiCubicSpline::set_cache_bytes( size_t const bytes ) {
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    m_cache_bytes = bytes;
+    m_max_tiles   = std::max( size_t(1), m_cache_bytes / tile_bytes() );
+    while ( m_lru.size() > m_max_tiles ) {
+      m_lru_pos.erase( m_lru.back().first );
+      m_lru.pop_back();
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  TiledBiCubicSpline::clear_cache() {
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    m_lru.clear();
+    m_lru_pos.clear();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  TiledBiCubicSpline::cached_tiles() const {
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    return integer(m_lru.size());
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  size_t
+  TiledBiCubicSpline::tile_loads() const {
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    return m_tile_loads;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  TiledBiCubicSpline::Tile
+  TiledBiCubicSpline::load_tile( integer const ti, integer const tj ) const {
+    // cells of the tile plus one node of overlap on each side
+    integer const ia{ std::max( 0, ti*m_tile_nx - 1 ) };
+    integer const ib{ std::min( m_nx-1, (ti+1)*m_tile_nx + 1 ) };
+    integer const ja{ std::max( 0, tj*m_tile_ny - 1 ) };
+    integer const jb{ std::min( m_ny-1, (tj+1)*m_tile_ny + 1 ) };
+    integer const tnx{ ib-ia+1 };
+    integer const tny{ jb-ja+1 };
+
+    // rows of the source are contiguous along y (by_x_rows) or along x
+    integer const nrow { m_by_x_rows ? tnx : tny };
+    integer const ncol { m_by_x_rows ? tny : tnx };
+    integer const r0   { m_by_x_rows ? ia  : ja  };
+    integer const c0   { m_by_x_rows ? ja  : ia  };
+    integer const ld   { m_by_x_rows ? m_ny : m_nx };
+    size_t  const vs   { size_t(m_value_size) };
+
+    vector<char>      row( size_t(ncol)*vs );
+    vector<real_type> z( size_t(tnx)*size_t(tny) ); // z[i*tny+j]
+    {
+      std::lock_guard<std::mutex> lock(m_file_mutex);
+      for ( integer r{0}; r < nrow; ++r ) {
+        size_t const pos{ m_offset + ( size_t(r0+r)*size_t(ld) + size_t(c0) )*vs };
+        m_file.seekg( std::streamoff(pos) );
+        m_file.read( row.data(), std::streamsize(row.size()) );
+        UTILS_ASSERT(
+          m_file.good(),
+          "TiledBiCubicSpline[{}]: read of `{}` failed at offset {}\n",
+          m_name, m_file_name, pos
+        );
+        for ( integer c{0}; c < ncol; ++c ) {
+          real_type v;
+          if ( vs == 4 ) { float f; std::memcpy( &f, row.data()+4*c, 4 ); v = f; }
+          else           { std::memcpy( &v, row.data()+8*c, 8 ); }
+          if ( m_by_x_rows ) z[ size_t(r)*size_t(tny) + size_t(c) ] = v;
+          else               z[ size_t(c)*size_t(tny) + size_t(r) ] = v;
+        }
+      }
+    }
+
+    auto S = std::make_shared<BiCubicSpline>( fmt::format( "{}[{},{}]", m_name, ti, tj ) );
+    // same extrapolation of the whole surface
+    if ( m_x_can_extend ) S->make_x_unbounded(); else S->make_x_bounded();
+    if ( m_y_can_extend ) S->make_y_unbounded(); else S->make_y_bounded();
+    S->build( m_X+ia, 1, m_Y+ja, 1, z.data(), tny, tnx, tny, false, true );
+    return S;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  TiledBiCubicSpline::Tile
+  TiledBiCubicSpline::get_tile( integer const ti, integer const tj ) const {
+    integer const key{ ti * m_num_tiles_y + tj };
+    {
+      std::lock_guard<std::mutex> lock(m_cache_mutex);
+      auto it{ m_lru_pos.find(key) };
+      if ( it != m_lru_pos.end() ) {
+        m_lru.splice( m_lru.begin(), m_lru, it->second );
+        return it->second->second;
+      }
+    }
+    // read without holding the cache lock, other readers can proceed
+    Tile T{ load_tile( ti, tj ) };
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    ++m_tile_loads;
+    auto it{ m_lru_pos.find(key) };
+    if ( it != m_lru_pos.end() ) { // loaded meanwhile by another reader
+      m_lru.splice( m_lru.begin(), m_lru, it->second );
+      return it->second->second;
+    }
+    m_lru.emplace_front( key, T );
+    m_lru_pos[key] = m_lru.begin();
+    while ( m_lru.size() > m_max_tiles ) {
+      m_lru_pos.erase( m_lru.back().first );
+      m_lru.pop_back();
+    }
+    return T;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  TiledBiCubicSpline::Tile
+  TiledBiCubicSpline::find_tile( real_type const x, real_type const y ) const {
+    UTILS_ASSERT(
+      m_num_tiles_x > 0, "TiledBiCubicSpline[{}]: no grid opened\n", m_name
+    );
+    std::pair<integer,real_type> X(0,x), Y(0,y);
+    m_search_x.find( X );
+    m_search_y.find( Y );
+    integer const ti{ std::min( X.first / m_tile_nx, m_num_tiles_x-1 ) };
+    integer const tj{ std::min( Y.first / m_tile_ny, m_num_tiles_y-1 ) };
+    return get_tile( ti, tj );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  TiledBiCubicSpline::eval( real_type const x, real_type const y ) const
+  { return find_tile(x,y)->eval(x,y); }
+
+  void
+  TiledBiCubicSpline::D( real_type const x, real_type const y, real_type d[3] ) const
+  { find_tile(x,y)->D(x,y,d); }
+
+  real_type
+  TiledBiCubicSpline::Dx( real_type const x, real_type const y ) const
+  { return find_tile(x,y)->Dx(x,y); }
+
+  real_type
+  TiledBiCubicSpline::Dy( real_type const x, real_type const y ) const
+  { return find_tile(x,y)->Dy(x,y); }
+
+  void
+  TiledBiCubicSpline::DD( real_type const x, real_type const y, real_type dd[6] ) const
+  { find_tile(x,y)->DD(x,y,dd); }
+
+  real_type
+  TiledBiCubicSpline::Dxx( real_type const x, real_type const y ) const
+  { return find_tile(x,y)->Dxx(x,y); }
+
+  real_type
+  TiledBiCubicSpline::Dxy( real_type const x, real_type const y ) const
+  { return find_tile(x,y)->Dxy(x,y); }
+
+  real_type
+  TiledBiCubicSpline::Dyy( real_type const x, real_type const y ) const
+  { return find_tile(x,y)->Dyy(x,y); }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  TiledBiCubicSpline::write_to_stream( ostream_type & s ) const {
+    fmt::print( s,
+      "Tiled Bicubic spline, nx = {} ny = {}\n"
+      "file: {}\n"
+      "tiles: {} x {} of {} x {} cells, cached {} (max {})\n",
+      m_nx, m_ny, m_file_name,
+      m_num_tiles_x, m_num_tiles_y, m_tile_nx, m_tile_ny,
+      cached_tiles(), m_max_tiles
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  char const *
+  TiledBiCubicSpline::type_name() const
+  { return "TiledBiCubic"; }
+
+}
+
+// EOF: SplineBiCubicTiled.cc
@@ -0,0 +1,379 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+
+#include "Splines.hh"
+
+namespace Splines {
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  // intervals checked by each task
+  static integer const compress_chunk{ 256 };
+
+  struct SplineCompressor::Column {
+    Spline const *          ref{nullptr};  // input spline (`nullptr` for raw data)
+    SplineType1D            type{SplineType1D::CUBIC};
+    real_type const *       Y{nullptr};    // values at the nodes
+    real_type const *       Yp{nullptr};   // slopes at the nodes (`HERMITE` only)
+    vector<real_type>       Rd;            // D2..D5 of `ref` at the midpoints, 4 per interval
+    std::unique_ptr<Spline> work;          // spline on the current knots
+    vector<real_type>       xs, ys, yps;   // current knots
+  };
+
+  // empty spline of type `type` with the settings of `ref`
+  static
+  std::unique_ptr<Spline>
+  new_like( SplineType1D type, Spline const * ref, string_view name ) {
+    std::unique_ptr<Spline> S;
+    switch ( type ) {
+    case SplineType1D::CONSTANT: S = std::make_unique<ConstantSpline>( name ); break;
+    case SplineType1D::LINEAR:   S = std::make_unique<LinearSpline>( name );   break;
+    case SplineType1D::CUBIC:    S = std::make_unique<CubicSpline>( name );    break;
+    case SplineType1D::AKIMA:    S = std::make_unique<AkimaSpline>( name );    break;
+    case SplineType1D::BESSEL:   S = std::make_unique<BesselSpline>( name );   break;
+    case SplineType1D::PCHIP:    S = std::make_unique<PchipSpline>( name );    break;
+    case SplineType1D::QUINTIC:  S = std::make_unique<QuinticSpline>( name );  break;
+    case SplineType1D::HERMITE:  S = std::make_unique<HermiteSpline>( name );  break;
+    default:
+      UTILS_ERROR( "SplineCompressor: type {} not supported\n", to_string(type) );
+    }
+    if ( ref != nullptr ) {
+      if ( ref->is_closed() )            S->make_closed();
+      if ( ref->is_bounded() )           S->make_bounded();
+      if ( ref->is_extended_constant() ) S->make_extended_constant();
+      else                               S->make_extended_not_constant();
+      if ( type == SplineType1D::CUBIC ) {
+        CubicSpline const * C{ static_cast<CubicSpline const *>(ref) };
+        CubicSpline       * D{ static_cast<CubicSpline *>(S.get()) };
+        D->set_initial_BC( C->initial_BC() );
+        D->set_final_BC( C->final_BC() );
+      } else if ( type == SplineType1D::QUINTIC ) {
+        static_cast<QuinticSpline *>(S.get())->set_quintic_type(
+          static_cast<QuinticSpline const *>(ref)->quintic_type()
+        );
+      }
+    }
+    return S;
+  }
+
+  // column of the input spline `S` (nodes of `S` are the candidate knots)
+  void
+  SplineCompressor::set_column( Column & C, Spline const & S ) {
+    C.ref  = &S;
+    C.type = S.type();
+    C.Y    = S.y_nodes();
+    if ( C.type == SplineType1D::HERMITE )
+      C.Yp = static_cast<CubicSplineBase const &>(S).yp_nodes();
+    integer const n{ S.num_points() };
+    C.Rd.resize( size_t(4*(n-1)) );
+    real_type * d{ C.Rd.data() };
+    for ( integer j{0}; j < n-1; ++j, d += 4 ) {
+      real_type const xm{ (S.x_node(j)+S.x_node(j+1))/2 };
+      d[0] = S.id_DD( j, xm );
+      d[1] = S.id_DDD( j, xm );
+      d[2] = S.id_DDDD( j, xm );
+      d[3] = S.id_DDDDD( j, xm );
+    }
+    C.work = new_like( C.type, &S, "SplineCompressor" );
+  }
+
+  // Bound of |S-ref| on the input interval [X[j],X[j+1]], `S` restricted to
+  // its interval `k`, `Rd` the derivatives of `ref` stored by `set_column`.
+  // The error e is a polynomial there, so
+  //
+  //   |e| <= max(|e(X[j])|,|e(X[j+1])|) + h^2/8 max|e''|
+  //
+  // and e'' is bounded by its (exact) Taylor expansion at the midpoint.
+  static
+  real_type
+  interval_bound(
+    Spline const &  S,
+    integer         k,
+    real_type const X[],
+    real_type const Y[],
+    real_type const Rd[],
+    integer         j
+  ) {
+    real_type const   xa{ X[j] };
+    real_type const   xb{ X[j+1] };
+    real_type const   h{ xb-xa };
+    real_type const   xm{ (xa+xb)/2 };
+    real_type const * d{ Rd+4*j };
+    real_type const   ea{ std::abs( S.id_eval( k, xa ) - Y[j] ) };
+    real_type const   eb{ std::abs( S.id_eval( k, xb ) - Y[j+1] ) };
+    real_type const   d2{ std::abs( S.id_DD( k, xm )    - d[0] ) };
+    real_type const   d3{ std::abs( S.id_DDD( k, xm )   - d[1] ) };
+    real_type const   d4{ std::abs( S.id_DDDD( k, xm )  - d[2] ) };
+    real_type const   d5{ std::abs( S.id_DDDDD( k, xm ) - d[3] ) };
+    real_type const   dd{ d2 + h*(d3/2 + h*(d4/8 + h*d5/48)) };
+    return std::max( ea, eb ) + h*h*dd/8;
+  }
+
+  #endif
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  string
+  SplineCompressInfo::to_string() const {
+    return fmt::format(
+      "npts {} -> {} ({:.2f}%), passes {}, max error {:.3e}{}",
+      npts_in, npts_out, npts_in > 0 ? 100.0*npts_out/npts_in : 0.0,
+      passes, max_error, bounded ? "" : " (tolerance NOT reached)"
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  SplineCompressor::SplineCompressor( real_type tolerance, integer num_threads )
+  : m_pool( new WorkStealingPool( num_threads ) )
+  { this->set_tolerance( tolerance ); }
+
+  SplineCompressor::~SplineCompressor() {}
+
+  void
+  SplineCompressor::set_tolerance( real_type tol ) {
+    UTILS_ASSERT( tol > 0, "SplineCompressor::set_tolerance( {} ), must be > 0\n", tol );
+    m_tolerance = tol;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineCompressor::select(
+    vector<Column>  & cols,
+    real_type const   X[],
+    integer           n,
+    vector<integer> & keep
+  ) {
+    m_info          = SplineCompressInfo();
+    m_info.npts_in  = n;
+    keep.assign( { 0, n-1 } );
+
+    integer const   ncol{ integer(cols.size()) };
+    vector<integer> split;
+    vector<real_type> err;
+
+    while ( true ) {
+      ++m_info.passes;
+      integer const m{ integer(keep.size()) };
+
+      // rebuild the splines on the current knots
+      m_pool->run( ncol, [&]( integer c ) {
+        Column & C{ cols[size_t(c)] };
+        C.xs.resize( size_t(m) );
+        C.ys.resize( size_t(m) );
+        for ( integer k{0}; k < m; ++k ) {
+          C.xs[size_t(k)] = X[keep[size_t(k)]];
+          C.ys[size_t(k)] = C.Y[keep[size_t(k)]];
+        }
+        if ( C.type == SplineType1D::HERMITE ) {
+          C.yps.resize( size_t(m) );
+          for ( integer k{0}; k < m; ++k ) C.yps[size_t(k)] = C.Yp[keep[size_t(k)]];
+          static_cast<HermiteSpline *>(C.work.get())->build( C.xs.data(), C.ys.data(), C.yps.data(), m );
+        } else {
+          C.work->build( C.xs.data(), C.ys.data(), m );
+        }
+      } );
+
+      // error of each interval and where to split it (`-1` = no split)
+      split.assign( size_t(m-1), -1 );
+      err.assign( size_t(m-1), 0 );
+      integer const ntasks{ (m-1+compress_chunk-1)/compress_chunk };
+      m_pool->run( ntasks, [&]( integer t ) {
+        integer const k1{ std::min( m-1, (t+1)*compress_chunk ) };
+        for ( integer k{t*compress_chunk}; k < k1; ++k ) {
+          integer const a{ keep[size_t(k)] };
+          integer const b{ keep[size_t(k)+1] };
+          // the last interval checks also the last node
+          integer const jend{ k == m-2 ? b+1 : b };
+          real_type emax{0};
+          integer   jmax{-1};
+          for ( Column const & C : cols ) {
+            Spline const & S{ *C.work };
+            // `ConstantSpline` does not use the last value
+            integer const je{ C.type == SplineType1D::CONSTANT ? b : jend };
+            for ( integer j{a}; j < je; ++j ) {
+              real_type const e{ std::abs( S.id_eval( k, X[j] ) - C.Y[j] ) };
+              if ( e > emax ) { emax = e; jmax = j; }
+            }
+            // a piecewise constant error is fully checked on the nodes
+            if ( C.ref == nullptr || C.type == SplineType1D::CONSTANT ) continue;
+            for ( integer j{a}; j < b; ++j ) {
+              real_type const e{ interval_bound( S, k, X, C.Y, C.Rd.data(), j ) };
+              if ( e > emax ) { emax = e; jmax = j == a ? j+1 : j; }
+            }
+          }
+          err[size_t(k)] = emax;
+          if ( emax > m_tolerance && b-a > 1 ) {
+            // split at the worst node, within the central half of the interval
+            integer const q{ std::max( integer(1), (b-a)/4 ) };
+            split[size_t(k)] = std::clamp( jmax, a+q, b-q );
+          }
+        }
+      } );
+
+      m_info.max_error = *std::max_element( err.begin(), err.end() );
+
+      vector<integer> next;
+      next.reserve( keep.size() + keep.size()/2 );
+      for ( integer k{0}; k < m-1; ++k ) {
+        next.push_back( keep[size_t(k)] );
+        if ( split[size_t(k)] >= 0 ) next.push_back( split[size_t(k)] );
+      }
+      next.push_back( keep.back() );
+      if ( integer(next.size()) == m ) break;
+      keep.swap( next );
+    }
+
+    m_info.npts_out = integer(keep.size());
+    m_info.bounded  = m_info.max_error <= m_tolerance;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  std::unique_ptr<Spline>
+  SplineCompressor::compress(
+    SplineType1D    type,
+    real_type const x[],
+    real_type const y[],
+    integer         n,
+    string_view     name
+  ) {
+    UTILS_ASSERT(
+      type != SplineType1D::HERMITE,
+      "SplineCompressor::compress, HERMITE needs the slopes, compress a HermiteSpline instead\n"
+    );
+    UTILS_ASSERT( n >= 2, "SplineCompressor::compress, npts = {} must be >= 2\n", n );
+    for ( integer i{1}; i < n; ++i )
+      UTILS_ASSERT(
+        x[i-1] < x[i],
+        "SplineCompressor::compress, x must be strictly increasing, x[{}] = {} >= x[{}] = {}\n",
+        i-1, x[i-1], i, x[i]
+      );
+
+    vector<Column> cols(1);
+    cols[0].type = type;
+    cols[0].Y    = y;
+    cols[0].work = new_like( type, nullptr, name );
+
+    vector<integer> keep;
+    select( cols, x, n, keep );
+    return std::move( cols[0].work ); // built on the last knots
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  std::unique_ptr<Spline>
+  SplineCompressor::compress( Spline const & S, string_view name ) {
+    integer const n{ S.num_points() };
+    UTILS_ASSERT(
+      n >= 2, "SplineCompressor::compress( {} ), npts = {} must be >= 2\n", S.name(), n
+    );
+    vector<Column> cols(1);
+    set_column( cols[0], S );
+
+    vector<integer> keep;
+    select( cols, S.x_nodes(), n, keep );
+
+    // rebuild with the requested name
+    Column & C{ cols[0] };
+    std::unique_ptr<Spline> res{ new_like( C.type, &S, name ) };
+    integer const m{ integer(keep.size()) };
+    if ( C.type == SplineType1D::HERMITE )
+      static_cast<HermiteSpline *>(res.get())->build( C.xs.data(), C.ys.data(), C.yps.data(), m );
+    else
+      res->build( C.xs.data(), C.ys.data(), m );
+    return res;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineCompressor::compress( SplineSet const & in, SplineSet & out ) {
+    integer const nspl{ in.num_splines() };
+    integer const n{ in.num_points() };
+    UTILS_ASSERT(
+      nspl > 0 && n >= 2,
+      "SplineCompressor::compress( SplineSet {} ), nspl = {}, npts = {}\n", in.name(), nspl, n
+    );
+    vector<Column> cols( static_cast<size_t>(nspl) );
+    for ( integer i{0}; i < nspl; ++i ) set_column( cols[size_t(i)], *in.get_spline(i) );
+
+    vector<integer> keep;
+    select( cols, in.x_nodes(), n, keep );
+
+    // build `out` from the knots of the last pass
+    integer const m{ integer(keep.size()) };
+    vector<string>             headers( static_cast<size_t>(nspl) );
+    vector<char const *>       pheaders( static_cast<size_t>(nspl) );
+    vector<SplineType1D>       stype( static_cast<size_t>(nspl) );
+    vector<real_type const *>  Y( static_cast<size_t>(nspl) );
+    vector<real_type const *>  Yp( static_cast<size_t>(nspl), nullptr );
+    for ( integer i{0}; i < nspl; ++i ) {
+      Column const & C{ cols[size_t(i)] };
+      headers[size_t(i)]  = string( in.header(i) );
+      pheaders[size_t(i)] = headers[size_t(i)].c_str();
+      stype[size_t(i)]    = C.type;
+      Y[size_t(i)]        = C.ys.data();
+      if ( C.type == SplineType1D::HERMITE ) Yp[size_t(i)] = C.yps.data();
+    }
+    out.build( nspl, m, pheaders.data(), stype.data(), cols[0].xs.data(), Y.data(), Yp.data() );
+
+    // same settings of the input columns
+    for ( integer i{0}; i < nspl; ++i ) {
+      Spline const * R{ cols[size_t(i)].ref };
+      Spline       * S{ out.get_spline(i) };
+      if ( R->is_closed() )            S->make_closed();
+      if ( R->is_bounded() )           S->make_bounded();
+      if ( R->is_extended_constant() ) S->make_extended_constant();
+      else                             S->make_extended_not_constant();
+      if ( R->type() == SplineType1D::CUBIC ) {
+        CubicSpline const * RC{ static_cast<CubicSpline const *>(R) };
+        CubicSpline       * SC{ static_cast<CubicSpline *>(S) };
+        if ( RC->initial_BC() != SC->initial_BC() || RC->final_BC() != SC->final_BC() ) {
+          SC->set_initial_BC( RC->initial_BC() );
+          SC->set_final_BC( RC->final_BC() );
+          SC->build();
+        }
+      } else if ( R->type() == SplineType1D::QUINTIC ) {
+        QuinticSpline const * RQ{ static_cast<QuinticSpline const *>(R) };
+        QuinticSpline       * SQ{ static_cast<QuinticSpline *>(S) };
+        if ( RQ->quintic_type() != SQ->quintic_type() ) {
+          SQ->set_quintic_type( RQ->quintic_type() );
+          SQ->build();
+        }
+      }
+    }
+    // group the columns with their final flags and slopes now, not at the first evaluation
+    out.build_groups();
+  }
+
+}
+
+// EOF: SplineCompress.cc
@@ -44,7 +44,7 @@ namespace Splines {
 
   ConstantSpline::ConstantSpline( string_view name )
   : Spline(name)
-  , m_mem_constant( fmt::format("ConstantSpline[{}]",name) )
+  , m_mem_constant( malloc_name( "ConstantSpline", "m_mem_constant", name ) )
   {}
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -99,6 +99,33 @@ namespace Splines {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  real_type
+  ConstantSpline::id_integral(
+    integer   const ni,
+    real_type const a,
+    real_type const b
+  ) const {
+    return (b-a)*m_Y[ni];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  ConstantSpline::id_y_min_max(
+    integer   const ni,
+    real_type const a,
+    real_type const,
+    real_type     & x_min_pos,
+    real_type     & y_min,
+    real_type     & x_max_pos,
+    real_type     & y_max
+  ) const {
+    x_min_pos = x_max_pos = a;
+    y_min     = y_max     = m_Y[ni];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   ConstantSpline::D( real_type const x, real_type dd[2] ) const {
     dd[0] = eval(x);
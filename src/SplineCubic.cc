@@ -443,6 +443,13 @@ namespace Splines {
     CubicSpline_BC  const bc0,
     CubicSpline_BC  const bcn
   ) {
+    // small splines (e.g. the ones of a `SplineArena`) work on the stack
+    constexpr integer stack_npts{ 128 };
+    if ( npts <= stack_npts ) {
+      real_type work[4*stack_npts];
+      CubicSpline_build( X, Y, Yp, work+3*npts, work, work+npts, work+2*npts, npts, bc0, bcn );
+      return;
+    }
     Malloc_real mem("CubicSpline_build");
     mem.allocate( 4 * npts );
     real_type * L { mem( npts ) };
@@ -458,10 +465,9 @@ namespace Splines {
 
   void
   CubicSpline::build() {
-    string msg{ fmt::format("CubicSpline[{}]::build():", m_name ) };
-    UTILS_ASSERT( m_npts > 1, "{} npts={} not enought points\n", msg, m_npts );
-    Utils::check_NaN( m_X, msg+" X", m_npts, __LINE__, __FILE__ );
-    Utils::check_NaN( m_Y, msg+" Y", m_npts, __LINE__, __FILE__ );
+    UTILS_ASSERT( m_npts > 1, "CubicSpline[{}]::build(): npts = {} not enought points\n", m_name, m_npts );
+    check_NaN( m_X, m_npts, "CubicSpline", "X", __LINE__, __FILE__ );
+    check_NaN( m_Y, m_npts, "CubicSpline", "Y", __LINE__, __FILE__ );
     integer ibegin{0};
     integer iend{0};
     do {
@@ -475,7 +481,7 @@ namespace Splines {
       ibegin = iend;
     } while ( iend < m_npts );
 
-    Utils::check_NaN( m_Yp, msg+" Yp", m_npts, __LINE__, __FILE__ );
+    check_NaN( m_Yp, m_npts, "CubicSpline", "Yp", __LINE__, __FILE__ );
     m_search.must_reset();
   }
 
@@ -43,7 +43,7 @@ namespace Splines {
 
   CubicSplineBase::CubicSplineBase( string_view name )
   : Spline(name)
-  , m_mem_cubic( fmt::format("CubicSplineBase[{}]::m_mem_cubic", name ) )
+  , m_mem_cubic( malloc_name( "CubicSplineBase", "m_mem_cubic", name ) )
   {}
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -254,6 +254,58 @@ namespace Splines {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  real_type
+  CubicSplineBase::id_integral(
+    integer   const ni,
+    real_type const a,
+    real_type const b
+  ) const {
+    real_type A, B, C, D;
+    Hermite3_to_poly(
+      m_X[ni+1]-m_X[ni], m_Y[ni], m_Y[ni+1], m_Yp[ni], m_Yp[ni+1], A, B, C, D
+    );
+    // primitive of A t^3 + B t^2 + C t + D
+    auto P = [A,B,C,D]( real_type const t ) -> real_type {
+      return t*(D+t*(C/2+t*(B/3+t*(A/4))));
+    };
+    return P(b-m_X[ni]) - P(a-m_X[ni]);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  CubicSplineBase::id_y_min_max(
+    integer   const ni,
+    real_type const a,
+    real_type const b,
+    real_type     & x_min_pos,
+    real_type     & y_min,
+    real_type     & x_max_pos,
+    real_type     & y_max
+  ) const {
+    real_type const X0{ m_X[ni] };
+    real_type A, B, C, D;
+    Hermite3_to_poly( m_X[ni+1]-X0, m_Y[ni], m_Y[ni+1], m_Yp[ni], m_Yp[ni+1], A, B, C, D );
+    auto P = [A,B,C,D]( real_type const t ) -> real_type { return ((A*t+B)*t+C)*t+D; };
+    real_type const ta{ a-X0 };
+    real_type const tb{ b-X0 };
+    real_type const ya{ P(ta) };
+    real_type const yb{ P(tb) };
+    if ( ya <= yb ) { x_min_pos = a; y_min = ya; x_max_pos = b; y_max = yb; }
+    else            { x_min_pos = b; y_min = yb; x_max_pos = a; y_max = ya; }
+    PolynomialRoots::Quadratic q;
+    q.setup( 3*A, 2*B, C );
+    real_type r[2];
+    integer const nr{ q.getRootsInOpenRange( ta, tb, r ) };
+    for ( integer j{0}; j < nr; ++j ) {
+      real_type const yy{ P(r[j]) };
+      if ( yy < y_min ) { y_min = yy; x_min_pos = X0+r[j]; }
+      if ( yy > y_max ) { y_max = yy; x_max_pos = X0+r[j]; }
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   real_type
   CubicSplineBase::DDD( real_type const x ) const {
     std::pair<integer,real_type> res(0,x);
@@ -340,6 +392,7 @@ namespace Splines {
     copy_n( S.m_Y,  m_npts, m_Y  );
     copy_n( S.m_Yp, m_npts, m_Yp );
     copy_flags( S );
+    m_search.must_reset();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -0,0 +1,512 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+
+#include "Splines.hh"
+
+namespace Splines {
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  // nodes (rows for surfaces) and cells handled by each task
+  static integer const lut_chunk{ 1024 };
+
+  // polynomial in s of the cubic Hermite cell with values `f0,f1`
+  // and scaled slopes `g0,g1` (slope times cell width)
+  static
+  inline
+  void
+  hermite_coeffs( real_type f0, real_type f1, real_type g0, real_type g1, real_type c[4] ) {
+    c[0] = f0;
+    c[1] = g0;
+    c[2] = 3*(f1-f0) - 2*g0 - g1;
+    c[3] = 2*(f0-f1) + g0 + g1;
+  }
+
+  // bound of |S-p| on [xa,xb] inside segment `j` of `S`, with `p` the
+  // polynomial of the cell of origin `x0` and width `1/ih`: the error is
+  // a polynomial of degree <= 5, bounded by the larger end value plus the
+  // interpolation remainder h^2/8 max|e''|, e'' by its Taylor expansion at
+  // the middle (as in `SplineCompressor`)
+  static
+  real_type
+  cell_bound(
+    Spline const &  S,
+    integer         j,
+    real_type const c[],
+    bool            hermite,
+    real_type       x0,
+    real_type       ih,
+    real_type       xa,
+    real_type       xb
+  ) {
+    auto p = [c,hermite,x0,ih]( real_type x ) {
+      real_type const s{ (x-x0)*ih };
+      return hermite ? c[0] + s*(c[1] + s*(c[2] + s*c[3])) : c[0] + s*c[1];
+    };
+    real_type const h  { xb - xa };
+    real_type const xm { (xa+xb)/2 };
+    real_type const s  { (xm-x0)*ih };
+    real_type const p2 { hermite ? (2*c[2] + 6*c[3]*s)*ih*ih : 0 };
+    real_type const p3 { hermite ? 6*c[3]*ih*ih*ih : 0 };
+    real_type const ea { std::abs( S.id_eval( j, xa ) - p(xa) ) };
+    real_type const eb { std::abs( S.id_eval( j, xb ) - p(xb) ) };
+    real_type const d2 { std::abs( S.id_DD( j, xm ) - p2 ) };
+    real_type const d3 { std::abs( S.id_DDD( j, xm ) - p3 ) };
+    real_type const d4 { std::abs( S.id_DDDD( j, xm ) ) };
+    real_type const d5 { std::abs( S.id_DDDDD( j, xm ) ) };
+    return std::max( ea, eb ) + h*h/8*( d2 + h*( d3/2 + h*( d4/8 + h*d5/48 ) ) );
+  }
+
+  // degree in x and in y of the patches of a surface
+  static
+  integer
+  surf_degree( SplineSurf const & S ) {
+    if ( dynamic_cast<BilinearSpline const *>( &S ) != nullptr ) return 1;
+    if ( dynamic_cast<BiCubicSplineBase const *>( &S ) != nullptr ||
+         dynamic_cast<TiledBiCubicSpline const *>( &S ) != nullptr ) return 3;
+    return 5; // biquintic, and a safe guess for the others
+  }
+
+  // inverse of the collocation matrix of the Bernstein basis of degree `d`
+  // at t_k = (k+1/2)/(d+1): the coefficients of the polynomial sampled there
+  static
+  void
+  bernstein_inverse( integer d, real_type Ai[6][6] ) {
+    integer const n{ d+1 };
+    real_type A[6][12];
+    for ( integer k{0}; k < n; ++k ) {
+      real_type const t{ (k+0.5)/n };
+      real_type binom{1};
+      for ( integer l{0}; l < n; ++l ) {
+        A[k][l]   = binom * std::pow( t, l ) * std::pow( 1-t, d-l );
+        A[k][n+l] = k == l ? 1 : 0;
+        binom     = binom*(d-l)/(l+1);
+      }
+    }
+    // Gauss-Jordan with partial pivoting
+    for ( integer q{0}; q < n; ++q ) {
+      integer piv{q};
+      for ( integer r{q+1}; r < n; ++r ) if ( std::abs(A[r][q]) > std::abs(A[piv][q]) ) piv = r;
+      if ( piv != q ) for ( integer l{0}; l < 2*n; ++l ) std::swap( A[q][l], A[piv][l] );
+      real_type const inv{ 1/A[q][q] };
+      for ( integer l{0}; l < 2*n; ++l ) A[q][l] *= inv;
+      for ( integer r{0}; r < n; ++r ) {
+        if ( r == q ) continue;
+        real_type const f{ A[r][q] };
+        for ( integer l{0}; l < 2*n; ++l ) A[r][l] -= f*A[q][l];
+      }
+    }
+    for ( integer k{0}; k < n; ++k )
+      for ( integer l{0}; l < n; ++l )
+        Ai[k][l] = A[k][n+l];
+  }
+
+  // break points of the cell [c0,c1]: its ends and the knots inside it
+  static
+  void
+  cell_breaks( real_type const X[], integer n, real_type c0, real_type c1, vector<real_type> & brk ) {
+    brk.clear();
+    brk.emplace_back( c0 );
+    for ( real_type const * p{ std::upper_bound( X, X+n, c0 ) }; p != X+n && *p < c1; ++p )
+      brk.emplace_back( *p );
+    brk.emplace_back( c1 );
+  }
+
+  #endif
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  char const *
+  to_string( SplineLUTType t ) {
+    switch ( t ) {
+    case SplineLUTType::LINEAR:  return "LINEAR";
+    case SplineLUTType::HERMITE: return "HERMITE";
+    }
+    return "UNKNOWN";
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  string
+  SplineLUT1D::info() const {
+    return fmt::format(
+      "SplineLUT1D {} on [{},{}], cells {}, passes {}, max error {:.3e}{}, bytes {}",
+      to_string(m_type), m_x_min, m_x_max, m_ncells, m_passes, m_max_error,
+      this->tolerance_met() ? "" : " (tolerance NOT reached)", this->memory_bytes()
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  string
+  SplineLUT2D::info() const {
+    return fmt::format(
+      "SplineLUT2D {} on [{},{}]x[{},{}], cells {}x{}, passes {}, max error {:.3e}{}, bytes {}",
+      to_string(m_type), m_x_min, m_x_max, m_y_min, m_y_max, m_nx, m_ny, m_passes,
+      m_max_error, this->tolerance_met() ? "" : " (tolerance NOT reached)", this->memory_bytes()
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  SplineLUTCompiler::SplineLUTCompiler(
+    real_type     tolerance,
+    SplineLUTType type,
+    integer       num_threads
+  )
+  : m_type( type )
+  , m_pool( new WorkStealingPool( num_threads ) )
+  { this->set_tolerance( tolerance ); }
+
+  SplineLUTCompiler::~SplineLUTCompiler() {}
+
+  void
+  SplineLUTCompiler::set_tolerance( real_type tol ) {
+    UTILS_ASSERT( tol > 0, "SplineLUTCompiler::set_tolerance( {} ), must be > 0\n", tol );
+    m_tolerance = tol;
+  }
+
+  void
+  SplineLUTCompiler::set_max_bytes( size_t bytes ) {
+    UTILS_ASSERT(
+      bytes >= 16*sizeof(real_type),
+      "SplineLUTCompiler::set_max_bytes( {} ), too small\n", bytes
+    );
+    m_max_bytes = bytes;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineLUTCompiler::fill( Spline const & S, SplineLUT1D & T, integer ncells ) {
+    bool      const hermite { m_type == SplineLUTType::HERMITE };
+    real_type const a       { S.x_min() };
+    real_type const b       { S.x_max() };
+    real_type const h       { (b-a)/ncells };
+
+    T.m_type   = m_type;
+    T.m_stride = hermite ? 4 : 2;
+    T.m_ncells = ncells;
+    T.m_x_min  = a;
+    T.m_x_max  = b;
+    T.m_inv_dx = ncells/(b-a);
+
+    // values and scaled slopes at the nodes
+    integer const nn{ ncells+1 };
+    vector<real_type> Y( static_cast<size_t>(nn) ), G;
+    if ( hermite ) G.resize( static_cast<size_t>(nn) );
+    m_pool->run( (nn+lut_chunk-1)/lut_chunk, [&]( integer tsk ) {
+      integer const i1{ std::min( nn, (tsk+1)*lut_chunk ) };
+      for ( integer i{tsk*lut_chunk}; i < i1; ++i ) {
+        real_type const x{ i == ncells ? b : a + i*h };
+        Y[size_t(i)] = S.eval( x );
+        if ( hermite ) G[size_t(i)] = S.D( x ) * h;
+      }
+    } );
+
+    // cells, then a bound of the error
+    T.m_coeffs.resize( size_t(ncells)*size_t(T.m_stride) );
+    T.m_coeffs.shrink_to_fit();
+    integer const ntasks{ (ncells+lut_chunk-1)/lut_chunk };
+    vector<real_type> err( static_cast<size_t>(ntasks), 0 );
+    m_pool->run( ntasks, [&]( integer tsk ) {
+      integer const i0{ tsk*lut_chunk };
+      integer const i1{ std::min( ncells, i0+lut_chunk ) };
+      for ( integer i{i0}; i < i1; ++i ) {
+        real_type * c{ T.m_coeffs.data() + i*T.m_stride };
+        if ( hermite ) {
+          hermite_coeffs( Y[size_t(i)], Y[size_t(i)+1], G[size_t(i)], G[size_t(i)+1], c );
+        } else {
+          c[0] = Y[size_t(i)];
+          c[1] = Y[size_t(i)+1] - Y[size_t(i)];
+        }
+      }
+      // bound on each input segment overlapping the cell
+      real_type const * X{ S.x_nodes() };
+      integer   const   n{ S.num_points() };
+      integer seg{ static_cast<integer>( std::upper_bound( X, X+n, a + i0*h ) - X ) - 1 };
+      seg = std::clamp( seg, integer(0), n-2 );
+      real_type emax{0};
+      for ( integer i{i0}; i < i1; ++i ) {
+        real_type const   xc0{ a + i*h };
+        real_type const   xc1{ i+1 == ncells ? b : a + (i+1)*h };
+        real_type const * c  { T.m_coeffs.data() + i*T.m_stride };
+        while ( seg < n-2 && X[seg+1] <= xc0 ) ++seg;
+        for ( integer j{seg}; j < n-1 && X[j] < xc1; ++j ) {
+          real_type const xa{ std::max( xc0, X[j] ) };
+          real_type const xb{ std::min( xc1, X[j+1] ) };
+          if ( xb > xa ) emax = std::max( emax, cell_bound( S, j, c, hermite, xc0, T.m_inv_dx, xa, xb ) );
+        }
+      }
+      err[size_t(tsk)] = emax;
+    } );
+    T.m_max_error = *std::max_element( err.begin(), err.end() );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineLUTCompiler::compile( Spline const & S, SplineLUT1D & T ) {
+    UTILS_ASSERT(
+      S.num_points() >= 2 && S.x_min() < S.x_max(),
+      "SplineLUTCompiler::compile( {} ), spline not built or empty range\n", S.name()
+    );
+    real_type const order { m_type == SplineLUTType::HERMITE ? 4.0 : 2.0 };
+    size_t    const cbytes{ sizeof(real_type) * (m_type == SplineLUTType::HERMITE ? 4 : 2) };
+    integer   const nmax  {
+      static_cast<integer>( std::min( m_max_bytes/cbytes, size_t(std::numeric_limits<integer>::max()/4) ) )
+    };
+
+    integer n{ std::min( std::max( S.num_points()-1, integer(16) ), nmax ) };
+    T.m_tolerance = m_tolerance;
+    T.m_passes    = 0;
+    while ( true ) {
+      ++T.m_passes;
+      this->fill( S, T, n );
+      if ( T.m_max_error <= m_tolerance || n >= nmax ) break;
+      real_type const f{ std::clamp( 1.1*std::pow( T.m_max_error/m_tolerance, 1/order ), 2.0, 64.0 ) };
+      n = static_cast<integer>( std::min( real_type(nmax), std::ceil( n*f ) ) );
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineLUTCompiler::compile( SplineSet const & S, integer spl, SplineLUT1D & T ) {
+    UTILS_ASSERT(
+      spl >= 0 && spl < S.num_splines(),
+      "SplineLUTCompiler::compile( SplineSet {} ), spline {} out of [0,{})\n",
+      S.name(), spl, S.num_splines()
+    );
+    this->compile( *S.get_spline( spl ), T );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineLUTCompiler::fill( SplineSurf const & S, SplineLUT2D & T, integer nx, integer ny ) {
+    bool      const hermite { m_type == SplineLUTType::HERMITE };
+    real_type const ax      { S.x_min() };
+    real_type const bx      { S.x_max() };
+    real_type const ay      { S.y_min() };
+    real_type const by      { S.y_max() };
+    real_type const hx      { (bx-ax)/nx };
+    real_type const hy      { (by-ay)/ny };
+
+    T.m_type   = m_type;
+    T.m_stride = hermite ? 16 : 4;
+    T.m_nx     = nx;
+    T.m_ny     = ny;
+    T.m_x_min  = ax;
+    T.m_x_max  = bx;
+    T.m_y_min  = ay;
+    T.m_y_max  = by;
+    T.m_inv_dx = nx/(bx-ax);
+    T.m_inv_dy = ny/(by-ay);
+
+    // values and scaled derivatives at the nodes, node (i,j) at i*(ny+1)+j
+    integer const mx{ nx+1 };
+    integer const my{ ny+1 };
+    size_t  const nn{ size_t(mx)*size_t(my) };
+    vector<real_type> Z( nn ), Gx, Gy, Gxy;
+    if ( hermite ) { Gx.resize( nn ); Gy.resize( nn ); Gxy.resize( nn ); }
+    m_pool->run( mx, [&]( integer i ) {
+      real_type const x{ i == nx ? bx : ax + i*hx };
+      for ( integer j{0}; j < my; ++j ) {
+        real_type const y{ j == ny ? by : ay + j*hy };
+        size_t const k{ size_t(i)*size_t(my) + size_t(j) };
+        if ( hermite ) {
+          real_type d[3];
+          S.D( x, y, d );
+          Z[k]   = d[0];
+          Gx[k]  = d[1]*hx;
+          Gy[k]  = d[2]*hy;
+          Gxy[k] = S.Dxy( x, y )*hx*hy;
+        } else {
+          Z[k] = S.eval( x, y );
+        }
+      }
+    } );
+
+    // cells (C = M F M^T with M the Hermite to power basis matrix),
+    // then a bound of the error on each rectangle of a cell inside one
+    // patch of the input: the error there is a polynomial of degree `d`
+    // in x and in y, bounded by its Bernstein coefficients
+    integer const d{ std::max( surf_degree( S ), integer( hermite ? 3 : 1 ) ) };
+    real_type Ai[6][6];
+    bernstein_inverse( d, Ai );
+
+    // knots of the input and break points of the cell rows,
+    // row j at ybrk[yoff[j]..yoff[j+1])
+    vector<real_type> xk( size_t(S.num_point_x()) ), yk( size_t(S.num_point_y()) );
+    for ( integer k{0}; k < S.num_point_x(); ++k ) xk[size_t(k)] = S.x_node(k);
+    for ( integer k{0}; k < S.num_point_y(); ++k ) yk[size_t(k)] = S.y_node(k);
+    vector<real_type> ybrk, brk;
+    vector<integer>   yoff( size_t(ny)+1 );
+    for ( integer j{0}; j < ny; ++j ) {
+      yoff[size_t(j)] = integer( ybrk.size() );
+      cell_breaks( yk.data(), integer( yk.size() ), ay + j*hy, j+1 == ny ? by : ay + (j+1)*hy, brk );
+      ybrk.insert( ybrk.end(), brk.begin(), brk.end() );
+    }
+    yoff[size_t(ny)] = integer( ybrk.size() );
+
+    T.m_coeffs.resize( size_t(nx)*size_t(ny)*size_t(T.m_stride) );
+    T.m_coeffs.shrink_to_fit();
+    vector<real_type> err( size_t(nx), 0 );
+    m_pool->run( nx, [&]( integer i ) {
+      static real_type const M[4][4]{
+        {  1,  0,  0,  0 },
+        {  0,  0,  1,  0 },
+        { -3,  3, -2, -1 },
+        {  2, -2,  1,  1 }
+      };
+      real_type emax{0};
+      for ( integer j{0}; j < ny; ++j ) {
+        size_t const k00{ size_t(i)*size_t(my) + size_t(j) };
+        size_t const k01{ k00+1 };
+        size_t const k10{ k00+size_t(my) };
+        size_t const k11{ k10+1 };
+        real_type * c{ T.m_coeffs.data() + (i*ny+j)*T.m_stride };
+        if ( hermite ) {
+          real_type const F[4][4]{
+            { Z[k00],  Z[k01],  Gy[k00],  Gy[k01]  },
+            { Z[k10],  Z[k11],  Gy[k10],  Gy[k11]  },
+            { Gx[k00], Gx[k01], Gxy[k00], Gxy[k01] },
+            { Gx[k10], Gx[k11], Gxy[k10], Gxy[k11] }
+          };
+          real_type MF[4][4];
+          for ( integer r{0}; r < 4; ++r )
+            for ( integer q{0}; q < 4; ++q )
+              MF[r][q] = M[r][0]*F[0][q] + M[r][1]*F[1][q] + M[r][2]*F[2][q] + M[r][3]*F[3][q];
+          for ( integer r{0}; r < 4; ++r )
+            for ( integer q{0}; q < 4; ++q )
+              c[4*r+q] = MF[r][0]*M[q][0] + MF[r][1]*M[q][1] + MF[r][2]*M[q][2] + MF[r][3]*M[q][3];
+        } else {
+          c[0] = Z[k00];
+          c[1] = Z[k10] - Z[k00];
+          c[2] = Z[k01] - Z[k00];
+          c[3] = Z[k11] - Z[k10] - Z[k01] + Z[k00];
+        }
+      }
+      integer const n{ d+1 };
+      real_type const x0{ ax + i*hx };
+      vector<real_type> xbrk;
+      cell_breaks( xk.data(), integer( xk.size() ), x0, i+1 == nx ? bx : ax + (i+1)*hx, xbrk );
+      for ( integer j{0}; j < ny; ++j ) {
+        real_type const   y0{ ay + j*hy };
+        real_type const * c { T.m_coeffs.data() + (i*ny+j)*T.m_stride };
+        auto P = [c,hermite,x0,y0,&T]( real_type x, real_type y ) {
+          real_type const s{ (x-x0)*T.m_inv_dx };
+          real_type const t{ (y-y0)*T.m_inv_dy };
+          if ( !hermite ) return c[0] + s*c[1] + t*(c[2] + s*c[3]);
+          real_type r[4];
+          for ( integer k{0}; k < 4; ++k ) r[k] = c[4*k] + t*(c[4*k+1] + t*(c[4*k+2] + t*c[4*k+3]));
+          return r[0] + s*(r[1] + s*(r[2] + s*r[3]));
+        };
+        for ( size_t px{1}; px < xbrk.size(); ++px ) {
+          real_type const xa{ xbrk[px-1] }, xb{ xbrk[px] };
+          if ( xb <= xa ) continue;
+          for ( integer py{yoff[size_t(j)]+1}; py < yoff[size_t(j)+1]; ++py ) {
+            real_type const ya{ ybrk[size_t(py)-1] }, yb{ ybrk[size_t(py)] };
+            if ( yb <= ya ) continue;
+            // E = samples of the error, B = Ai E Ai^T
+            real_type E[6][6], AE[6][6];
+            for ( integer p{0}; p < n; ++p ) {
+              real_type const x{ xa + (xb-xa)*(p+0.5)/n };
+              for ( integer q{0}; q < n; ++q ) {
+                real_type const y{ ya + (yb-ya)*(q+0.5)/n };
+                E[p][q] = S.eval( x, y ) - P( x, y );
+              }
+            }
+            for ( integer r{0}; r < n; ++r )
+              for ( integer q{0}; q < n; ++q ) {
+                real_type v{0};
+                for ( integer p{0}; p < n; ++p ) v += Ai[r][p]*E[p][q];
+                AE[r][q] = v;
+              }
+            for ( integer r{0}; r < n; ++r )
+              for ( integer l{0}; l < n; ++l ) {
+                real_type v{0};
+                for ( integer q{0}; q < n; ++q ) v += AE[r][q]*Ai[l][q];
+                emax = std::max( emax, std::abs( v ) );
+              }
+          }
+        }
+      }
+      err[size_t(i)] = emax;
+    } );
+    T.m_max_error = *std::max_element( err.begin(), err.end() );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineLUTCompiler::compile( SplineSurf const & S, SplineLUT2D & T ) {
+    UTILS_ASSERT(
+      S.num_point_x() >= 2 && S.num_point_y() >= 2 &&
+      S.x_min() < S.x_max() && S.y_min() < S.y_max(),
+      "SplineLUTCompiler::compile( {} ), surface not built or empty range\n", S.name()
+    );
+    real_type const order { m_type == SplineLUTType::HERMITE ? 4.0 : 2.0 };
+    size_t    const cbytes{ sizeof(real_type) * (m_type == SplineLUTType::HERMITE ? 16 : 4) };
+    real_type const nmax  { real_type( m_max_bytes/cbytes ) };
+
+    integer nx{ std::max( S.num_point_x()-1, integer(8) ) };
+    integer ny{ std::max( S.num_point_y()-1, integer(8) ) };
+    if ( real_type(nx)*ny > nmax ) {
+      real_type const r{ std::sqrt( nmax/(real_type(nx)*ny) ) };
+      nx = std::max( integer(1), static_cast<integer>( nx*r ) );
+      ny = std::max( integer(1), static_cast<integer>( ny*r ) );
+    }
+    T.m_tolerance = m_tolerance;
+    T.m_passes    = 0;
+    while ( true ) {
+      ++T.m_passes;
+      this->fill( S, T, nx, ny );
+      if ( T.m_max_error <= m_tolerance ) break;
+      // refine both directions (the error of a cell is a sum of the
+      // x and y contributions), then shrink to the memory limit
+      real_type const f{ std::clamp( 1.1*std::pow( T.m_max_error/m_tolerance, 1/order ), 2.0, 64.0 ) };
+      real_type fx{ f }, fy{ f };
+      if ( real_type(nx)*ny*fx*fy > nmax ) {
+        real_type const r{ std::sqrt( nmax/(real_type(nx)*ny*fx*fy) ) };
+        fx *= r;
+        fy *= r;
+      }
+      integer const nx1{ std::max( nx, static_cast<integer>( nx*fx ) ) };
+      integer const ny1{ std::max( ny, static_cast<integer>( ny*fy ) ) };
+      if ( nx1 == nx && ny1 == ny ) break;
+      nx = nx1;
+      ny = ny1;
+    }
+  }
+
+}
+
+// EOF: SplineLUT.cc
@@ -43,7 +43,7 @@ namespace Splines {
 
   LinearSpline::LinearSpline( string_view name )
   : Spline(name)
-  , m_mem_linear( fmt::format( "LinearSpline[{}]", name ) )
+  , m_mem_linear( malloc_name( "LinearSpline", "m_mem_linear", name ) )
   {
     m_curve_extended_constant = true; // by default linear spline extend constant
   }
@@ -62,6 +62,21 @@ namespace Splines {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  real_type
+  LinearSpline::id_integral(
+    integer   const ni,
+    real_type const a,
+    real_type const b
+  ) const {
+    real_type const H{ m_X[ni+1] - m_X[ni] };
+    real_type const sa{ (a-m_X[ni])/H };
+    real_type const sb{ (b-m_X[ni])/H };
+    // trapezoidal rule is exact on the segment
+    return (b-a)*( (1-(sa+sb)/2)*m_Y[ni] + ((sa+sb)/2)*m_Y[ni+1] );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   real_type
   LinearSpline::eval( real_type const x ) const {
     std::pair<integer,real_type> res(0,x);
@@ -203,11 +203,10 @@ namespace Splines {
 
   void
   PchipSpline::build() {
-    string msg{ fmt::format("PchipSpline[{}]::build():", m_name ) };
-    UTILS_ASSERT( m_npts > 1, "{} npts = {} not enought points\n", msg, m_npts );
+    UTILS_ASSERT( m_npts > 1, "PchipSpline[{}]::build(): npts = {} not enought points\n", m_name, m_npts );
 
-    Utils::check_NaN( m_X, msg+" X", m_npts, __LINE__, __FILE__ );
-    Utils::check_NaN( m_Y, msg+" Y", m_npts, __LINE__, __FILE__ );
+    check_NaN( m_X, m_npts, "PchipSpline", "X", __LINE__, __FILE__ );
+    check_NaN( m_Y, m_npts, "PchipSpline", "Y", __LINE__, __FILE__ );
 
     integer ibegin { 0 };
     integer iend   { 0 };
@@ -219,7 +218,7 @@ namespace Splines {
       ibegin = iend;
     } while ( iend < m_npts );
 
-    Utils::check_NaN( m_Yp, msg+" Yp", m_npts, __LINE__, __FILE__ );
+    check_NaN( m_Yp, m_npts, "PchipSpline", "Yp", __LINE__, __FILE__ );
     m_search.must_reset();
   }
 
@@ -44,7 +44,7 @@ namespace Splines {
 
   QuinticSplineBase::QuinticSplineBase( string_view name )
   : Spline(name)
-  , m_base_quintic( fmt::format( "QuinticSplineBase[{}]", name ) )
+  , m_base_quintic( malloc_name( "QuinticSpline", "m_base_quintic", name ) )
   {}
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -271,10 +271,9 @@ namespace Splines {
 
   void
   QuinticSpline::build() {
-    string msg{ fmt::format("QuinticSpline[{}]::build():", m_name ) };
-    UTILS_ASSERT( m_npts > 1, "{} npts = {} not enought points\n", msg, m_npts );
-    Utils::check_NaN( m_X, msg+" X", m_npts, __LINE__, __FILE__ );
-    Utils::check_NaN( m_Y, msg+" Y", m_npts, __LINE__, __FILE__ );
+    UTILS_ASSERT( m_npts > 1, "QuinticSpline[{}]::build(): npts = {} not enought points\n", m_name, m_npts );
+    check_NaN( m_X, m_npts, "QuinticSpline", "X", __LINE__, __FILE__ );
+    check_NaN( m_Y, m_npts, "QuinticSpline", "Y", __LINE__, __FILE__ );
     integer ibegin{0};
     integer iend{0};
     do {
@@ -284,8 +283,8 @@ namespace Splines {
       ibegin = iend;
     } while ( iend < m_npts );
 
-    Utils::check_NaN( m_Yp,  msg+" Yp",  m_npts, __LINE__, __FILE__ );
-    Utils::check_NaN( m_Ypp, msg+" Ypp", m_npts, __LINE__, __FILE__ );
+    check_NaN( m_Yp, m_npts, "QuinticSpline", "Yp", __LINE__, __FILE__ );
+    check_NaN( m_Ypp, m_npts, "QuinticSpline", "Ypp", __LINE__, __FILE__ );
     m_search.must_reset();
   }
 
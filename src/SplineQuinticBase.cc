@@ -231,6 +231,70 @@ namespace Splines {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  real_type
+  QuinticSplineBase::id_integral(
+    integer   const ni,
+    real_type const a,
+    real_type const b
+  ) const {
+    real_type A, B, C, D, E, F;
+    Hermite5_to_poly(
+      m_X[ni+1]-m_X[ni],
+      m_Y[ni],   m_Y[ni+1],
+      m_Yp[ni],  m_Yp[ni+1],
+      m_Ypp[ni], m_Ypp[ni+1],
+      A, B, C, D, E, F
+    );
+    // primitive of A t^5 + B t^4 + C t^3 + D t^2 + E t + F
+    auto P = [A,B,C,D,E,F]( real_type const t ) -> real_type {
+      return t*(F+t*(E/2+t*(D/3+t*(C/4+t*(B/5+t*(A/6))))));
+    };
+    return P(b-m_X[ni]) - P(a-m_X[ni]);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  QuinticSplineBase::id_y_min_max(
+    integer   const ni,
+    real_type const a,
+    real_type const b,
+    real_type     & x_min_pos,
+    real_type     & y_min,
+    real_type     & x_max_pos,
+    real_type     & y_max
+  ) const {
+    real_type const X0{ m_X[ni] };
+    real_type A, B, C, D, E, F;
+    Hermite5_to_poly(
+      m_X[ni+1]-X0,
+      m_Y[ni],   m_Y[ni+1],
+      m_Yp[ni],  m_Yp[ni+1],
+      m_Ypp[ni], m_Ypp[ni+1],
+      A, B, C, D, E, F
+    );
+    auto P = [A,B,C,D,E,F]( real_type const t ) -> real_type {
+      return ((((A*t+B)*t+C)*t+D)*t+E)*t+F;
+    };
+    real_type const ta{ a-X0 };
+    real_type const tb{ b-X0 };
+    real_type const ya{ P(ta) };
+    real_type const yb{ P(tb) };
+    if ( ya <= yb ) { x_min_pos = a; y_min = ya; x_max_pos = b; y_max = yb; }
+    else            { x_min_pos = b; y_min = yb; x_max_pos = a; y_max = ya; }
+    PolynomialRoots::Quartic q;
+    q.setup( 5*A, 4*B, 3*C, 2*D, E );
+    real_type r[4];
+    integer const nr{ q.getRootsInOpenRange( ta, tb, r ) };
+    for ( integer j{0}; j < nr; ++j ) {
+      real_type const yy{ P(r[j]) };
+      if ( yy < y_min ) { y_min = yy; x_min_pos = X0+r[j]; }
+      if ( yy > y_max ) { y_max = yy; x_max_pos = X0+r[j]; }
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   real_type
   QuinticSplineBase::DDDDD( real_type const x ) const {
     std::pair<integer,real_type> res(0,x);
@@ -369,6 +433,25 @@ namespace Splines {
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   // Implementation
+  void
+  QuinticSplineBase::build(
+    real_type const x[],
+    real_type const y[],
+    real_type const yp[],
+    real_type const ypp[],
+    integer   const n
+  ) {
+    QuinticSplineBase::reserve( n );
+    copy_n( x,   n, m_X   );
+    copy_n( y,   n, m_Y   );
+    copy_n( yp,  n, m_Yp  );
+    copy_n( ypp, n, m_Ypp );
+    m_npts = n;
+    m_search.must_reset();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   QuinticSplineBase::copy_spline( QuinticSplineBase const & S ) {
     QuinticSplineBase::reserve(S.m_npts);
@@ -378,6 +461,7 @@ namespace Splines {
     copy_n( S.m_Yp,  m_npts, m_Yp  );
     copy_n( S.m_Ypp, m_npts, m_Ypp );
     copy_flags( S );
+    m_search.must_reset();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
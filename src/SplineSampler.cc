@@ -0,0 +1,333 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+
+#include "Splines.hh"
+
+namespace Splines {
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  // intervals sampled by each task, tasks written at each round
+  static integer const sampler_chunk{ 64 };
+  static integer const sampler_window{ 64 };
+
+  using sample_buffer = fmt::memory_buffer;
+
+  // samples in (a,b] of the interval `k`, bisecting while the bound exceeds `tol`
+  template <typename SRC>
+  static
+  void
+  bisect(
+    SRC const         & src,
+    integer             k,
+    real_type           a,
+    real_type           b,
+    real_type           tol,
+    integer             depth,
+    vector<real_type> & xs
+  ) {
+    if ( depth > 0 && src.dev( k, a, b ) > tol ) {
+      real_type const m{ (a+b)/2 };
+      bisect( src, k, a, m, tol, depth-1, xs );
+      bisect( src, k, m, b, tol, depth-1, xs );
+    } else {
+      xs.push_back( b );
+    }
+  }
+
+  // distance bound of the segment [a,b] of a piece with values `ya`, `yb`
+  // and max |y''| = `dd`
+  static
+  inline
+  real_type
+  segment_dev(
+    SplineSampleMode mode,
+    real_type        sx,
+    real_type        sy,
+    real_type        a,
+    real_type        b,
+    real_type        ya,
+    real_type        yb,
+    real_type        dd
+  ) {
+    real_type const h{ b-a };
+    real_type       d{ h*h*dd/8 };
+    if ( mode == SplineSampleMode::CHORD ) {
+      real_type const slope{ (yb-ya)/h * (sy/sx) };
+      d *= sy/std::sqrt( 1+slope*slope );
+    }
+    return d;
+  }
+
+  static
+  inline
+  real_type
+  max_abs_DD( Spline const & S, integer k, real_type a, real_type b ) {
+    return std::max( {
+      std::abs( S.id_DD( k, a ) ),
+      std::abs( S.id_DD( k, (a+b)/2 ) ),
+      std::abs( S.id_DD( k, b ) )
+    } );
+  }
+
+  // a single spline
+  struct SampleSpline {
+    Spline const &   S;
+    SplineSampleMode mode;
+    real_type        sx, sy;
+
+    integer           npts() const { return S.num_points(); }
+    real_type const * X()    const { return S.x_nodes(); }
+
+    real_type
+    dev( integer k, real_type a, real_type b ) const {
+      return segment_dev(
+        mode, sx, sy, a, b, S.id_eval( k, a ), S.id_eval( k, b ), max_abs_DD( S, k, a, b )
+      );
+    }
+
+    void
+    row( sample_buffer & buf, integer k, real_type x ) const
+    { fmt::format_to( std::back_inserter(buf), "{}\t{}\n", x, S.id_eval( k, x ) ); }
+  };
+
+  // the splines of a `SplineSet`, sharing the nodes
+  struct SampleSet {
+    SplineSet const &      SS;
+    vector<Spline const *> S;
+    SplineSampleMode       mode;
+    real_type              sx, sy;
+
+    SampleSet( SplineSet const & ss, SplineSampleMode m, real_type x, real_type y )
+    : SS( ss ), S( static_cast<size_t>(ss.num_splines()) ), mode( m ), sx( x ), sy( y ) {
+      for ( integer i{0}; i < ss.num_splines(); ++i ) S[size_t(i)] = ss.get_spline(i);
+    }
+
+    integer           npts() const { return SS.num_points(); }
+    real_type const * X()    const { return SS.x_nodes(); }
+
+    real_type
+    dev( integer k, real_type a, real_type b ) const {
+      real_type d{0};
+      for ( Spline const * P : S )
+        d = std::max( d, segment_dev(
+          mode, sx, sy, a, b, P->id_eval( k, a ), P->id_eval( k, b ), max_abs_DD( *P, k, a, b )
+        ) );
+      return d;
+    }
+
+    void
+    row( sample_buffer & buf, integer k, real_type x ) const {
+      fmt::format_to( std::back_inserter(buf), "{}", x );
+      for ( Spline const * P : S ) fmt::format_to( std::back_inserter(buf), "\t{}", P->id_eval( k, x ) );
+      buf.push_back( '\n' );
+    }
+  };
+
+  // the components of a `SplineVec` (cubic Hermite on the nodes)
+  struct SampleVec {
+    SplineVec const & SV;
+    SplineSampleMode  mode;
+
+    integer           npts() const { return SV.num_points(); }
+    real_type const * X()    const { return SV.x_nodes(); }
+
+    real_type
+    dev( integer k, real_type a, real_type b ) const {
+      real_type const * XX{ SV.x_nodes() };
+      real_type const   H{ XX[k+1]-XX[k] };
+      real_type         dd{0};
+      for ( real_type const x : { a, (a+b)/2, b } ) {
+        real_type base_DD[4];
+        Hermite3_DD( x-XX[k], H, base_DD );
+        real_type nrm{0};
+        for ( integer j{0}; j < SV.dimension(); ++j ) {
+          real_type const * Y { SV.y_nodes(j) };
+          real_type const * Yp{ SV.yp_nodes(j) };
+          real_type const v{
+            base_DD[0]*Y[k] + base_DD[1]*Y[k+1] + base_DD[2]*Yp[k] + base_DD[3]*Yp[k+1]
+          };
+          if ( mode == SplineSampleMode::CHORD ) nrm += v*v;
+          else                                   nrm = std::max( nrm, std::abs(v) );
+        }
+        dd = std::max( dd, mode == SplineSampleMode::CHORD ? std::sqrt(nrm) : nrm );
+      }
+      real_type const h{ b-a };
+      return h*h*dd/8;
+    }
+
+    void
+    row( sample_buffer & buf, integer k, real_type x ) const {
+      real_type const * XX{ SV.x_nodes() };
+      real_type base[4];
+      Hermite3( x-XX[k], XX[k+1]-XX[k], base );
+      fmt::format_to( std::back_inserter(buf), "{}", x );
+      for ( integer j{0}; j < SV.dimension(); ++j ) {
+        real_type const * Y { SV.y_nodes(j) };
+        real_type const * Yp{ SV.yp_nodes(j) };
+        fmt::format_to(
+          std::back_inserter(buf), "\t{}",
+          base[0]*Y[k] + base[1]*Y[k+1] + base[2]*Yp[k] + base[3]*Yp[k+1]
+        );
+      }
+      buf.push_back( '\n' );
+    }
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  template <typename SRC>
+  void
+  SplineSampler::run( SRC const & src, vector<real_type> * xs, ostream_type * s ) {
+    integer   const   nint  { src.npts()-1 };
+    real_type const * X     { src.X() };
+    integer   const   ntasks{ (nint+sampler_chunk-1)/sampler_chunk };
+
+    vector<vector<real_type>> txs( static_cast<size_t>(sampler_window) );
+    vector<sample_buffer>     bufs( static_cast<size_t>( s != nullptr ? sampler_window : 0 ) );
+
+    m_num_samples = 1;
+    if ( xs != nullptr ) xs->assign( 1, X[0] );
+    if ( s != nullptr ) {
+      sample_buffer buf;
+      src.row( buf, 0, X[0] );
+      s->write( buf.data(), std::streamsize(buf.size()) );
+    }
+
+    for ( integer w0{0}; w0 < ntasks; w0 += sampler_window ) {
+      integer const nw{ std::min( sampler_window, ntasks-w0 ) };
+      m_pool->run( nw, [&]( integer t ) {
+        vector<real_type> & lx{ txs[size_t(t)] };
+        lx.clear();
+        integer const k0{ (w0+t)*sampler_chunk };
+        integer const k1{ std::min( nint, k0+sampler_chunk ) };
+        for ( integer k{k0}; k < k1; ++k ) {
+          size_t const i0{ lx.size() };
+          bisect( src, k, X[k], X[k+1], m_tolerance, m_max_depth, lx );
+          if ( s == nullptr ) continue;
+          sample_buffer & buf{ bufs[size_t(t)] };
+          for ( size_t i{i0}; i < lx.size(); ++i ) src.row( buf, k, lx[i] );
+        }
+      } );
+      for ( integer t{0}; t < nw; ++t ) {
+        vector<real_type> & lx{ txs[size_t(t)] };
+        m_num_samples += integer(lx.size());
+        if ( xs != nullptr ) xs->insert( xs->end(), lx.begin(), lx.end() );
+        if ( s != nullptr ) {
+          sample_buffer & buf{ bufs[size_t(t)] };
+          s->write( buf.data(), std::streamsize(buf.size()) );
+          buf.clear();
+        }
+      }
+    }
+  }
+
+  #endif
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  SplineSampler::SplineSampler( real_type tolerance, integer num_threads )
+  : m_pool( new WorkStealingPool( num_threads ) )
+  { this->set_tolerance( tolerance ); }
+
+  SplineSampler::~SplineSampler() {}
+
+  void
+  SplineSampler::set_tolerance( real_type tol ) {
+    UTILS_ASSERT( tol > 0, "SplineSampler::set_tolerance( {} ), must be > 0\n", tol );
+    m_tolerance = tol;
+  }
+
+  void
+  SplineSampler::set_scale( real_type sx, real_type sy ) {
+    UTILS_ASSERT(
+      sx > 0 && sy > 0, "SplineSampler::set_scale( {}, {} ), must be > 0\n", sx, sy
+    );
+    m_sx = sx;
+    m_sy = sy;
+  }
+
+  void
+  SplineSampler::set_max_depth( integer depth ) {
+    UTILS_ASSERT(
+      depth >= 0 && depth <= 50, "SplineSampler::set_max_depth( {} ), must be in [0,50]\n", depth
+    );
+    m_max_depth = depth;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineSampler::sample( Spline const & S, vector<real_type> & x ) {
+    UTILS_ASSERT( S.num_points() >= 2, "SplineSampler::sample( {} ), spline not built\n", S.name() );
+    this->run( SampleSpline{ S, m_mode, m_sx, m_sy }, &x, nullptr );
+  }
+
+  void
+  SplineSampler::sample( SplineSet const & S, vector<real_type> & x ) {
+    UTILS_ASSERT( S.num_points() >= 2, "SplineSampler::sample( {} ), set not built\n", S.name() );
+    this->run( SampleSet( S, m_mode, m_sx, m_sy ), &x, nullptr );
+  }
+
+  void
+  SplineSampler::sample( SplineVec const & S, vector<real_type> & x ) {
+    UTILS_ASSERT( S.num_points() >= 2, "SplineSampler::sample( {} ), curve not built\n", S.name() );
+    this->run( SampleVec{ S, m_mode }, &x, nullptr );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineSampler::dump( Spline const & S, ostream_type & s, string_view header ) {
+    UTILS_ASSERT( S.num_points() >= 2, "SplineSampler::dump( {} ), spline not built\n", S.name() );
+    s << header << '\n';
+    this->run( SampleSpline{ S, m_mode, m_sx, m_sy }, nullptr, &s );
+  }
+
+  void
+  SplineSampler::dump_table( SplineSet const & S, ostream_type & s ) {
+    UTILS_ASSERT( S.num_points() >= 2, "SplineSampler::dump_table( {} ), set not built\n", S.name() );
+    s << 's';
+    for ( integer i{0}; i < S.num_splines(); ++i ) s << '\t' << S.header(i);
+    s << '\n';
+    this->run( SampleSet( S, m_mode, m_sx, m_sy ), nullptr, &s );
+  }
+
+  void
+  SplineSampler::dump_table( SplineVec const & S, ostream_type & s ) {
+    UTILS_ASSERT( S.num_points() >= 2, "SplineSampler::dump_table( {} ), curve not built\n", S.name() );
+    s << 's';
+    for ( integer i{0}; i < S.dimension(); ++i ) s << '\t' << i;
+    s << '\n';
+    this->run( SampleVec{ S, m_mode }, nullptr, &s );
+  }
+
+}
+
+// EOF: SplineSampler.cc
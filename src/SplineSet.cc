@@ -87,6 +87,7 @@ namespace Splines {
   , m_mem_p( fmt::format( "SplineSet[{}]::m_mem_p", name ) )
   , m_mem_int( fmt::format( "SplineSet[{}]::m_mem_int", name ) )
   {
+    m_search.setup( &m_name, &m_npts, &m_X, &m_closed, &m_can_extend );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -230,19 +231,52 @@ namespace Splines {
     real_type    const         data_X[],
     real_type    const * const data_Y[],
     real_type    const * const data_Yp[]
+  ) {
+    build_internal( nspl, npts, headers, stype, data_X, data_Y, data_Yp, false );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineSet::build_external(
+    integer      const         nspl,
+    integer      const         npts,
+    char         const * const headers[],
+    SplineType1D const         stype[],
+    real_type    const         data_X[],
+    real_type    const * const data_Y[],
+    real_type    const * const data_Yp[]
+  ) {
+    build_internal( nspl, npts, headers, stype, data_X, data_Y, data_Yp, true );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineSet::build_internal(
+    integer      const         nspl,
+    integer      const         npts,
+    char         const * const headers[],
+    SplineType1D const         stype[],
+    real_type    const         data_X[],
+    real_type    const * const data_Y[],
+    real_type    const * const data_Yp[],
+    bool         const         borrow
   ) {
     string msg{ fmt::format("SplineSet[{}]::build(...):", m_name ) };
     UTILS_ASSERT( nspl > 0, "{} expected positive nspl = {}\n", msg, nspl );
     UTILS_ASSERT( npts > 1, "{} expected npts = {} greater than 1", msg, npts );
-    m_nspl = nspl;
-    m_npts = npts;
+    m_nspl  = nspl;
+    m_npts  = npts;
+    m_owned = !borrow;
     // allocate memory
     m_splines.resize( m_nspl );
     m_is_monotone = m_mem_int.realloc( m_nspl );
 
     m_header_to_position.clear();
 
-    integer mem{npts};
+    // when borrowing X, Y (and Yp of Hermite splines) are not allocated
+    integer mem{ borrow ? 0 : npts };
     for ( integer spl{0}; spl < nspl; ++spl ) {
       switch (stype[spl]) {
       case SplineType1D::QUINTIC:
@@ -252,12 +286,14 @@ namespace Splines {
       case SplineType1D::AKIMA:
       case SplineType1D::BESSEL:
       case SplineType1D::PCHIP:
-      case SplineType1D::HERMITE:
         mem += npts; // Y, Yp
         [[fallthrough]];
       case SplineType1D::CONSTANT:
       case SplineType1D::LINEAR:
-        mem += npts;
+        if ( !borrow ) mem += npts;
+        break;
+      case SplineType1D::HERMITE:
+        if ( !borrow ) mem += 2*npts;
         break;
       case SplineType1D::SPLINE_SET:
       case SplineType1D::SPLINE_VEC:
@@ -275,17 +311,26 @@ namespace Splines {
     m_Y    = m_mem_p ( m_nspl );
     m_Yp   = m_mem_p ( m_nspl );
     m_Ypp  = m_mem_p ( m_nspl );
-    m_X    = m_mem   ( m_npts );
     m_Ymin = m_mem   ( m_nspl );
     m_Ymax = m_mem   ( m_nspl );
 
-    copy_n( data_X, npts, m_X );
+    // borrowed arrays are only read by the splines
+    if ( borrow ) {
+      m_X = const_cast<real_type*>( data_X );
+    } else {
+      m_X = m_mem( m_npts );
+      copy_n( data_X, npts, m_X );
+    }
     for ( integer spl{0}; spl < nspl; ++spl ) {
       real_type * & pY{ m_Y[spl] };
       real_type * & pYp{ m_Yp[spl] };
       real_type * & pYpp{ m_Ypp[spl] };
-      pY = m_mem( m_npts );
-      copy_n( data_Y[spl], npts, pY );
+      if ( borrow ) {
+        pY = const_cast<real_type*>( data_Y[spl] );
+      } else {
+        pY = m_mem( m_npts );
+        copy_n( data_Y[spl], npts, pY );
+      }
       if ( stype[spl] == SplineType1D::CONSTANT ) {
         m_Ymin[spl] = *std::min_element( pY, pY+npts-1 );
         m_Ymax[spl] = *std::max_element( pY, pY+npts-1 );
@@ -303,7 +348,6 @@ namespace Splines {
       case SplineType1D::BESSEL:
       case SplineType1D::PCHIP:
       case SplineType1D::HERMITE:
-        pYp = m_mem( m_npts );
         if ( stype[spl] == SplineType1D::HERMITE ) {
           UTILS_ASSERT(
             data_Yp != nullptr && data_Yp[spl] != nullptr,
@@ -311,7 +355,14 @@ namespace Splines {
             "expect to find derivative values",
             msg, spl, headers[spl]
           );
-          copy_n( data_Yp[spl], npts, pYp );
+          if ( borrow ) {
+            pYp = const_cast<real_type*>( data_Yp[spl] );
+          } else {
+            pYp = m_mem( m_npts );
+            copy_n( data_Yp[spl], npts, pYp );
+          }
+        } else {
+          pYp = m_mem( m_npts );
         }
         [[fallthrough]];
       case SplineType1D::CONSTANT:
@@ -425,15 +476,278 @@ namespace Splines {
 
     m_mem.must_be_empty( "SplineSet::build, baseValue" );
     m_mem_p.must_be_empty( "SplineSet::build, basePointer" );
+    m_mapped.reset();
+    m_table.reset();
+    build_groups();
   }
   
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  unsigned long
+  SplineSet::splines_key() const {
+    // generations only grow, so the sum changes whenever a column does
+    unsigned long key{0};
+    for ( std::unique_ptr<Spline> const & S : m_splines )
+      if ( S ) key += S->m_search.generation();
+    return key;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineSet::build_groups() const {
+    m_groups.clear();
+    m_generic_cols.clear();
+
+    // group key: kernel type and constant extension
+    auto group_of = [this]( SplineType1D t, bool ext ) -> ColumnGroup & {
+      for ( ColumnGroup & G : m_groups )
+        if ( G.type == t && G.extended_constant == ext ) return G;
+      m_groups.emplace_back();
+      m_groups.back().type              = t;
+      m_groups.back().extended_constant = ext;
+      return m_groups.back();
+    };
+
+    for ( integer spl{0}; spl < m_nspl; ++spl ) {
+      Spline const * S{ m_splines[spl].get() };
+      if ( S == nullptr ) continue;
+      // splines rebuilt on their own nodes or closed are not grouped
+      bool ok{ S->m_X == m_X && S->m_npts == m_npts && !S->m_curve_is_closed };
+      SplineType1D t{ S->type() };
+      switch ( t ) {
+      case SplineType1D::AKIMA:
+      case SplineType1D::BESSEL:
+      case SplineType1D::PCHIP:
+      case SplineType1D::HERMITE:
+        t = SplineType1D::CUBIC;
+        break;
+      case SplineType1D::CONSTANT:
+      case SplineType1D::LINEAR:
+      case SplineType1D::CUBIC:
+      case SplineType1D::QUINTIC:
+        break;
+      default:
+        ok = false;
+        break;
+      }
+      // `ConstantSpline` ignores the constant extension flag
+      bool const ext{ t != SplineType1D::CONSTANT && S->m_curve_can_extend && S->m_curve_extended_constant };
+      if ( ok ) group_of( t, ext ).cols.push_back( spl );
+      else      m_generic_cols.push_back( spl );
+    }
+
+    // the arrays of the splines (a rebuild may have changed them)
+    for ( ColumnGroup & G : m_groups ) {
+      size_t const nc{ G.cols.size() };
+      G.pY.resize( nc );
+      G.pYp.assign( nc, nullptr );
+      G.pYpp.assign( nc, nullptr );
+      for ( size_t c{0}; c < nc; ++c ) {
+        Spline const * S{ m_splines[G.cols[c]].get() };
+        G.pY[c] = S->m_Y;
+        if ( G.type == SplineType1D::CUBIC ) {
+          G.pYp[c] = static_cast<CubicSplineBase const *>(S)->yp_nodes();
+        } else if ( G.type == SplineType1D::QUINTIC ) {
+          QuinticSplineBase const * Q{ static_cast<QuinticSplineBase const *>(S) };
+          G.pYp[c]  = Q->yp_nodes();
+          G.pYpp[c] = Q->ypp_nodes();
+        }
+      }
+      if ( !m_owned ) continue;
+      // owned data: point major copy, read by the vectorized loops
+      bool const has_Yp  { G.type == SplineType1D::CUBIC || G.type == SplineType1D::QUINTIC };
+      bool const has_Ypp { G.type == SplineType1D::QUINTIC };
+      G.Y.resize( nc*size_t(m_npts) );
+      G.Yp.resize( has_Yp ? nc*size_t(m_npts) : 0 );
+      G.Ypp.resize( has_Ypp ? nc*size_t(m_npts) : 0 );
+      for ( size_t c{0}; c < nc; ++c ) {
+        for ( integer i{0}; i < m_npts; ++i ) {
+          size_t const k{ size_t(i)*nc+c };
+          G.Y[k] = G.pY[c][i];
+          if ( has_Yp  ) G.Yp[k]  = G.pYp[c][i];
+          if ( has_Ypp ) G.Ypp[k] = G.pYpp[c][i];
+        }
+      }
+    }
+
+    m_search.must_reset();
+    m_groups_key.store( splines_key(), std::memory_order_release );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  //
+  // One interval search for all the columns, then for each group the
+  // basis is computed once and the columns are combined in a loop
+  // without calls (vectorized by the compiler on the point major copy),
+  // results are scattered to the original column positions.
+  //
+  void
+  SplineSet::eval_grouped(
+    real_type const x,
+    integer   const deriv,
+    real_type       vals[],
+    integer   const incy
+  ) const {
+    if ( m_nspl <= 0 ) return;
+
+    // regroup if a column was rebuilt or had its flags changed
+    // through `get_spline` (lock only to regroup)
+    unsigned long const key{ splines_key() };
+    if ( m_groups_key.load( std::memory_order_acquire ) != key ) {
+      std::lock_guard<std::mutex> lock(m_groups_mutex);
+      if ( m_groups_key.load( std::memory_order_relaxed ) != key ) build_groups();
+    }
+
+    if ( !m_groups.empty() ) {
+      std::pair<integer,real_type> res(0,x);
+      m_search.find( res );
+      integer   const i   { res.first };
+      real_type const X0  { m_X[0] };
+      real_type const XN  { m_X[m_npts-1] };
+      real_type const H   { m_X[i+1] - m_X[i] };
+      real_type const dx  { x - m_X[i] };
+      bool      const out { x <= X0 || x >= XN };
+
+      // basis of the Hermite cubic and quintic for the requested derivative
+      real_type B3[4], B5[6];
+      bool has_B3{false}, has_B5{false};
+
+      // kernel of the group on the values `y0`, `y1` (`p0`, `p1`, `q0`, `q1`
+      // first and second derivatives) of the nodes `i`, `i+1`
+      auto kernel = [&]( SplineType1D t, real_type y0, real_type y1,
+                         real_type p0, real_type p1, real_type q0, real_type q1 ) -> real_type {
+        switch ( t ) {
+        case SplineType1D::CONSTANT:
+          return deriv == 0 ? y0 : 0;
+        case SplineType1D::LINEAR:
+          if ( deriv == 0 ) return (1-dx/H)*y0 + (dx/H)*y1;
+          if ( deriv == 1 ) return (y1-y0)/H;
+          return 0;
+        case SplineType1D::CUBIC:
+          return B3[0]*y0 + B3[1]*y1 + B3[2]*p0 + B3[3]*p1;
+        default: // QUINTIC
+          return B5[0]*y0 + B5[1]*y1 + B5[2]*p0 + B5[3]*p1 + B5[4]*q0 + B5[5]*q1;
+        }
+      };
+
+      constexpr integer CHUNK{ 128 };
+      real_type tmp[CHUNK];
+
+      for ( ColumnGroup const & G : m_groups ) {
+        integer const   nc { integer(G.cols.size()) };
+        integer const * col{ G.cols.data() };
+
+        if ( G.extended_constant && out ) {
+          // constant extension: border value, null derivatives
+          integer const iB{ x <= X0 ? 0 : m_npts-1 };
+          for ( integer c{0}; c < nc; ++c )
+            vals[col[c]*incy] = deriv == 0 ? G.pY[c][iB] : 0;
+          continue;
+        }
+
+        if ( G.type == SplineType1D::CUBIC && !has_B3 ) {
+          switch ( deriv ) {
+          case 0:  Hermite3    ( dx, H, B3 ); break;
+          case 1:  Hermite3_D  ( dx, H, B3 ); break;
+          case 2:  Hermite3_DD ( dx, H, B3 ); break;
+          default: Hermite3_DDD( dx, H, B3 ); break;
+          }
+          has_B3 = true;
+        } else if ( G.type == SplineType1D::QUINTIC && !has_B5 ) {
+          switch ( deriv ) {
+          case 0:  Hermite5    ( dx, H, B5 ); break;
+          case 1:  Hermite5_D  ( dx, H, B5 ); break;
+          case 2:  Hermite5_DD ( dx, H, B5 ); break;
+          default: Hermite5_DDD( dx, H, B5 ); break;
+          }
+          has_B5 = true;
+        }
+
+        if ( G.Y.empty() ) {
+          // columns read in place
+          for ( integer c{0}; c < nc; ++c ) {
+            real_type const * Y   { G.pY[c]   };
+            real_type const * Yp  { G.pYp[c]  };
+            real_type const * Ypp { G.pYpp[c] };
+            vals[col[c]*incy] = kernel(
+              G.type, Y[i], Y[i+1],
+              Yp  == nullptr ? 0 : Yp[i],  Yp  == nullptr ? 0 : Yp[i+1],
+              Ypp == nullptr ? 0 : Ypp[i], Ypp == nullptr ? 0 : Ypp[i+1]
+            );
+          }
+          continue;
+        }
+
+        // point major copy: contiguous loads across the columns
+        size_t    const   i0 { size_t(i)*size_t(nc) };
+        real_type const * Y0 { G.Y.data() + i0 };
+        real_type const * Y1 { Y0 + nc };
+        for ( integer c0{0}; c0 < nc; c0 += CHUNK ) {
+          integer const m{ std::min( CHUNK, nc-c0 ) };
+          real_type const * y0{ Y0+c0 };
+          real_type const * y1{ Y1+c0 };
+          switch ( G.type ) {
+          case SplineType1D::CONSTANT:
+            for ( integer c{0}; c < m; ++c ) tmp[c] = deriv == 0 ? y0[c] : 0;
+            break;
+          case SplineType1D::LINEAR:
+            if ( deriv == 0 ) {
+              real_type const t{ dx/H };
+              for ( integer c{0}; c < m; ++c ) tmp[c] = (1-t)*y0[c] + t*y1[c];
+            } else if ( deriv == 1 ) {
+              for ( integer c{0}; c < m; ++c ) tmp[c] = (y1[c]-y0[c])/H;
+            } else {
+              for ( integer c{0}; c < m; ++c ) tmp[c] = 0;
+            }
+            break;
+          case SplineType1D::CUBIC:
+            { real_type const * p0{ G.Yp.data() + i0 + size_t(c0) };
+              real_type const * p1{ p0 + nc };
+              for ( integer c{0}; c < m; ++c )
+                tmp[c] = B3[0]*y0[c] + B3[1]*y1[c] + B3[2]*p0[c] + B3[3]*p1[c];
+            }
+            break;
+          default: // QUINTIC
+            { real_type const * p0{ G.Yp.data()  + i0 + size_t(c0) };
+              real_type const * p1{ p0 + nc };
+              real_type const * q0{ G.Ypp.data() + i0 + size_t(c0) };
+              real_type const * q1{ q0 + nc };
+              for ( integer c{0}; c < m; ++c )
+                tmp[c] = B5[0]*y0[c] + B5[1]*y1[c] + B5[2]*p0[c] +
+                         B5[3]*p1[c] + B5[4]*q0[c] + B5[5]*q1[c];
+            }
+            break;
+          }
+          for ( integer c{0}; c < m; ++c ) vals[col[c0+c]*incy] = tmp[c];
+        }
+      }
+    }
+
+    for ( integer spl : m_generic_cols ) {
+      Spline const * S{ m_splines[spl].get() };
+      switch ( deriv ) {
+      case 0:  vals[spl*incy] = S->eval(x); break;
+      case 1:  vals[spl*incy] = S->D(x);    break;
+      case 2:  vals[spl*incy] = S->DD(x);   break;
+      default: vals[spl*incy] = S->DDD(x);  break;
+      }
+    }
+  }
+
+  #endif
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   SplineSet::eval( real_type const x, vector<real_type> & vals ) const {
     vals.resize( m_nspl );
-    for ( integer i{0}; i < m_nspl; ++i )
-      vals[i] = m_splines[i]->eval(x);
+    eval_grouped( x, 0, vals.data(), 1 );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -444,9 +758,7 @@ namespace Splines {
     real_type       vals[],
     integer   const incy
   ) const {
-    integer ii{0};
-    for ( integer i{0}; i < m_nspl; ++i, ii += incy )
-      vals[ii] = m_splines[i]->eval(x);
+    eval_grouped( x, 0, vals, incy );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -454,8 +766,7 @@ namespace Splines {
   void
   SplineSet::eval_D( real_type const x, vector<real_type> & vals ) const {
     vals.resize( m_nspl );
-    for ( integer i{0}; i < m_nspl; ++i )
-      vals[i] = m_splines[i]->D(x);
+    eval_grouped( x, 1, vals.data(), 1 );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -466,9 +777,7 @@ namespace Splines {
     real_type       vals[],
     integer   const incy
   ) const {
-    size_t ii{0};
-    for ( integer i{0}; i < m_nspl; ++i, ii += incy )
-      vals[ii] = m_splines[i]->D(x);
+    eval_grouped( x, 1, vals, incy );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -476,8 +785,7 @@ namespace Splines {
   void
   SplineSet::eval_DD( real_type const x, vector<real_type> & vals ) const {
     vals.resize( m_nspl );
-    for ( integer i{0}; i < m_nspl; ++i )
-      vals[i] = m_splines[i]->DD(x);
+    eval_grouped( x, 2, vals.data(), 1 );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -488,9 +796,7 @@ namespace Splines {
     real_type       vals[],
     integer   const incy
   ) const {
-    size_t ii{0};
-    for ( integer i{0}; i < m_nspl; ++i, ii += incy )
-      vals[ii] = m_splines[i]->DD(x);
+    eval_grouped( x, 2, vals, incy );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -498,8 +804,7 @@ namespace Splines {
   void
   SplineSet::eval_DDD( real_type const x, vector<real_type> & vals ) const {
     vals.resize( m_nspl );
-    for ( integer i{0}; i < m_nspl; ++i )
-      vals[i] = m_splines[i]->DDD(x);
+    eval_grouped( x, 3, vals.data(), 1 );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -510,9 +815,7 @@ namespace Splines {
     real_type       vals[],
     integer   const incy
   ) const {
-    size_t ii{0};
-    for ( integer i{0}; i < m_nspl; ++i, ii += incy )
-      vals[ii] = m_splines[i]->DDD(x);
+    eval_grouped( x, 3, vals, incy );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -0,0 +1,362 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#pragma clang diagnostic ignored "-Wsign-conversion"
+#endif
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+using namespace std; // load standard namspace
+#endif
+
+namespace Splines {
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  static size_t const table_block_size{ size_t(1) << 22 }; // 4MB
+
+  static
+  void
+  check_table_types( vector<SplineType1D> const & stype, string_view where ) {
+    for ( size_t i{0}; i < stype.size(); ++i ) {
+      switch ( stype[i] ) {
+      case SplineType1D::HERMITE:
+      case SplineType1D::SPLINE_SET:
+      case SplineType1D::SPLINE_VEC:
+        UTILS_ERROR( "{}: column {} type {} not allowed\n", where, i+1, to_string(stype[i]) );
+      default:
+        break;
+      }
+    }
+  }
+
+  static
+  string
+  trim_field( char const * b, char const * e ) {
+    while ( b < e && ( *b == ' ' || *b == '\t' || *b == '"' ) ) ++b;
+    while ( e > b && ( e[-1] == ' ' || e[-1] == '\t' || e[-1] == '"' || e[-1] == '\r' ) ) --e;
+    return string( b, e );
+  }
+
+  static
+  bool
+  blank_line( char const * b, char const * e ) {
+    for ( ; b < e; ++b ) if ( !std::isspace( static_cast<unsigned char>(*b) ) ) return false;
+    return true;
+  }
+
+  //
+  // Parse `ncols` values of the line [b,e) into `table[c*npts+row]`.
+  // Return the index of the first bad column or -1 if the line is fine.
+  //
+  static
+  integer
+  parse_line(
+    char const * b,
+    char const * e,
+    char         sep,
+    integer      ncols,
+    size_t       npts,
+    size_t       row,
+    real_type    table[]
+  ) {
+    for ( integer c{0}; c < ncols; ++c ) {
+      char * end;
+      real_type const v{ std::strtod( b, &end ) };
+      if ( end == b || end > e ) return c;
+      table[ size_t(c)*npts + row ] = v;
+      b = end;
+      while ( b < e && ( *b == ' ' || *b == '\t' || *b == '\r' ) ) ++b;
+      if ( c+1 < ncols ) {
+        if ( b >= e || *b != sep ) return c+1;
+        ++b;
+      } else if ( b != e ) {
+        return c; // trailing garbage
+      }
+    }
+    return -1;
+  }
+
+  #endif
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineSet::load_csv(
+    string_view  const file_name,
+    SplineType1D const stype,
+    char         const sep,
+    integer      const num_threads
+  ) {
+    // the number of columns is known only after reading the header
+    std::ifstream file{ string(file_name) };
+    string header;
+    UTILS_ASSERT(
+      file.good() && std::getline( file, header ),
+      "SplineSet[{}]::load_csv: cannot read header of `{}`\n", m_name, file_name
+    );
+    size_t const nspl{ size_t( std::count( header.begin(), header.end(), sep ) ) };
+    file.close();
+    load_csv( file_name, vector<SplineType1D>( nspl, stype ), sep, num_threads );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineSet::load_csv(
+    string_view          const   file_name,
+    vector<SplineType1D> const & stype,
+    char                 const   sep,
+    integer              const   num_threads
+  ) {
+    string const where{ fmt::format( "SplineSet[{}]::load_csv(\"{}\")", m_name, file_name ) };
+    check_table_types( stype, where );
+
+    std::ifstream file( string(file_name), std::ios::binary );
+    UTILS_ASSERT( file.good(), "{}: cannot open file\n", where );
+
+    // headers
+    string line;
+    UTILS_ASSERT( std::getline( file, line ), "{}: missing header\n", where );
+    vector<string> headers;
+    {
+      char const * b{ line.data() };
+      char const * e{ b + line.size() };
+      while ( true ) {
+        char const * p{ std::find( b, e, sep ) };
+        headers.emplace_back( trim_field( b, p ) );
+        if ( p == e ) break;
+        b = p+1;
+      }
+    }
+    integer const ncols{ integer(headers.size()) };
+    UTILS_ASSERT(
+      ncols >= 2 && size_t(ncols-1) == stype.size(),
+      "{}: found {} columns, expected {} (x + one for each spline)\n",
+      where, ncols, stype.size()+1
+    );
+    headers.erase( headers.begin() ); // name of the x column
+    std::streampos const data_start{ file.tellg() };
+
+    // first pass: count the non blank lines
+    vector<char> buffer( table_block_size + 1 );
+    size_t npts{0};
+    {
+      bool content{false};
+      while ( file ) {
+        file.read( buffer.data(), std::streamsize(table_block_size) );
+        size_t const n{ size_t(file.gcount()) };
+        for ( size_t i{0}; i < n; ++i ) {
+          char const ch{ buffer[i] };
+          if ( ch == '\n' ) {
+            if ( content ) ++npts;
+            content = false;
+          } else if ( !std::isspace( static_cast<unsigned char>(ch) ) ) {
+            content = true;
+          }
+        }
+      }
+      if ( content ) ++npts;
+    }
+    UTILS_ASSERT( npts > 1, "{}: found {} rows, at least 2 needed\n", where, npts );
+    UTILS_ASSERT(
+      npts <= size_t(std::numeric_limits<integer>::max()),
+      "{}: too many rows {}\n", where, npts
+    );
+
+    // final storage, column major
+    std::unique_ptr<real_type[]> table( new real_type[ size_t(ncols)*npts ] );
+
+    integer nth{ num_threads > 0 ? num_threads : integer(std::thread::hardware_concurrency()) };
+    if ( nth < 1 ) nth = 1;
+
+    // second pass: parse blocks of complete lines in parallel
+    file.clear();
+    file.seekg( data_start );
+    size_t row{0};
+    size_t carry{0};   // bytes of an incomplete line moved at the beginning of the buffer
+    size_t line_no{2}; // for error messages (header is line 1)
+    vector<char const *> lb, le;    // line ranges
+    vector<size_t>       lrow;      // row index of each line
+    vector<size_t>       lnum;      // line number of each line
+    while ( true ) {
+      file.read( buffer.data() + carry, std::streamsize(table_block_size - carry) );
+      size_t const got{ size_t(file.gcount()) };
+      size_t const n{ carry + got };
+      bool   const last{ got < table_block_size - carry };
+      if ( n == 0 ) break;
+
+      // split in lines, an incomplete tail is kept for the next block
+      lb.clear(); le.clear(); lrow.clear(); lnum.clear();
+      char const * b{ buffer.data() };
+      char const * E{ buffer.data() + n };
+      while ( b < E ) {
+        char const * p{ static_cast<char const *>( std::memchr( b, '\n', size_t(E-b) ) ) };
+        if ( p == nullptr ) {
+          if ( !last ) break;
+          p = E;
+        }
+        if ( !blank_line( b, p ) ) {
+          UTILS_ASSERT( row < npts, "{}: file changed while reading\n", where );
+          lb.emplace_back( b );
+          le.emplace_back( p );
+          lrow.emplace_back( row++ );
+          lnum.emplace_back( line_no );
+        }
+        ++line_no;
+        b = p == E ? E : p+1;
+      }
+      carry = size_t( E - b );
+      UTILS_ASSERT(
+        carry < table_block_size,
+        "{}: line {} longer than {} bytes\n", where, line_no, table_block_size
+      );
+      buffer[n] = '\0'; // strtod never runs past the buffer
+
+      // small blocks are not worth the threads
+      size_t  const nl{ lb.size() };
+      integer const nt{ nl < 1024 ? 1 : nth };
+      vector<integer> bad_col( size_t(nt), -1 );
+      vector<size_t>  bad_line( size_t(nt), 0 );
+      auto worker = [&]( integer t ) {
+        size_t const i0{ nl * size_t(t)   / size_t(nt) };
+        size_t const i1{ nl * size_t(t+1) / size_t(nt) };
+        for ( size_t i{i0}; i < i1; ++i ) {
+          integer const c{ parse_line( lb[i], le[i], sep, ncols, npts, lrow[i], table.get() ) };
+          if ( c >= 0 ) { bad_col[t] = c; bad_line[t] = lnum[i]; return; }
+        }
+      };
+      if ( nt == 1 ) {
+        worker(0);
+      } else {
+        vector<std::thread> pool;
+        pool.reserve( size_t(nt) );
+        for ( integer t{0}; t < nt; ++t ) pool.emplace_back( worker, t );
+        for ( auto & th : pool ) th.join();
+      }
+      for ( integer t{0}; t < nt; ++t )
+        UTILS_ASSERT(
+          bad_col[t] < 0,
+          "{}: cannot parse column {} at line {}\n", where, bad_col[t]+1, bad_line[t]
+        );
+
+      if ( last ) break;
+      std::memmove( buffer.data(), b, carry );
+    }
+    UTILS_ASSERT( row == npts, "{}: read {} rows expected {}\n", where, row, npts );
+
+    // build using the table in place
+    integer const nspl{ ncols-1 };
+    vector<char const *>      hdrs( static_cast<size_t>(nspl) );
+    vector<real_type const *> Y( static_cast<size_t>(nspl) );
+    for ( integer i{0}; i < nspl; ++i ) {
+      hdrs[i] = headers[i].c_str();
+      Y[i]    = table.get() + size_t(i+1)*npts;
+    }
+    build_internal(
+      nspl, integer(npts), hdrs.data(), stype.data(), table.get(), Y.data(), nullptr, true
+    );
+    m_table = std::move(table);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineSet::load_raw(
+    string_view          const   file_name,
+    vector<string>       const & headers,
+    vector<SplineType1D> const & stype,
+    integer              const   npts_in
+  ) {
+    string const where{ fmt::format( "SplineSet[{}]::load_raw(\"{}\")", m_name, file_name ) };
+    check_table_types( stype, where );
+    UTILS_ASSERT(
+      !headers.empty() && headers.size() == stype.size(),
+      "{}: headers.size() = {} and stype.size() = {} must be equal and positive\n",
+      where, headers.size(), stype.size()
+    );
+
+    std::ifstream file( string(file_name), std::ios::binary | std::ios::ate );
+    UTILS_ASSERT( file.good(), "{}: cannot open file\n", where );
+
+    size_t const ncols{ headers.size()+1 };
+    size_t const bytes{ size_t(file.tellg()) };
+    size_t const npts{
+      npts_in > 0 ? size_t(npts_in) : bytes / ( ncols * sizeof(real_type) )
+    };
+    UTILS_ASSERT(
+      npts > 1 && bytes == ncols * npts * sizeof(real_type),
+      "{}: file size {} does not match {} columns of {} doubles\n",
+      where, bytes, ncols, npts
+    );
+    UTILS_ASSERT(
+      npts <= size_t(std::numeric_limits<integer>::max()),
+      "{}: too many rows {}\n", where, npts
+    );
+
+    // read directly in the final storage
+    std::unique_ptr<real_type[]> table( new real_type[ ncols*npts ] );
+    file.seekg( 0 );
+    char * dst{ reinterpret_cast<char*>(table.get()) };
+    for ( size_t done{0}; done < bytes; ) {
+      size_t const chunk{ std::min( table_block_size, bytes - done ) };
+      file.read( dst + done, std::streamsize(chunk) );
+      UTILS_ASSERT( file.good(), "{}: read failed at byte {}\n", where, done );
+      done += chunk;
+    }
+
+    // data are little endian, swap on big endian machines
+    uint16_t const probe{1};
+    if ( *reinterpret_cast<unsigned char const *>(&probe) == 0 ) {
+      for ( size_t k{0}; k < ncols*npts; ++k ) {
+        unsigned char * p{ reinterpret_cast<unsigned char*>(table.get()+k) };
+        std::reverse( p, p+sizeof(real_type) );
+      }
+    }
+
+    integer const nspl{ integer(ncols-1) };
+    vector<char const *>      hdrs( static_cast<size_t>(nspl) );
+    vector<real_type const *> Y( static_cast<size_t>(nspl) );
+    for ( integer i{0}; i < nspl; ++i ) {
+      hdrs[i] = headers[i].c_str();
+      Y[i]    = table.get() + size_t(i+1)*npts;
+    }
+    build_internal(
+      nspl, integer(npts), hdrs.data(), stype.data(), table.get(), Y.data(), nullptr, true
+    );
+    m_table = std::move(table);
+  }
+
+}
+
+// EOF: SplineSetTable.cc
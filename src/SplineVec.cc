@@ -28,6 +28,7 @@
 #endif
 
 #include "Splines.hh"
+#include "PolynomialRoots.hh"
 #include "Utils_fmt.hh"
 
 #include <limits>
@@ -49,6 +50,7 @@ namespace Splines {
   : m_name(name)
   , m_mem( fmt::format( "SplineVec[{}]::m_mem", name ) )
   , m_mem_p( fmt::format( "SplineVec[{}]::m_mem_p", name ) )
+  , m_mem_interleaved( fmt::format( "SplineVec[{}]::m_mem_interleaved", name ) )
   {
     m_search.setup( &m_name, &m_npts, &m_X, &m_curve_is_closed, &m_curve_can_extend );
   }
@@ -59,6 +61,7 @@ namespace Splines {
   SplineVec::~SplineVec() {
     m_mem.free();
     m_mem_p.free();
+    m_mem_interleaved.free();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -112,12 +115,89 @@ namespace Splines {
 
     m_mem.must_be_empty( "SplineVec::build, baseValue" );
     m_mem_p.must_be_empty( "SplineVec::build, basePointer" );
+
+    // derivatives are not yet computed, interleaved copy is invalid
+    knots_changed();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVec::knots_changed() {
+    // slopes must be recomputed (`catmull_rom`) before the copy is packed again
+    m_slopes_ok = false;
+    m_YYp       = nullptr;
+    m_search.must_reset();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVec::slopes_changed() {
+    m_slopes_ok = true;
+    if ( m_use_interleaved ) pack_interleaved();
+    m_search.must_reset();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVec::pack_interleaved() {
+    m_mem_interleaved.reallocate( 2*m_dim*m_npts );
+    m_YYp = m_mem_interleaved( 2*m_dim*m_npts );
+    real_type * p{m_YYp};
+    for ( integer i{0}; i < m_npts; ++i ) {
+      for ( integer j{0}; j < m_dim; ++j ) *p++ = m_Y[j][i];
+      for ( integer j{0}; j < m_dim; ++j ) *p++ = m_Yp[j][i];
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVec::combine(
+    integer   const i,
+    real_type const base[4],
+    real_type       vals[],
+    integer   const inc
+  ) const {
+    real_type * v{vals};
+    if ( m_YYp != nullptr ) {
+      real_type const * P0{ m_YYp + 2*m_dim*i };
+      real_type const * T0{ P0 + m_dim };
+      real_type const * P1{ T0 + m_dim };
+      real_type const * T1{ P1 + m_dim };
+      for ( integer j{0}; j < m_dim; ++j, v += inc )
+        *v = base[0] * P0[j] +
+             base[1] * P1[j] +
+             base[2] * T0[j] +
+             base[3] * T1[j];
+    } else {
+      for ( integer j{0}; j < m_dim; ++j, v += inc )
+        *v = base[0] * m_Y[j][i]   +
+             base[1] * m_Y[j][i+1] +
+             base[2] * m_Yp[j][i]  +
+             base[3] * m_Yp[j][i+1];
+    }
   }
 
   #endif
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  void
+  SplineVec::use_interleaved( bool const yes ) {
+    m_use_interleaved = yes;
+    if ( yes ) {
+      if ( m_slopes_ok ) pack_interleaved();
+    } else {
+      m_mem_interleaved.free();
+      m_YYp = nullptr;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   SplineVec::setup(
     integer   const         dim,
@@ -149,6 +229,12 @@ namespace Splines {
   void
   SplineVec::deep_copy_to( SplineVec & S ) const {
     S.setup( m_dim, m_npts, m_Y );
+    copy_n( m_X, m_npts, S.m_X );
+    for ( integer spl{0}; spl < m_dim; ++spl )
+      copy_n( m_Yp[spl], m_npts, S.m_Yp[spl] );
+    S.m_curve_is_closed  = m_curve_is_closed;
+    S.m_curve_can_extend = m_curve_can_extend;
+    if ( m_slopes_ok ) S.slopes_changed();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -156,7 +242,7 @@ namespace Splines {
   void
   SplineVec::set_knots( real_type const X[] ) {
     copy_n( X, m_npts, m_X );
-    m_search.must_reset();
+    knots_changed();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -211,7 +297,7 @@ namespace Splines {
     }
     for ( integer j{1}; j < nn; ++j ) m_X[j] /= acc;
     m_X[nn] = 1;
-    m_search.must_reset();
+    knots_changed();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -228,7 +314,7 @@ namespace Splines {
     }
     for ( integer j{1}; j < nn; ++j ) m_X[j] /= acc;
     m_X[nn] = 1;
-    m_search.must_reset();
+    knots_changed();
   }
 
   void
@@ -269,6 +355,106 @@ namespace Splines {
       m_Yp[k][n] = b*( m_Y[k][n-2] - m_Y[k][n] ) -
                    a*( m_Y[k][n-1] - m_Y[k][n] );
 
+    slopes_changed();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  real_type
+  SplineVec::id_integral(
+    integer   const i,
+    real_type const a,
+    real_type const b,
+    integer   const j
+  ) const {
+    real_type A, B, C, D;
+    Hermite3_to_poly(
+      m_X[i+1]-m_X[i], m_Y[j][i], m_Y[j][i+1], m_Yp[j][i], m_Yp[j][i+1], A, B, C, D
+    );
+    auto P = [A,B,C,D]( real_type const t ) -> real_type {
+      return t*(D+t*(C/2+t*(B/3+t*(A/4))));
+    };
+    return P(b-m_X[i]) - P(a-m_X[i]);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type const *
+  SplineVec::integral_table() const {
+    // lock only when the table must be rebuilt, as `SearchInterval::find`
+    if ( m_integral_generation.load( std::memory_order_acquire ) == m_search.generation() )
+      return m_integral_table.data();
+    std::lock_guard<std::mutex> lock(m_integral_mutex);
+    if ( m_integral_generation.load( std::memory_order_relaxed ) != m_search.generation() ) {
+      UTILS_ASSERT(
+        m_npts >= 2,
+        "SplineVec[{}]::integral, npts={} must be >= 2\n", m_name, m_npts
+      );
+      m_integral_table.resize( m_dim*m_npts );
+      for ( integer j{0}; j < m_dim; ++j ) {
+        real_type * T{ m_integral_table.data() + j*m_npts };
+        T[0] = 0;
+        for ( integer i{1}; i < m_npts; ++i )
+          T[i] = T[i-1] + id_integral( i-1, m_X[i-1], m_X[i], j );
+      }
+      m_integral_generation.store( m_search.generation(), std::memory_order_release );
+    }
+    return m_integral_table.data();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  SplineVec::primitive(
+    real_type const * T,
+    real_type         x,
+    integer   const   j
+  ) const {
+    integer   const n  { m_npts-1 };
+    real_type const x0 { m_X[0] };
+    real_type const x1 { m_X[n] };
+    real_type const * Tj{ T + j*m_npts };
+    real_type       res{0};
+    if ( m_curve_is_closed ) {
+      real_type const k{ std::floor( (x-x0)/(x1-x0) ) };
+      x   -= k*(x1-x0);
+      res  = k*Tj[n];
+    }
+    std::pair<integer,real_type> r(0,x);
+    m_search.find( r );
+    integer const i{ r.first };
+    return res + Tj[i] + id_integral( i, m_X[i], r.second, j );
+  }
+
+  #endif
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  SplineVec::integral(
+    real_type const a,
+    real_type const b,
+    integer   const j
+  ) const {
+    real_type const * T{ integral_table() };
+    return primitive( T, b, j ) - primitive( T, a, j );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVec::integral(
+    real_type const a[],
+    real_type const b[],
+    real_type       out[],
+    integer   const n,
+    integer   const j
+  ) const {
+    real_type const * T{ integral_table() };
+    for ( integer k{0}; k < n; ++k )
+      out[k] = primitive( T, b[k], j ) - primitive( T, a[k], j );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -344,12 +530,7 @@ namespace Splines {
     real_type base[4];
     integer const i{res.first};
     Hermite3( res.second-m_X[i], m_X[i+1]-m_X[i], base );
-    real_type * v{vals};
-    for ( integer j{0}; j < m_dim; ++j, v += inc )
-      *v = base[0] * m_Y[j][i]   +
-           base[1] * m_Y[j][i+1] +
-           base[2] * m_Yp[j][i]  +
-           base[3] * m_Yp[j][i+1];
+    combine( i, base, vals, inc );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -365,12 +546,7 @@ namespace Splines {
     real_type base_D[4];
     integer const i{res.first};
     Hermite3_D( res.second-m_X[i], m_X[i+1]-m_X[i], base_D );
-    real_type * v{vals};
-    for ( integer j = 0; j < m_dim; ++j, v += inc )
-      *v = base_D[0] * m_Y[j][i]   +
-           base_D[1] * m_Y[j][i+1] +
-           base_D[2] * m_Yp[j][i]  +
-           base_D[3] * m_Yp[j][i+1];
+    combine( i, base_D, vals, inc );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -386,12 +562,7 @@ namespace Splines {
     real_type base_DD[4];
     integer const i{res.first};
     Hermite3_DD( res.second-m_X[i], m_X[i+1]-m_X[i], base_DD );
-    real_type * v{vals};
-    for ( integer j = 0; j < m_dim; ++j, v += inc )
-      *v = base_DD[0] * m_Y[j][i]   +
-           base_DD[1] * m_Y[j][i+1] +
-           base_DD[2] * m_Yp[j][i]  +
-           base_DD[3] * m_Yp[j][i+1];
+    combine( i, base_DD, vals, inc );
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -407,12 +578,82 @@ namespace Splines {
     real_type base_DDD[4];
     integer const i{res.first};
     Hermite3_DDD( res.second-m_X[i], m_X[i+1]-m_X[i], base_DDD );
-    real_type * v{vals};
-    for ( integer j = 0; j < m_dim; ++j, v += inc )
-      *v = base_DDD[0] * m_Y[j][i]   +
-           base_DDD[1] * m_Y[j][i+1] +
-           base_DDD[2] * m_Yp[j][i]  +
-           base_DDD[3] * m_Yp[j][i+1];
+    combine( i, base_DDD, vals, inc );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVec::eval(
+    real_type const x[],
+    integer   const n,
+    real_type       out[],
+    integer   const ld
+  ) const {
+    UTILS_ASSERT(
+      ld >= m_dim,
+      "SplineVec[{}]::eval( x, n={}, out, ld={} ) ld must be >= dim = {}\n",
+      m_name, n, ld, m_dim
+    );
+    real_type base[4];
+    std::pair<integer,real_type> res(0,0);
+    for ( integer k{0}; k < n; ++k ) {
+      res.second = x[k];
+      m_search.find( res );
+      integer const i{res.first};
+      Hermite3( res.second-m_X[i], m_X[i+1]-m_X[i], base );
+      combine( i, base, out + k*ld, 1 );
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVec::eval_D(
+    real_type const x[],
+    integer   const n,
+    real_type       out[],
+    integer   const ld
+  ) const {
+    UTILS_ASSERT(
+      ld >= m_dim,
+      "SplineVec[{}]::eval_D( x, n={}, out, ld={} ) ld must be >= dim = {}\n",
+      m_name, n, ld, m_dim
+    );
+    real_type base_D[4];
+    std::pair<integer,real_type> res(0,0);
+    for ( integer k{0}; k < n; ++k ) {
+      res.second = x[k];
+      m_search.find( res );
+      integer const i{res.first};
+      Hermite3_D( res.second-m_X[i], m_X[i+1]-m_X[i], base_D );
+      combine( i, base_D, out + k*ld, 1 );
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVec::eval_DD(
+    real_type const x[],
+    integer   const n,
+    real_type       out[],
+    integer   const ld
+  ) const {
+    UTILS_ASSERT(
+      ld >= m_dim,
+      "SplineVec[{}]::eval_DD( x, n={}, out, ld={} ) ld must be >= dim = {}\n",
+      m_name, n, ld, m_dim
+    );
+    real_type base_DD[4];
+    std::pair<integer,real_type> res(0,0);
+    for ( integer k{0}; k < n; ++k ) {
+      res.second = x[k];
+      m_search.find( res );
+      integer const i{res.first};
+      Hermite3_DD( res.second-m_X[i], m_X[i+1]-m_X[i], base_DD );
+      combine( i, base_DD, out + k*ld, 1 );
+    }
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -492,6 +733,409 @@ namespace Splines {
            + 3 * x_1 * y_1 * ( t9 - t17 ) ) / ( t28 * t27 );
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  // 5 points Gauss-Legendre nodes and weights on [-1,1]
+  static real_type const GL5_x[5] = {
+    -0.906179845938663992797626878299,
+    -0.538469310105683091036314420700,
+     0,
+     0.538469310105683091036314420700,
+     0.906179845938663992797626878299
+  };
+  static real_type const GL5_w[5] = {
+    0.236926885056189087514264040720,
+    0.478628670499366468041291514836,
+    0.568888888888888888888888888889,
+    0.478628670499366468041291514836,
+    0.236926885056189087514264040720
+  };
+
+  real_type
+  SplineVec::id_speed( integer const i, real_type const x ) const {
+    real_type base_D[4];
+    Hermite3_D( x-m_X[i], m_X[i+1]-m_X[i], base_D );
+    real_type s2{0};
+    for ( integer j{0}; j < m_dim; ++j ) {
+      real_type const d{
+        base_D[0] * m_Y[j][i]   +
+        base_D[1] * m_Y[j][i+1] +
+        base_D[2] * m_Yp[j][i]  +
+        base_D[3] * m_Yp[j][i+1]
+      };
+      s2 += d*d;
+    }
+    return sqrt(s2);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  SplineVec::id_arc_length(
+    integer   const i,
+    real_type const a,
+    real_type const b
+  ) const {
+    auto GL5 = [this,i]( real_type aa, real_type bb ) -> real_type {
+      real_type const xm{ (aa+bb)/2 };
+      real_type const xr{ (bb-aa)/2 };
+      real_type res{0};
+      for ( integer k{0}; k < 5; ++k )
+        res += GL5_w[k] * id_speed( i, xm + xr*GL5_x[k] );
+      return xr*res;
+    };
+
+    // adaptive: an interval is halved until the rule on it and the sum
+    // on its halves agree, depth first with an explicit stack
+    struct Piece { real_type a, b, L; integer depth; };
+    constexpr integer max_depth{ 40 };
+    Piece stack[max_depth+2];
+    real_type const L0 { GL5( a, b ) };
+    real_type const tol{ 1e-13*abs(L0) };
+    integer top{0};
+    stack[top++] = { a, b, L0, 0 };
+    real_type res{0};
+    while ( top > 0 ) {
+      Piece const P{ stack[--top] };
+      real_type const m { (P.a+P.b)/2 };
+      real_type const Ll{ GL5( P.a, m ) };
+      real_type const Lr{ GL5( m, P.b ) };
+      if ( abs( Ll+Lr-P.L ) <= tol || P.depth >= max_depth ) {
+        res += Ll+Lr;
+      } else {
+        stack[top++] = { m,   P.b, Lr, P.depth+1 };
+        stack[top++] = { P.a, m,   Ll, P.depth+1 };
+      }
+    }
+    return res;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type const *
+  SplineVec::arc_table() const {
+    // lock only when the table must be rebuilt, as `SearchInterval::find`
+    if ( m_arc_generation.load( std::memory_order_acquire ) == m_search.generation() )
+      return m_arc_table.data();
+    std::lock_guard<std::mutex> lock(m_arc_mutex);
+    if ( m_arc_generation.load( std::memory_order_relaxed ) != m_search.generation() ) {
+      UTILS_ASSERT(
+        m_npts >= 2,
+        "SplineVec[{}]::arc_length, npts={} must be >= 2\n", m_name, m_npts
+      );
+      m_arc_table.resize( m_npts );
+      m_arc_table[0] = 0;
+      for ( integer i{1}; i < m_npts; ++i )
+        m_arc_table[i] = m_arc_table[i-1] + id_arc_length( i-1, m_X[i-1], m_X[i] );
+      m_arc_generation.store( m_search.generation(), std::memory_order_release );
+    }
+    return m_arc_table.data();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  SplineVec::find_param_at_length( real_type const * L, real_type s ) const {
+    integer   const n{ m_npts-1 };
+    real_type       x_offs{0};
+    if ( m_curve_is_closed ) {
+      real_type const k{ std::floor( s/L[n] ) };
+      s      -= k*L[n];
+      x_offs  = k*(m_X[n]-m_X[0]);
+    }
+
+    // segment containing `s`
+    integer i{ static_cast<integer>( std::upper_bound( L, L+n+1, s ) - L ) - 1 };
+    if      ( i < 0  ) i = 0;
+    else if ( i >= n ) i = n-1;
+
+    real_type a{ m_X[i] };
+    real_type b{ m_X[i+1] };
+    real_type const dL{ L[i+1]-L[i] };
+    real_type const ds{ s-L[i] };
+    bool const inside{ ds >= 0 && ds <= dL };
+
+    // linear guess, then Newton safeguarded by bisection when the
+    // target is inside the segment
+    real_type x{ dL > 0 ? a + (b-a)*(ds/dL) : a };
+    real_type const tol{ (b-a)*std::numeric_limits<real_type>::epsilon()*10 };
+    for ( integer iter{0}; iter < 50; ++iter ) {
+      real_type const f{ id_arc_length( i, m_X[i], x ) - ds };
+      if ( inside ) { if ( f > 0 ) b = x; else a = x; }
+      real_type const df{ id_speed( i, x ) };
+      real_type xn;
+      if ( df > 0 ) xn = x - f/df;
+      else          xn = (a+b)/2;
+      if ( inside && ( xn <= a || xn >= b ) ) xn = (a+b)/2;
+      bool const converged{ abs(xn-x) <= tol };
+      x = xn;
+      if ( converged ) break;
+    }
+    return x + x_offs;
+  }
+
+  #endif
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  SplineVec::arc_length( real_type const x ) const {
+    real_type const * L{ arc_table() };
+    integer   const   n{ m_npts-1 };
+    real_type         res{0};
+    real_type         xx{x};
+    if ( m_curve_is_closed ) {
+      real_type const k{ std::floor( (xx-m_X[0])/(m_X[n]-m_X[0]) ) };
+      xx  -= k*(m_X[n]-m_X[0]);
+      res  = k*L[n];
+    }
+    std::pair<integer,real_type> r(0,xx);
+    m_search.find( r );
+    integer const i{ r.first };
+    return res + L[i] + id_arc_length( i, m_X[i], r.second );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  SplineVec::length() const {
+    return arc_table()[m_npts-1];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  SplineVec::param_at_length( real_type const s ) const {
+    return find_param_at_length( arc_table(), s );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVec::eval_at_lengths(
+    real_type const s[],
+    integer   const n,
+    real_type       out[]
+  ) const {
+    real_type const * L{ arc_table() };
+    for ( integer k{0}; k < n; ++k )
+      eval( find_param_at_length( L, s[k] ), out + k*m_dim, 1 );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  integer
+  SplineVec::build_bvh( integer const lo, integer const hi ) const {
+    integer const k{ static_cast<integer>(m_bvh_range.size()/2) };
+    integer const d2{ 2*m_dim };
+    m_bvh_range.push_back( lo );
+    m_bvh_range.push_back( hi );
+    m_bvh_child.push_back( -1 );
+    m_bvh_child.push_back( -1 );
+    m_bvh_box.resize( m_bvh_box.size() + d2 );
+    if ( hi-lo == 1 ) {
+      // the segment is inside the hull of its Bezier control points
+      real_type const H{ m_X[lo+1]-m_X[lo] };
+      real_type * bmin{ m_bvh_box.data() + k*d2 };
+      real_type * bmax{ bmin + m_dim };
+      for ( integer j{0}; j < m_dim; ++j ) {
+        real_type const c0{ m_Y[j][lo] };
+        real_type const c3{ m_Y[j][lo+1] };
+        real_type const c1{ c0 + H*m_Yp[j][lo]/3 };
+        real_type const c2{ c3 - H*m_Yp[j][lo+1]/3 };
+        bmin[j] = std::min( std::min( c0, c1 ), std::min( c2, c3 ) );
+        bmax[j] = std::max( std::max( c0, c1 ), std::max( c2, c3 ) );
+      }
+    } else {
+      integer const mid{ lo + (hi-lo)/2 };
+      integer const L{ build_bvh( lo, mid ) };
+      integer const R{ build_bvh( mid, hi ) };
+      m_bvh_child[2*k+0] = L;
+      m_bvh_child[2*k+1] = R;
+      real_type       * bmin { m_bvh_box.data() + k*d2 };
+      real_type       * bmax { bmin + m_dim };
+      real_type const * Lmin { m_bvh_box.data() + L*d2 };
+      real_type const * Rmin { m_bvh_box.data() + R*d2 };
+      for ( integer j{0}; j < m_dim; ++j ) {
+        bmin[j] = std::min( Lmin[j], Rmin[j] );
+        bmax[j] = std::max( Lmin[j+m_dim], Rmin[j+m_dim] );
+      }
+    }
+    return k;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVec::build_bvh() const {
+    // lock only when the hierarchy must be rebuilt, as `SearchInterval::find`
+    if ( m_bvh_generation.load( std::memory_order_acquire ) == m_search.generation() ) return;
+    std::lock_guard<std::mutex> lock(m_bvh_mutex);
+    if ( m_bvh_generation.load( std::memory_order_relaxed ) != m_search.generation() ) {
+      UTILS_ASSERT(
+        m_npts >= 2,
+        "SplineVec[{}]::closest_point, npts={} must be >= 2\n", m_name, m_npts
+      );
+      m_bvh_range.clear(); m_bvh_range.reserve( 4*m_npts );
+      m_bvh_child.clear(); m_bvh_child.reserve( 4*m_npts );
+      m_bvh_box.clear();   m_bvh_box.reserve( 4*m_dim*m_npts );
+      build_bvh( 0, m_npts-1 );
+      m_bvh_generation.store( m_search.generation(), std::memory_order_release );
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  SplineVec::bvh_box_dist2( integer const node, real_type const p[] ) const {
+    real_type const * bmin{ m_bvh_box.data() + 2*m_dim*node };
+    real_type const * bmax{ bmin + m_dim };
+    real_type d2{0};
+    for ( integer j{0}; j < m_dim; ++j ) {
+      real_type d{0};
+      if      ( p[j] < bmin[j] ) d = bmin[j] - p[j];
+      else if ( p[j] > bmax[j] ) d = p[j] - bmax[j];
+      d2 += d*d;
+    }
+    return d2;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  SplineVec::id_closest_point(
+    integer   const i,
+    real_type const p[],
+    real_type     & x
+  ) const {
+    real_type const x0{ m_X[i] };
+    real_type const H { m_X[i+1]-x0 };
+
+    // `D(s) = C(x0+s*H)-p = a0 + a1*s + a2*s^2 + a3*s^3`, the squared
+    // distance is `f = D.D` and `g = D.D'` (degree 5) vanishes at its minima;
+    // `g' = D'.D' + D.D''` (degree 4) splits [0,1] in intervals where `g` is
+    // monotone, each holds at most one root of `g`
+    real_type f6[7]{0,0,0,0,0,0,0}; // coefficients of `f`
+    for ( integer j{0}; j < m_dim; ++j ) {
+      real_type const Y0{ m_Y[j][i] },    Y1{ m_Y[j][i+1] };
+      real_type const T0{ m_Yp[j][i]*H }, T1{ m_Yp[j][i+1]*H };
+      real_type const a[4]{ Y0 - p[j], T0, 3*(Y1-Y0) - 2*T0 - T1, 2*(Y0-Y1) + T0 + T1 };
+      for ( integer r{0}; r < 4; ++r )
+        for ( integer q{0}; q < 4; ++q )
+          f6[r+q] += a[r]*a[q];
+    }
+    auto f_eval = [this,i,p,H]( real_type s ) { // summing the squares, no cancellation
+      real_type f{0};
+      for ( integer j{0}; j < m_dim; ++j ) {
+        real_type const Y0{ m_Y[j][i] },    Y1{ m_Y[j][i+1] };
+        real_type const T0{ m_Yp[j][i]*H }, T1{ m_Yp[j][i+1]*H };
+        real_type const d{ Y0 - p[j] + s*(T0 + s*(3*(Y1-Y0) - 2*T0 - T1 + s*(2*(Y0-Y1) + T0 + T1))) };
+        f += d*d;
+      }
+      return f;
+    };
+    auto g_eval = [&f6]( real_type s ) { // f'/2
+      return (f6[1] + s*(2*f6[2] + s*(3*f6[3] + s*(4*f6[4] + s*(5*f6[5] + s*6*f6[6])))))/2;
+    };
+
+    // the ends, then the minima of `f` inside
+    real_type s_best{0};
+    real_type f_best{ f_eval(0) };
+    { real_type const f1{ f_eval(1) }; if ( f1 < f_best ) { f_best = f1; s_best = 1; } }
+
+    PolynomialRoots::Quartic q;
+    q.setup( 15*f6[6], 10*f6[5], 6*f6[4], 3*f6[3], f6[2] ); // f''/2
+    real_type brk[6];
+    integer nb{ q.getRootsInOpenRange( 0, 1, brk+1 ) };
+    std::sort( brk+1, brk+1+nb );
+    brk[0]    = 0;
+    brk[++nb] = 1;
+    for ( integer k{0}; k < nb; ++k ) {
+      // a minimum where `g` goes from negative to positive
+      real_type a{ brk[k] }, b{ brk[k+1] };
+      if ( !( g_eval(a) < 0 && g_eval(b) > 0 ) ) continue;
+      while ( true ) { // bisection to the last bit
+        real_type const m{ (a+b)/2 };
+        if ( m <= a || m >= b ) break;
+        if ( g_eval(m) < 0 ) a = m; else b = m;
+      }
+      for ( real_type const s : { a, b } ) {
+        real_type const f{ f_eval(s) };
+        if ( f < f_best ) { f_best = f; s_best = s; }
+      }
+    }
+    x = x0 + s_best*H;
+    return f_best;
+  }
+
+  #endif
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVec::closest_point(
+    real_type const p[],
+    real_type     & x,
+    real_type     & dist
+  ) const {
+    build_bvh();
+
+    real_type best{ std::numeric_limits<real_type>::infinity() };
+    x = m_X[0];
+
+    // depth first, nearest child first, pruning boxes farther than `best`;
+    // the tree is balanced, so the stack holds at most depth+1 nodes
+    constexpr integer max_stack{ 128 };
+    integer stack[max_stack];
+    integer top{0};
+    stack[top++] = 0;
+    while ( top > 0 ) {
+      UTILS_ASSERT(
+        top+2 <= max_stack,
+        "SplineVec[{}]::closest_point, BVH deeper than {}\n", m_name, max_stack-2
+      );
+      integer const k{ stack[--top] };
+      if ( bvh_box_dist2( k, p ) >= best ) continue;
+      integer const L{ m_bvh_child[2*k+0] };
+      integer const R{ m_bvh_child[2*k+1] };
+      if ( L < 0 ) {
+        real_type t;
+        real_type const d2{ id_closest_point( m_bvh_range[2*k], p, t ) };
+        if ( d2 < best ) { best = d2; x = t; }
+      } else if ( bvh_box_dist2( L, p ) <= bvh_box_dist2( R, p ) ) {
+        stack[top++] = R;
+        stack[top++] = L;
+      } else {
+        stack[top++] = L;
+        stack[top++] = R;
+      }
+    }
+    dist = sqrt(best);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVec::closest_point(
+    real_type const p[],
+    integer   const n,
+    integer   const ldp,
+    real_type       x[],
+    real_type       dist[]
+  ) const {
+    UTILS_ASSERT(
+      ldp >= m_dim,
+      "SplineVec[{}]::closest_point( p, n={}, ldp={}, x, dist ) ldp must be >= dim = {}\n",
+      m_name, n, ldp, m_dim
+    );
+    for ( integer k{0}; k < n; ++k )
+      closest_point( p + k*ldp, x[k], dist[k] );
+  }
+
   //!
   //! Evaluate at `x` and fill a GenericContainer
   //!
@@ -0,0 +1,516 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+using namespace std; // load standard namspace
+#endif
+
+namespace Splines {
+
+  /*\
+   |   ____        _ _          __     __    _
+   |  / ___| _ __ | (_)_ __   __\ \   / /__ | |
+   |  \___ \| '_ \| | | '_ \ / _ \ \ / / _ \| |
+   |   ___) | |_) | | | | | |  __/\ V / (_) | |
+   |  |____/| .__/|_|_|_| |_|\___| \_/ \___/|_|
+   |        |_|
+  \*/
+
+  SplineVol::SplineVol( string_view name )
+  : m_mem( fmt::format("SplineVol[{}]",name) )
+  , m_name( name )
+  {
+    m_search_x.setup( &m_name, &m_nx, &m_X, &m_x_closed, &m_x_can_extend );
+    m_search_y.setup( &m_name, &m_ny, &m_Y, &m_y_closed, &m_y_can_extend );
+    m_search_z.setup( &m_name, &m_nz, &m_Z, &m_z_closed, &m_z_can_extend );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  SplineVol::~SplineVol()
+  {}
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  string
+  SplineVol::info() const {
+    return fmt::format(
+      "Trivariate spline [{}] of type = {}, {} x {} x {} nodes",
+      name(), type_name(), m_nx, m_ny, m_nz
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVol::clear() {
+    m_mem.free();
+    m_nx = m_ny = m_nz = 0;
+    m_X = m_Y = m_Z = m_V = nullptr;
+    m_V_min = m_V_max = 0;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVol::build(
+    real_type const x[], integer const nx,
+    real_type const y[], integer const ny,
+    real_type const z[], integer const nz,
+    real_type const v[],
+    bool      const fortran_storage
+  ) {
+    UTILS_ASSERT(
+      nx >= 2 && ny >= 2 && nz >= 2,
+      "SplineVol[{}]::build, nx={}, ny={}, nz={} must be >= 2\n", m_name, nx, ny, nz
+    );
+    m_nx = nx;
+    m_ny = ny;
+    m_nz = nz;
+    size_t const nn{ size_t(nx)*size_t(ny)*size_t(nz) };
+    m_mem.reallocate( size_t(nx+ny+nz)+nn );
+    m_X = m_mem( nx );
+    m_Y = m_mem( ny );
+    m_Z = m_mem( nz );
+    m_V = m_mem( nn );
+    std::copy_n( x, nx, m_X );
+    std::copy_n( y, ny, m_Y );
+    std::copy_n( z, nz, m_Z );
+    if ( fortran_storage ) {
+      for ( integer i{0}; i < nx; ++i )
+        for ( integer j{0}; j < ny; ++j )
+          for ( integer k{0}; k < nz; ++k )
+            m_V[ipos_C(i,j,k)] = v[ size_t(i) + size_t(nx)*(size_t(j) + size_t(ny)*size_t(k)) ];
+    } else {
+      std::copy_n( v, nn, m_V );
+    }
+    m_V_min = *std::min_element( m_V, m_V+nn );
+    m_V_max = *std::max_element( m_V, m_V+nn );
+    m_search_x.must_reset();
+    m_search_y.must_reset();
+    m_search_z.must_reset();
+    make_spline();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVol::build(
+    vector<real_type> const & x,
+    vector<real_type> const & y,
+    vector<real_type> const & z,
+    vector<real_type> const & v,
+    bool              const   fortran_storage
+  ) {
+    integer const nx{ integer(x.size()) };
+    integer const ny{ integer(y.size()) };
+    integer const nz{ integer(z.size()) };
+    UTILS_ASSERT(
+      v.size() == size_t(nx)*size_t(ny)*size_t(nz),
+      "SplineVol[{}]::build, v.size() = {} expected {} x {} x {}\n",
+      m_name, v.size(), nx, ny, nz
+    );
+    build( x.data(), nx, y.data(), ny, z.data(), nz, v.data(), fortran_storage );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVol::find(
+    real_type & x, real_type & y, real_type & z,
+    integer   & i, integer   & j, integer   & k
+  ) const {
+    std::pair<integer,real_type> X(0,x), Y(0,y), Z(0,z);
+    m_search_x.find( X );
+    m_search_y.find( Y );
+    m_search_z.find( Z );
+    i = X.first; x = X.second;
+    j = Y.first; y = Y.second;
+    k = Z.first; z = Z.second;
+    // bounded axes clamp the query
+    if ( !m_x_can_extend ) x = std::max( m_X[0], std::min( m_X[m_nx-1], x ) );
+    if ( !m_y_can_extend ) y = std::max( m_Y[0], std::min( m_Y[m_ny-1], y ) );
+    if ( !m_z_can_extend ) z = std::max( m_Z[0], std::min( m_Z[m_nz-1], z ) );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVol::eval(
+    real_type const x[],
+    real_type const y[],
+    real_type const z[],
+    integer   const n,
+    real_type       v[]
+  ) const {
+    for ( integer p{0}; p < n; ++p ) v[p] = this->eval( x[p], y[p], z[p] );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineVol::D(
+    real_type const x[],
+    real_type const y[],
+    real_type const z[],
+    integer   const n,
+    real_type       v[],
+    real_type       grad[]
+  ) const {
+    for ( integer p{0}; p < n; ++p ) {
+      real_type d[4];
+      this->D( x[p], y[p], z[p], d );
+      v[p]        = d[0];
+      grad[3*p+0] = d[1];
+      grad[3*p+1] = d[2];
+      grad[3*p+2] = d[3];
+    }
+  }
+
+  /*\
+   |   _____     _ _ _
+   |  |_   _| __(_) (_)_ __   ___  __ _ _ __
+   |    | || '__| | | | '_ \ / _ \/ _` | '__|
+   |    | || |  | | | | | | |  __/ (_| | |
+   |    |_||_|  |_|_|_|_| |_|\___|\__,_|_|
+  \*/
+
+  real_type
+  TrilinearSpline::eval( real_type x, real_type y, real_type z ) const {
+    real_type d[4];
+    D( x, y, z, d );
+    return d[0];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  TrilinearSpline::D( real_type x, real_type y, real_type z, real_type d[4] ) const {
+    integer i, j, k;
+    find( x, y, z, i, j, k );
+    real_type const hx{ m_X[i+1]-m_X[i] };
+    real_type const hy{ m_Y[j+1]-m_Y[j] };
+    real_type const hz{ m_Z[k+1]-m_Z[k] };
+    real_type const u{ (x-m_X[i])/hx };
+    real_type const v{ (y-m_Y[j])/hy };
+    real_type const w{ (z-m_Z[k])/hz };
+
+    real_type const * V000{ m_V + ipos_C(i,j,k) };
+    real_type const * V100{ V000 + size_t(m_ny)*size_t(m_nz) };
+    real_type const c00{ V000[0]    + u*(V100[0]-V000[0]) };
+    real_type const c01{ V000[1]    + u*(V100[1]-V000[1]) };
+    real_type const c10{ V000[m_nz] + u*(V100[m_nz]-V000[m_nz]) };
+    real_type const c11{ V000[m_nz+1] + u*(V100[m_nz+1]-V000[m_nz+1]) };
+    real_type const c0{ c00 + v*(c10-c00) };
+    real_type const c1{ c01 + v*(c11-c01) };
+    d[0] = c0 + w*(c1-c0);
+
+    // x derivative: trilinear in (v,w) of the x differences
+    real_type const e00{ V100[0]-V000[0] };
+    real_type const e01{ V100[1]-V000[1] };
+    real_type const e10{ V100[m_nz]-V000[m_nz] };
+    real_type const e11{ V100[m_nz+1]-V000[m_nz+1] };
+    real_type const e0{ e00 + v*(e10-e00) };
+    real_type const e1{ e01 + v*(e11-e01) };
+    d[1] = ( e0 + w*(e1-e0) ) / hx;
+    d[2] = ( (c10-c00) + w*((c11-c01)-(c10-c00)) ) / hy;
+    d[3] = ( c1-c0 ) / hz;
+  }
+
+  /*\
+   |   _____     _  ____      _     _
+   |  |_   _| __(_)/ ___|   _| |__ (_) ___
+   |    | || '__| | |  | | | | '_ \| |/ __|
+   |    | || |  | | |__| |_| | |_) | | (__
+   |    |_||_|  |_|\____\__,_|_.__/|_|\___|
+  \*/
+
+  TriCubicSplineBase::TriCubicSplineBase( string_view name )
+  : SplineVol( name )
+  , m_mem_tricubic( fmt::format("TriCubicSplineBase[{}]",name) )
+  {}
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  TriCubicSplineBase::make_cells( Build1D build1d ) {
+    integer const nx{ m_nx }, ny{ m_ny }, nz{ m_nz };
+    size_t  const nn{ size_t(nx)*size_t(ny)*size_t(nz) };
+    integer const mm{ std::max( nx, std::max( ny, nz ) ) };
+
+    Malloc_real mem( fmt::format("TriCubicSplineBase[{}]::make_cells",m_name) );
+    mem.allocate( 8*nn + size_t(3*mm) );
+    real_type * DX   { mem( nn ) };
+    real_type * DY   { mem( nn ) };
+    real_type * DXY  { mem( nn ) };
+    real_type * DZ   { mem( nn ) };
+    real_type * DXZ  { mem( nn ) };
+    real_type * DYZ  { mem( nn ) };
+    real_type * DXYZ { mem( nn ) };
+    real_type * T    { mem( nn ) }; // scratch
+    real_type * L    { mem( mm ) };
+    real_type * Lp   { mem( mm ) };
+    real_type * work { mem( mm ) };
+
+    // apply build1d on all the lines along `axis` of `src`, result in `dst`
+    size_t  const stride[3]{ size_t(ny)*size_t(nz), size_t(nz), 1 };
+    integer const dim[3]{ nx, ny, nz };
+    real_type const * const nodes[3]{ m_X, m_Y, m_Z };
+    auto derive = [&]( integer axis, real_type const src[], real_type dst[] ) {
+      integer const a1{ (axis+1)%3 };
+      integer const a2{ (axis+2)%3 };
+      integer const n { dim[axis] };
+      size_t  const s { stride[axis] };
+      for ( integer p{0}; p < dim[a1]; ++p ) {
+        for ( integer q{0}; q < dim[a2]; ++q ) {
+          size_t const base{ size_t(p)*stride[a1] + size_t(q)*stride[a2] };
+          for ( integer l{0}; l < n; ++l ) L[l] = src[base+size_t(l)*s];
+          build1d( nodes[axis], L, Lp, work, n );
+          for ( integer l{0}; l < n; ++l ) dst[base+size_t(l)*s] = Lp[l];
+        }
+      }
+    };
+
+    auto minmod = [] ( real_type a, real_type b ) -> real_type {
+      if ( a*b <= 0 ) return 0;
+      if ( a > 0    ) return std::min(a,b);
+      return std::max(a,b);
+    };
+
+    // mixed derivative estimated in two ways and limited
+    auto mixed = [&]( integer a, real_type const Da[], integer b, real_type const Db[], real_type Dab[] ) {
+      derive( b, Da, Dab );
+      derive( a, Db, T );
+      for ( size_t l{0}; l < nn; ++l ) Dab[l] = minmod( Dab[l], T[l] );
+    };
+
+    derive( 0, m_V, DX );
+    derive( 1, m_V, DY );
+    derive( 2, m_V, DZ );
+    mixed( 0, DX, 1, DY, DXY );
+    mixed( 0, DX, 2, DZ, DXZ );
+    mixed( 1, DY, 2, DZ, DYZ );
+
+    // third mixed derivative: minmod of the three estimates
+    derive( 2, DXY, DXYZ );
+    derive( 1, DXZ, T );
+    for ( size_t l{0}; l < nn; ++l ) DXYZ[l] = minmod( DXYZ[l], T[l] );
+    derive( 0, DYZ, T );
+    for ( size_t l{0}; l < nn; ++l ) DXYZ[l] = minmod( DXYZ[l], T[l] );
+
+    // pack 64 coefficients per cell: index (a*4+b)*4+c with a,b,c the
+    // Hermite3 basis index [f(0),f(1),f'(0),f'(1)] along x,y,z
+    real_type const * const F[8]{ m_V, DX, DY, DXY, DZ, DXZ, DYZ, DXYZ };
+    size_t const ncoeffs{ 64*size_t(nx-1)*size_t(ny-1)*size_t(nz-1) };
+    m_mem_tricubic.reallocate( ncoeffs );
+    m_C = m_mem_tricubic( ncoeffs );
+    real_type * C{ m_C };
+    for ( integer i{0}; i < nx-1; ++i ) {
+      for ( integer j{0}; j < ny-1; ++j ) {
+        for ( integer k{0}; k < nz-1; ++k ) {
+          for ( integer a{0}; a < 4; ++a ) {
+            for ( integer b{0}; b < 4; ++b ) {
+              for ( integer c{0}; c < 4; ++c ) {
+                integer const mask{ (a>>1) | ((b>>1)<<1) | ((c>>1)<<2) };
+                size_t  const node{ ipos_C( i+(a&1), j+(b&1), k+(c&1) ) };
+                *C++ = F[mask][node];
+              }
+            }
+          }
+        }
+      }
+    }
+
+    for ( size_t l{0}; l < ncoeffs; ++l )
+      UTILS_ASSERT(
+        Utils::is_finite( m_C[l] ),
+        "TriCubicSplineBase[{}]::make_cells, coefficient {} is not finite\n", m_name, l
+      );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  TriCubicSplineBase::eval_cell(
+    integer   const i,
+    integer   const j,
+    integer   const k,
+    real_type const x,
+    real_type const y,
+    real_type const z,
+    real_type       d[4],
+    bool      const grad
+  ) const {
+    real_type const hx{ m_X[i+1]-m_X[i] };
+    real_type const hy{ m_Y[j+1]-m_Y[j] };
+    real_type const hz{ m_Z[k+1]-m_Z[k] };
+    real_type u[4], v[4], w[4];
+    Hermite3( x-m_X[i], hx, u );
+    Hermite3( y-m_Y[j], hy, v );
+    Hermite3( z-m_Z[k], hz, w );
+
+    real_type const * C{ block(i,j,k) };
+
+    if ( !grad ) {
+      real_type res{0};
+      for ( integer a{0}; a < 4; ++a ) {
+        real_type sa{0};
+        for ( integer b{0}; b < 4; ++b ) {
+          real_type const * Cab{ C + (a*4+b)*4 };
+          sa += v[b] * ( w[0]*Cab[0] + w[1]*Cab[1] + w[2]*Cab[2] + w[3]*Cab[3] );
+        }
+        res += u[a] * sa;
+      }
+      d[0] = res;
+      return;
+    }
+
+    real_type u_D[4], v_D[4], w_D[4];
+    Hermite3_D( x-m_X[i], hx, u_D );
+    Hermite3_D( y-m_Y[j], hy, v_D );
+    Hermite3_D( z-m_Z[k], hz, w_D );
+
+    real_type f{0}, fx{0}, fy{0}, fz{0};
+    for ( integer a{0}; a < 4; ++a ) {
+      real_type s{0}, s_y{0}, s_z{0};
+      for ( integer b{0}; b < 4; ++b ) {
+        real_type const * Cab{ C + (a*4+b)*4 };
+        real_type const t   { w[0]*Cab[0]   + w[1]*Cab[1]   + w[2]*Cab[2]   + w[3]*Cab[3]   };
+        real_type const t_z { w_D[0]*Cab[0] + w_D[1]*Cab[1] + w_D[2]*Cab[2] + w_D[3]*Cab[3] };
+        s   += v[b]   * t;
+        s_y += v_D[b] * t;
+        s_z += v[b]   * t_z;
+      }
+      f  += u[a]   * s;
+      fx += u_D[a] * s;
+      fy += u[a]   * s_y;
+      fz += u[a]   * s_z;
+    }
+    d[0] = f;
+    d[1] = fx;
+    d[2] = fy;
+    d[3] = fz;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  TriCubicSplineBase::eval( real_type x, real_type y, real_type z ) const {
+    integer i, j, k;
+    find( x, y, z, i, j, k );
+    real_type d[4];
+    eval_cell( i, j, k, x, y, z, d, false );
+    return d[0];
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  TriCubicSplineBase::D( real_type x, real_type y, real_type z, real_type d[4] ) const {
+    integer i, j, k;
+    find( x, y, z, i, j, k );
+    eval_cell( i, j, k, x, y, z, d, true );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  TriCubicSplineBase::eval(
+    real_type const x[],
+    real_type const y[],
+    real_type const z[],
+    integer   const n,
+    real_type       v[]
+  ) const {
+    for ( integer p{0}; p < n; ++p ) {
+      real_type xp{x[p]}, yp{y[p]}, zp{z[p]}, d[4];
+      integer i, j, k;
+      find( xp, yp, zp, i, j, k );
+      eval_cell( i, j, k, xp, yp, zp, d, false );
+      v[p] = d[0];
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  TriCubicSplineBase::D(
+    real_type const x[],
+    real_type const y[],
+    real_type const z[],
+    integer   const n,
+    real_type       v[],
+    real_type       grad[]
+  ) const {
+    for ( integer p{0}; p < n; ++p ) {
+      real_type xp{x[p]}, yp{y[p]}, zp{z[p]}, d[4];
+      integer i, j, k;
+      find( xp, yp, zp, i, j, k );
+      eval_cell( i, j, k, xp, yp, zp, d, true );
+      v[p]        = d[0];
+      grad[3*p+0] = d[1];
+      grad[3*p+1] = d[2];
+      grad[3*p+2] = d[3];
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  static
+  void
+  Pchip_build_1d(
+    real_type const X[],
+    real_type const Y[],
+    real_type       Yp[],
+    real_type       [],
+    integer         n
+  ) {
+    Pchip_build( X, Y, Yp, n );
+  }
+
+  #endif
+
+  void
+  TriCubicSpline::make_spline()
+  { make_cells( Pchip_build_1d ); }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Akima3Dspline::make_spline()
+  { make_cells( Akima_build ); }
+
+}
+
+// EOF: SplineVol.cc
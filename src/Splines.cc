@@ -27,7 +27,9 @@
 
 #include "SplinesUtils.hh"
 #include "Utils_fmt.hh"
+#include "PolynomialRoots.hh"
 
+#include <chrono>
 #include <cmath>
 #include <limits> // std::numeric_limits
 #include <set>
@@ -57,6 +59,18 @@ namespace Splines {
 
   using std::copy_n;
 
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  string
+  malloc_name( string_view cls, string_view member, string_view name ) {
+    if ( name.empty() ) return string( cls );
+    return fmt::format( "{}[{}]::{}", cls, name, member );
+  }
+
+  #endif
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   /*\
    |  ____                                _        _          _   _
    | |  _ \ __ _ _ __ __ _ _ __ ___   ___| |_ _ __(_)______ _| |_(_) ___  _ __
@@ -241,9 +255,12 @@ namespace Splines {
   void
   SearchInterval::find( std::pair<integer,real_type> & res ) const {
 
-    {
+    SPLINES_STATS_ADD( m_n_find, 1 );
+
+    // lock only when the table must be rebuilt
+    if ( m_must_reset.load( std::memory_order_acquire ) ) {
       std::lock_guard<std::mutex> lock(m_mutex);
-      if ( m_must_reset ) this->reset();
+      if ( m_must_reset.load( std::memory_order_relaxed ) ) this->reset();
     }
 
     integer   const & n    { *p_npts };
@@ -257,34 +274,50 @@ namespace Splines {
     #if 1
     // casi out of bound
     if ( x > m_x_max ) {
-      if ( *p_curve_is_closed ) { x -= m_x_range * std::floor( (x - m_x_min) / m_x_range ); }
-      else                      { pos = n-2; return; }
+      if ( *p_curve_is_closed ) { x -= m_x_range * std::floor( (x - m_x_min) / m_x_range ); SPLINES_STATS_ADD( m_n_wrap, 1 ); }
+      else                      { pos = n-2; SPLINES_STATS_ADD( m_n_clamp, 1 ); return; }
     } else if ( x < m_x_min ) {
-      if ( *p_curve_is_closed ) { x -= m_x_range * std::floor( (x - m_x_min) / m_x_range ); }
-      else                      { pos = 0; return; }
+      if ( *p_curve_is_closed ) { x -= m_x_range * std::floor( (x - m_x_min) / m_x_range ); SPLINES_STATS_ADD( m_n_wrap, 1 ); }
+      else                      { pos = 0; SPLINES_STATS_ADD( m_n_clamp, 1 ); return; }
+    } else if ( Utils::is_NaN(x) ) {
+      pos = 0; // any interval, the value is NaN
+      return;
     }
 
-    // uso table
-    integer i_cell { static_cast<integer>( std::floor( (x - m_x_min) / m_dx) ) };
-    integer k_LO   { m_LO[i_cell]   };
-    integer k_HI   { m_HI[i_cell+1] };
+    integer k_LO { 0   };
+    integer k_HI { n-1 };
+    if ( n > m_small_size ) {
+      // uso table
+      integer const * LO     { m_LO_HI_external != nullptr ? m_LO_HI_external : m_LO_HI.data() };
+      integer const * HI     { LO + m_table_size + 2 };
+      integer         i_cell { static_cast<integer>( std::floor( (x - m_x_min) / m_dx) ) };
+      k_LO = LO[i_cell];
+      k_HI = HI[i_cell+1];
 
-    UTILS_ASSERT(
-      x >= X[k_LO] && x <= X[k_HI],
-      "Spline::SearchInterval, x={}, ipos={}, dx={}, X[{}]={}, X[{}]={}, range=[{},{}]\n",
-      x, i_cell, m_dx, k_LO, X[k_LO], k_HI, X[k_HI], m_x_min, m_x_max
-    );
+      UTILS_ASSERT(
+        x >= X[k_LO] && x <= X[k_HI],
+        "Spline::SearchInterval, x={}, ipos={}, dx={}, X[{}]={}, X[{}]={}, range=[{},{}]\n",
+        x, i_cell, m_dx, k_LO, X[k_LO], k_HI, X[k_HI], m_x_min, m_x_max
+      );
+    }
     #else
     integer k_LO = 0;
     integer k_HI = n;
     #endif
 
     // binary search
+    #ifdef SPLINES_STATS
+    unsigned long long n_bisect{0};
+    #endif
     while ( k_HI > k_LO+1 ) {
       integer k_M{ k_LO + (k_HI-k_LO)/2 };
       if ( x < X[k_M] ) k_HI = k_M;
       else              k_LO = k_M;
+      #ifdef SPLINES_STATS
+      ++n_bisect;
+      #endif
     }
+    SPLINES_STATS_ADD( m_n_bisect, n_bisect );
 
     pos = k_LO;
     if ( Utils::is_zero(X[pos]-X[pos+1]) ) --pos; // caso nodi ripetuti
@@ -293,6 +326,10 @@ namespace Splines {
 
   void
   SearchInterval::reset() const {
+    #ifdef SPLINES_STATS
+    auto t0{ std::chrono::steady_clock::now() };
+    #endif
+
     integer           n{ *p_npts };
     real_type const * X{ *p_X    };
 
@@ -318,28 +355,115 @@ namespace Splines {
     //                                        +----------------+     [6..7]
     //                                        +--------------------+ [6..8]
     //
-    std::fill_n( m_LO, m_table_size+1, -1 );
-    std::fill_n( m_HI, m_table_size+1, -1 );
+    if ( n <= m_small_size ) {
+      // small spline, plain bisection in `find`
+      m_LO_HI.clear();
+      m_LO_HI.shrink_to_fit();
+      SPLINES_STATS_ADD( m_n_reset, 1 );
+      m_must_reset.store( false, std::memory_order_release );
+      return;
+    }
+
+    integer * LO{ m_LO_HI_external };
+    if ( LO == nullptr ) {
+      m_LO_HI.resize( static_cast<size_t>( 2*(m_table_size+2) ) );
+      LO = m_LO_HI.data();
+    }
+    integer * HI{ LO + m_table_size + 2 };
+
+    std::fill_n( LO, m_table_size+1, -1 );
+    std::fill_n( HI, m_table_size+1, -1 );
     for ( integer k{0}; k < n; ++k ) {
       real_type pos  { (X[k] - m_x_min) / m_dx };
       integer   i_LO { static_cast<integer>( std::ceil(pos+1e-6) )  };
-      m_LO[i_LO] = std::min(k,n-1);
+      LO[i_LO] = std::min(k,n-1);
     }
-    m_LO[0] = 0;
+    LO[0] = 0;
     for ( integer k{n-1}; k >= 0; --k ) {
       real_type pos  { (X[k] - m_x_min) / m_dx };
       integer   i_HI { static_cast<integer>( std::floor(pos-1e-6) ) };
       if ( i_HI < 0 ) i_HI = 0;
-      if ( m_HI[i_HI] == -1 ) m_HI[i_HI] = k;
+      if ( HI[i_HI] == -1 ) HI[i_HI] = k;
     }
-    m_HI[m_table_size] = n-1;
+    HI[m_table_size] = n-1;
+
+    for ( integer i{0};            i < m_table_size; ++i ) if ( LO[i+1] == -1 ) LO[i+1] = LO[i];
+    for ( integer i{m_table_size}; i > 0;            --i ) if ( HI[i-1] == -1 ) HI[i-1] = HI[i];
+    LO[m_table_size+1] = LO[m_table_size]; // replica ultimo nodo
+    HI[m_table_size+1] = HI[m_table_size]; // replica ultimo nodo
+
+    #ifdef SPLINES_STATS
+    SPLINES_STATS_ADD( m_n_reset, 1 );
+    SPLINES_STATS_ADD(
+      m_reset_ns,
+      std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - t0 ).count()
+    );
+    #endif
+    m_must_reset.store( false, std::memory_order_release );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SearchInterval::collect_stats( SplineStats & S ) const {
+    #ifdef SPLINES_STATS
+    S.find_calls      += m_n_find.load( std::memory_order_relaxed );
+    S.bisection_steps += m_n_bisect.load( std::memory_order_relaxed );
+    S.table_resets    += m_n_reset.load( std::memory_order_relaxed );
+    S.clamped         += m_n_clamp.load( std::memory_order_relaxed );
+    S.wrapped         += m_n_wrap.load( std::memory_order_relaxed );
+    S.reset_ms        += 1e-6*double(m_reset_ns.load( std::memory_order_relaxed ));
+    S.enabled          = true;
+    #else
+    (void) S;
+    #endif
+  }
+
+  void
+  SearchInterval::reset_stats() {
+    #ifdef SPLINES_STATS
+    m_n_find   = 0;
+    m_n_bisect = 0;
+    m_n_reset  = 0;
+    m_n_clamp  = 0;
+    m_n_wrap   = 0;
+    m_reset_ns = 0;
+    #endif
+  }
+
+  /*\
+   |   ____        _ _            ____  _        _
+   |  / ___| _ __ | (_)_ __   ___/ ___|| |_ __ _| |_ ___
+   |  \___ \| '_ \| | | '_ \ / _ \___ \| __/ _` | __/ __|
+   |   ___) | |_) | | | | | |  __/___) | || (_| | |_\__ \
+   |  |____/| .__/|_|_|_| |_|\___|____/ \__\__,_|\__|___/
+   |        |_|
+  \*/
 
-    for ( integer i{0};            i < m_table_size; ++i ) if ( m_LO[i+1] == -1 ) m_LO[i+1] = m_LO[i];
-    for ( integer i{m_table_size}; i > 0;            --i ) if ( m_HI[i-1] == -1 ) m_HI[i-1] = m_HI[i];
-    m_LO[m_table_size+1] = m_LO[m_table_size]; // replica ultimo nodo
-    m_HI[m_table_size+1] = m_HI[m_table_size]; // replica ultimo nodo
+  SplineStats &
+  SplineStats::operator += ( SplineStats const & S ) {
+    find_calls      += S.find_calls;
+    bisection_steps += S.bisection_steps;
+    table_resets    += S.table_resets;
+    clamped         += S.clamped;
+    wrapped         += S.wrapped;
+    reset_ms        += S.reset_ms;
+    copy_ms         += S.copy_ms;
+    coeffs_ms       += S.coeffs_ms;
+    enabled          = enabled || S.enabled;
+    return *this;
+  }
 
-    m_must_reset = false;
+  string
+  SplineStats::to_string() const {
+    if ( !enabled ) return "stats: not available (compile with SPLINES_STATS)";
+    return fmt::format(
+      "stats: find={} bisection_steps={} ({:.2f} per find) table_resets={} clamped={} wrapped={}\n"
+      "       reset={:.3f}ms build: copy={:.3f}ms coeffs={:.3f}ms",
+      find_calls, bisection_steps,
+      find_calls > 0 ? double(bisection_steps)/double(find_calls) : 0.0,
+      table_resets, clamped, wrapped, reset_ms, copy_ms, coeffs_ms
+    );
   }
 
   /*\
@@ -394,17 +518,47 @@ namespace Splines {
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  void
+  Spline::check_NaN(
+    real_type const v[],
+    integer   const n,
+    string_view     where,
+    string_view     what,
+    int       const line,
+    char      const file[]
+  ) const {
+    for ( integer i{0}; i < n; ++i ) {
+      if ( !std::isfinite(v[i]) ) {
+        Utils::check_NaN( v, fmt::format( "{}[{}]::build(): {}", where, m_name, what ), n, line, file );
+        return;
+      }
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   Spline::build(
     real_type const x[], integer const incx,
     real_type const y[], integer const incy,
     integer const n
   ) {
+    #ifdef SPLINES_STATS
+    using ms = std::chrono::duration<double,std::milli>;
+    auto t0{ std::chrono::steady_clock::now() };
+    #endif
     reserve( n );
     for ( integer i{0}; i < n; ++i ) m_X[i] = x[i*incx];
     for ( integer i{0}; i < n; ++i ) m_Y[i] = y[i*incy];
     m_npts = n;
+    #ifdef SPLINES_STATS
+    auto t1{ std::chrono::steady_clock::now() };
+    #endif
     build();
+    #ifdef SPLINES_STATS
+    m_build_copy_ms   = ms( t1 - t0 ).count();
+    m_build_coeffs_ms = ms( std::chrono::steady_clock::now() - t1 ).count();
+    #endif
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -426,11 +580,38 @@ namespace Splines {
         "\nx_min={:.5} x_max={:.5} y_min={:.5} y_max={:.5}",
         x_min(), x_max(), y_min(), y_max()
       );
+    #ifdef SPLINES_STATS
+    res += "\n" + stats().to_string();
+    #endif
     return res;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
+  SplineStats
+  Spline::stats() const {
+    SplineStats S;
+    m_search.collect_stats( S );
+    #ifdef SPLINES_STATS
+    S.copy_ms   = m_build_copy_ms;
+    S.coeffs_ms = m_build_coeffs_ms;
+    #endif
+    return S;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Spline::reset_stats() {
+    m_search.reset_stats();
+    #ifdef SPLINES_STATS
+    m_build_copy_ms   = 0;
+    m_build_coeffs_ms = 0;
+    #endif
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
   void
   Spline::push_back( real_type const x, real_type const y ) {
     if ( m_npts > 0 ) {
@@ -467,10 +648,11 @@ namespace Splines {
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
   void
-  Spline::set_origin( real_type const x0 ) const {
+  Spline::set_origin( real_type const x0 ) {
     real_type const Tx{x0 - m_X[0]};
     real_type * ix{m_X};
     while ( ix < m_X+m_npts ) *ix++ += Tx;
+    m_search.must_reset();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -484,6 +666,393 @@ namespace Splines {
     real_type const S  = (xmax - xmin) / ( m_X[m_npts-1] - m_X[0] );
     real_type const Tx = xmin - S * m_X[0];
     for( real_type *ix = m_X; ix < m_X+m_npts; ++ix ) *ix = *ix * S + Tx;
+    m_search.must_reset();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  Spline::id_integral( integer const ni, real_type const a, real_type const b ) const {
+    // 3 points Gauss-Legendre
+    real_type const xm{ (a+b)/2 };
+    real_type const xr{ (b-a)/2 };
+    real_type const dx{ xr*sqrt(0.6) };
+    return xr*( 5*id_eval( ni, xm-dx ) + 8*id_eval( ni, xm ) + 5*id_eval( ni, xm+dx ) )/9;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  real_type const *
+  Spline::integral_table() const {
+    // lock only when the table must be rebuilt, as `SearchInterval::find`
+    if ( m_integral_generation.load( std::memory_order_acquire ) == m_search.generation() )
+      return m_integral_table.data();
+    std::lock_guard<std::mutex> lock(m_integral_mutex);
+    if ( m_integral_generation.load( std::memory_order_relaxed ) != m_search.generation() ) {
+      UTILS_ASSERT(
+        m_npts >= 2,
+        "Spline[{}]::integral, npts={} must be >= 2\n", m_name, m_npts
+      );
+      m_integral_table.resize( m_npts );
+      real_type acc{0};
+      m_integral_table[0] = 0;
+      for ( integer i{1}; i < m_npts; ++i ) {
+        acc += id_integral( i-1, m_X[i-1], m_X[i] );
+        m_integral_table[i] = acc;
+      }
+      m_integral_generation.store( m_search.generation(), std::memory_order_release );
+    }
+    return m_integral_table.data();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  Spline::primitive( real_type const * T, real_type x ) const {
+    integer   const n  { m_npts-1 };
+    real_type const x0 { m_X[0] };
+    real_type const x1 { m_X[n] };
+    real_type       res{0};
+    if ( m_curve_is_closed ) {
+      // whole periods are accumulated, then `x` is wrapped in the domain
+      real_type const k{ std::floor( (x-x0)/(x1-x0) ) };
+      x   -= k*(x1-x0);
+      res  = k*T[n];
+    } else if ( m_curve_can_extend && m_curve_extended_constant ) {
+      if ( x <= x0 ) return (x-x0)*id_eval( 0, x0 );
+      if ( x >= x1 ) return T[n]+(x-x1)*id_eval( n-1, x1 );
+    }
+    std::pair<integer,real_type> r(0,x);
+    m_search.find( r );
+    integer const i{ r.first };
+    return res + T[i] + id_integral( i, m_X[i], r.second );
+  }
+
+  #endif
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  Spline::integral( real_type const a, real_type const b ) const {
+    real_type const * T{ integral_table() };
+    return primitive( T, b ) - primitive( T, a );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Spline::integral(
+    real_type const a[],
+    real_type const b[],
+    real_type       out[],
+    integer   const n
+  ) const {
+    real_type const * T{ integral_table() };
+    for ( integer k{0}; k < n; ++k )
+      out[k] = primitive( T, b[k] ) - primitive( T, a[k] );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Spline::id_y_min_max(
+    integer   const ni,
+    real_type const a,
+    real_type const b,
+    real_type     & x_min_pos,
+    real_type     & y_min,
+    real_type     & x_max_pos,
+    real_type     & y_max
+  ) const {
+    real_type const ya{ id_eval( ni, a ) };
+    real_type const yb{ id_eval( ni, b ) };
+    if ( ya <= yb ) { x_min_pos = a; y_min = ya; x_max_pos = b; y_max = yb; }
+    else            { x_min_pos = b; y_min = yb; x_max_pos = a; y_max = ya; }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  void
+  Spline::build_minmax_tree() const {
+    // lock only when the tree must be rebuilt, as `SearchInterval::find`
+    if ( m_minmax_generation.load( std::memory_order_acquire ) == m_search.generation() ) return;
+    std::lock_guard<std::mutex> lock(m_minmax_mutex);
+    if ( m_minmax_generation.load( std::memory_order_relaxed ) == m_search.generation() ) return;
+
+    UTILS_ASSERT(
+      m_npts >= 2,
+      "Spline[{}]::y_min_max, npts={} must be >= 2\n", m_name, m_npts
+    );
+
+    integer const nseg{ m_npts-1 };
+    m_minmax_segment.resize( 4*nseg );
+    real_type * S{ m_minmax_segment.data() };
+    for ( integer i{0}; i < nseg; ++i, S += 4 )
+      id_y_min_max( i, m_X[i], m_X[i+1], S[0], S[1], S[2], S[3] );
+
+    // bottom-up segment trees, leafs in `[nseg,2*nseg)`
+    m_minmax_tree.resize( 4*nseg );
+    integer         * Tmin { m_minmax_tree.data() };
+    integer         * Tmax { Tmin + 2*nseg };
+    real_type const * SS   { m_minmax_segment.data() };
+    for ( integer i{0}; i < nseg; ++i ) Tmin[nseg+i] = Tmax[nseg+i] = i;
+    for ( integer k{nseg-1}; k > 0; --k ) {
+      integer const L{ 2*k }, R{ 2*k+1 };
+      Tmin[k] = SS[4*Tmin[L]+1] <= SS[4*Tmin[R]+1] ? Tmin[L] : Tmin[R];
+      Tmax[k] = SS[4*Tmax[L]+3] >= SS[4*Tmax[R]+3] ? Tmax[L] : Tmax[R];
+    }
+    m_minmax_generation.store( m_search.generation(), std::memory_order_release );
+  }
+
+  #endif
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Spline::y_min_max(
+    real_type   a,
+    real_type   b,
+    integer   & i_min_pos,
+    real_type & x_min_pos,
+    real_type & y_min,
+    integer   & i_max_pos,
+    real_type & x_max_pos,
+    real_type & y_max
+  ) const {
+    build_minmax_tree();
+
+    integer const nseg{ m_npts-1 };
+    if ( a > b ) std::swap( a, b );
+    a = max( a, m_X[0] ); a = min( a, m_X[nseg] );
+    b = max( b, m_X[0] ); b = min( b, m_X[nseg] );
+
+    std::pair<integer,real_type> ra(0,a), rb(0,b);
+    m_search.find( ra );
+    m_search.find( rb );
+    integer const ia{ ra.first };
+    integer const ib{ rb.first };
+
+    auto update = [&]( integer i, real_type xmi, real_type ymi, real_type xma, real_type yma ) {
+      if ( ymi < y_min ) { y_min = ymi; x_min_pos = xmi; i_min_pos = i; }
+      if ( yma > y_max ) { y_max = yma; x_max_pos = xma; i_max_pos = i; }
+    };
+
+    // partial segments
+    id_y_min_max( ia, a, ia == ib ? b : m_X[ia+1], x_min_pos, y_min, x_max_pos, y_max );
+    i_min_pos = i_max_pos = ia;
+    if ( ib > ia ) {
+      real_type xmi, ymi, xma, yma;
+      id_y_min_max( ib, m_X[ib], b, xmi, ymi, xma, yma );
+      update( ib, xmi, ymi, xma, yma );
+    }
+
+    // whole segments `ia+1..ib-1` from the trees
+    integer   const * Tmin { m_minmax_tree.data() };
+    integer   const * Tmax { Tmin + 2*nseg };
+    real_type const * S    { m_minmax_segment.data() };
+    auto take = [&]( integer imi, integer ima ) {
+      real_type const * Smi{ S + 4*imi };
+      real_type const * Sma{ S + 4*ima };
+      if ( Smi[1] < y_min ) { y_min = Smi[1]; x_min_pos = Smi[0]; i_min_pos = imi; }
+      if ( Sma[3] > y_max ) { y_max = Sma[3]; x_max_pos = Sma[2]; i_max_pos = ima; }
+    };
+    integer l{ ia+1+nseg };
+    integer r{ ib+nseg };
+    while ( l < r ) {
+      if ( (l&1) != 0 ) { take( Tmin[l], Tmax[l] ); ++l; }
+      if ( (r&1) != 0 ) { --r; take( Tmin[r], Tmax[r] ); }
+      l >>= 1;
+      r >>= 1;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  // max number of cells of the table used by `inverse`
+  static integer const inverse_table_size{ 4096 };
+
+  void
+  Spline::build_inverse_table() const {
+    // lock only when the table must be rebuilt, as `SearchInterval::find`
+    if ( m_inverse_generation.load( std::memory_order_acquire ) == m_search.generation() ) return;
+    std::lock_guard<std::mutex> lock(m_inverse_mutex);
+    if ( m_inverse_generation.load( std::memory_order_relaxed ) == m_search.generation() ) return;
+
+    UTILS_ASSERT(
+      m_npts >= 2,
+      "Spline[{}]::inverse, npts={} must be >= 2\n", m_name, m_npts
+    );
+    UTILS_ASSERT(
+      type() != SplineType1D::CONSTANT,
+      "Spline[{}]::inverse, a {} spline cannot be inverted\n", m_name, type_name()
+    );
+    integer   const nseg{ m_npts-1 };
+    real_type const dy  { m_Y[nseg]-m_Y[0] };
+    UTILS_ASSERT(
+      dy != 0,
+      "Spline[{}]::inverse, y[0] = y[{}] = {}, cannot be inverted\n", m_name, nseg, m_Y[0]
+    );
+    integer const sign{ dy > 0 ? 1 : -1 };
+    for ( integer k{0}; k < nseg; ++k )
+      UTILS_ASSERT(
+        sign*(m_Y[k+1]-m_Y[k]) >= 0,
+        "Spline[{}]::inverse, node values not monotone, y[{}] = {}, y[{}] = {}\n",
+        m_name, k, m_Y[k], k+1, m_Y[k+1]
+      );
+
+    integer   const nc { std::min( nseg, inverse_table_size ) };
+    real_type const v0 { sign*m_Y[0] };
+    real_type const rng{ std::abs(dy) };
+    m_inverse_table.resize( nc+1 );
+    integer k{0};
+    for ( integer c{0}; c <= nc; ++c ) {
+      real_type const vc{ v0 + (rng*c)/nc };
+      while ( k < nseg-1 && sign*m_Y[k+1] <= vc ) ++k;
+      m_inverse_table[c] = k;
+    }
+    m_inverse_sign       = sign;
+    m_inverse_v0         = v0;
+    m_inverse_inv_dv     = nc/rng;
+    m_inverse_generation.store( m_search.generation(), std::memory_order_release );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  // last segment `k` with `sign*y[k] <= v`, `v` in the range of the values
+  integer
+  Spline::inverse_segment( real_type v ) const {
+    integer   const nseg{ m_npts-1 };
+    integer   const nc  { integer(m_inverse_table.size())-1 };
+    real_type const s   { real_type(m_inverse_sign) };
+    integer   const c   {
+      std::clamp( static_cast<integer>( (v-m_inverse_v0)*m_inverse_inv_dv ), integer(0), nc-1 )
+    };
+    integer lo{ m_inverse_table[c]   };
+    integer hi{ m_inverse_table[c+1] };
+    while ( hi > lo ) {
+      integer const m{ lo + (hi-lo+1)/2 };
+      if ( s*m_Y[m] <= v ) lo = m;
+      else                 hi = m-1;
+    }
+    // rounding of the cell boundaries
+    while ( lo > 0 && s*m_Y[lo] > v ) --lo;
+    while ( lo < nseg-1 && s*m_Y[lo+1] <= v ) ++lo;
+    return lo;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  real_type
+  Spline::inverse_solve( integer ni, real_type y ) const {
+    real_type const a { m_X[ni]   };
+    real_type const b { m_X[ni+1] };
+    real_type const ya{ m_Y[ni]   };
+    real_type const yb{ m_Y[ni+1] };
+    if ( y == ya ) return a;
+    if ( y == yb ) return b;
+
+    real_type const h { b-a };
+    real_type const dy{ yb-ya };
+    real_type       x { a + h*(y-ya)/dy };
+
+    SplineType1D const t{ type() };
+    if ( t == SplineType1D::LINEAR ) return x;
+    if ( t != SplineType1D::QUINTIC ) {
+      // root of the cubic Hermite segment as `SplineSet::intersect`
+      real_type const * Yp { static_cast<CubicSplineBase const *>(this)->yp_nodes() };
+      real_type const   d0 { Yp[ni]   };
+      real_type const   d1 { Yp[ni+1] };
+      PolynomialRoots::Cubic const cubic(
+        (d1+d0-2*dy/h)/(h*h),
+        (3*dy/h-2*d0-d1)/h,
+        d0,
+        ya-y
+      );
+      real_type r[3];
+      integer const npr{ cubic.getRealRoots( r ) };
+      for ( integer i{0}; i < npr; ++i )
+        if ( r[i] >= 0 && r[i] <= h ) { x = a + r[i]; break; }
+    }
+
+    // Newton safeguarded by bisection on `g = sign*(eval(x)-y)`, `g(a) < 0 < g(b)`
+    real_type const s  { dy > 0 ? real_type(1) : real_type(-1) };
+    real_type const tol{ 4*std::numeric_limits<real_type>::epsilon()*max( abs(a), abs(b) ) };
+    real_type lo{ a };
+    real_type hi{ b };
+    for ( integer it{0}; it < 100; ++it ) {
+      real_type const g{ s*(id_eval( ni, x )-y) };
+      if ( g == 0 ) break;
+      if ( g < 0 ) lo = x;
+      else         hi = x;
+      real_type const dg{ s*id_D( ni, x ) };
+      real_type xn{ dg > 0 ? x - g/dg : (lo+hi)/2 };
+      if ( !(xn > lo && xn < hi) ) xn = (lo+hi)/2;
+      bool const done{ abs(xn-x) <= tol || hi-lo <= tol };
+      x = xn;
+      if ( done ) break;
+    }
+    return x;
+  }
+
+  #endif
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  bool
+  Spline::inverse( real_type const y, real_type & x ) const {
+    build_inverse_table();
+    integer   const nseg{ m_npts-1 };
+    real_type const s   { real_type(m_inverse_sign) };
+    real_type const v   { s*y };
+    if ( std::isnan(y) )   { x = y;           return false; }
+    if ( v < s*m_Y[0] )    { x = m_X[0];      return false; }
+    if ( v > s*m_Y[nseg] ) { x = m_X[nseg];   return false; }
+    x = inverse_solve( inverse_segment( v ), y );
+    return true;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  integer
+  Spline::inverse(
+    real_type const y[],
+    real_type       x[],
+    integer   const n
+  ) const {
+    build_inverse_table();
+    integer   const nseg{ m_npts-1 };
+    real_type const s   { real_type(m_inverse_sign) };
+    real_type const v0  { s*m_Y[0] };
+    real_type const v1  { s*m_Y[nseg] };
+
+    integer   nout{0};
+    integer   k{0}; // last segment with `sign*y[k] <= v_prev`
+    real_type v_prev{ -std::numeric_limits<real_type>::infinity() };
+    for ( integer i{0}; i < n; ++i ) {
+      real_type const v{ s*y[i] };
+      if ( !(v >= v0 && v <= v1) ) {
+        x[i] = std::isnan(y[i]) ? y[i] : ( v < v0 ? m_X[0] : m_X[nseg] );
+        ++nout;
+        continue;
+      }
+      if ( v >= v_prev ) {
+        // sorted values: short forward sweep, the table for long jumps
+        integer steps{0};
+        while ( k < nseg-1 && s*m_Y[k+1] <= v && steps < 8 ) { ++k; ++steps; }
+        if ( k < nseg-1 && s*m_Y[k+1] <= v ) k = inverse_segment( v );
+      } else {
+        k = inverse_segment( v );
+      }
+      v_prev = v;
+      x[i]   = inverse_solve( k, y[i] );
+    }
+    return nout;
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
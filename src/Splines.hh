@@ -36,6 +36,15 @@
 
 #include "SplinesConfig.hh"
 #include <fstream>
+#include <memory_resource>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <variant>
 
 //!
 //! Namespace of Splines library
@@ -64,6 +73,12 @@ namespace Splines {
   using istream_type = basic_istream<char>;
 
   void backtrace( ostream_type & );
+
+  // name `<cls>[<name>]::<member>` of the memory block `member` of the
+  // spline `name` of class `cls`; just `<cls>` when `name` is empty, with
+  // `cls` a literal of at most 15 chars it fits the small string buffer
+  // (also of the copy kept by `Malloc`) and no memory is allocated
+  string malloc_name( string_view cls, string_view member, string_view name );
   #endif
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -371,9 +386,44 @@ namespace Splines {
   //! Manage Search intervals
   //!
   #ifndef DOXYGEN_SHOULD_SKIP_THIS
+  //!
+  //! Counters of the interval search and timings of the build.
+  //! Collected only when the library is compiled with `SPLINES_STATS`,
+  //! otherwise all the fields are zero and `enabled` is `false`.
+  //!
+  struct SplineStats {
+    unsigned long long find_calls{0};      //!< calls of the interval search
+    unsigned long long bisection_steps{0}; //!< iterations of the binary search
+    unsigned long long table_resets{0};    //!< rebuilds of the lookup table
+    unsigned long long clamped{0};         //!< queries outside the range (not closed)
+    unsigned long long wrapped{0};         //!< queries outside the range wrapped (closed)
+    double             reset_ms{0};        //!< total time spent rebuilding the lookup table
+    double             copy_ms{0};         //!< last build: time to store the data
+    double             coeffs_ms{0};       //!< last build: time to compute the coefficients
+    bool               enabled{false};     //!< `true` if compiled with `SPLINES_STATS`
+
+    //! accumulate the counters and timings of `S`
+    SplineStats & operator += ( SplineStats const & S );
+
+    //! human readable dump
+    string to_string() const;
+  };
+
   class SearchInterval {
 
     static integer const m_table_size{ 400 };
+    static integer const m_small_size{ 32 }; // up to this size plain bisection, no table
+
+    // counters of the search, only when compiled with `SPLINES_STATS`
+    // (exported by the library target, so users see the same layout)
+    #ifdef SPLINES_STATS
+    mutable std::atomic<unsigned long long> m_n_find{0};
+    mutable std::atomic<unsigned long long> m_n_bisect{0};
+    mutable std::atomic<unsigned long long> m_n_reset{0};
+    mutable std::atomic<unsigned long long> m_n_clamp{0};
+    mutable std::atomic<unsigned long long> m_n_wrap{0};
+    mutable std::atomic<long long>          m_reset_ns{0};
+    #endif
 
     string const * p_name{nullptr};
     integer      * p_npts{nullptr};
@@ -385,10 +435,14 @@ namespace Splines {
     mutable real_type    m_x_max{0};
     mutable real_type    m_x_range{0};
     mutable real_type    m_dx{0};
-    mutable integer      m_LO[m_table_size+2]; // to avoid overflow and replicate last point
-    mutable integer      m_HI[m_table_size+2]; // to avoid overflow and replicate last point
-    mutable bool         m_must_reset{ true };
+    // `LO` then `HI` tables, `m_table_size+2` each (to avoid overflow and replicate
+    // last point), allocated only for splines with more than `m_small_size` points
+    // or provided by the owner (`set_external_table`)
+    mutable vector<integer> m_LO_HI;
+    integer *               m_LO_HI_external{nullptr};
+    mutable std::atomic<bool> m_must_reset{ true }; // checked without lock in `find`
     mutable std::mutex   m_mutex;
+    unsigned long        m_generation{ 1 };
     void reset() const;
 
   public:
@@ -406,6 +460,7 @@ namespace Splines {
       p_curve_is_closed  = is_closed;
       p_curve_can_extend = can_extend;
       m_must_reset       = true;
+      ++m_generation;
     }
 
     //!
@@ -413,7 +468,62 @@ namespace Splines {
     //! Return result in `res.first` 
     //!
     void find( std::pair<integer,real_type> & res ) const;
-    void must_reset() { m_must_reset = true; }
+    void must_reset() { m_must_reset = true; ++m_generation; }
+
+    //!
+    //! Number of `integer` of the lookup table for `npts` points
+    //! (`0` if the search uses plain bisection).
+    //!
+    static integer
+    table_size( integer npts )
+    { return npts > m_small_size ? 2*(m_table_size+2) : 0; }
+
+    //!
+    //! Use `T` (`table_size(npts)` entries, owned by the caller) for the
+    //! lookup table instead of allocating it.
+    //!
+    void set_external_table( integer * T ) { m_LO_HI_external = T; m_LO_HI.clear(); m_LO_HI.shrink_to_fit(); }
+
+    //!
+    //! Counter incremented at each `must_reset`, used by the owner
+    //! to invalidate lazily built tables (never `0`).
+    //!
+    unsigned long generation() const { return m_generation; }
+
+    //!
+    //! Add the search counters to `S` (nothing without `SPLINES_STATS`).
+    //!
+    void collect_stats( SplineStats & S ) const;
+
+    //!
+    //! Zero the search counters.
+    //!
+    void reset_stats();
+  };
+  #endif
+
+  //!
+  //! Read only view of a binary file, memory mapped when possible.
+  //! Splines loaded from binary files borrow their storage from it.
+  //!
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+  class MappedFile {
+    string            m_file_name;
+    char *            m_data{nullptr};
+    size_t            m_size{0};
+    bool              m_mapped{false};
+    vector<real_type> m_buffer; // used when the file is not mapped
+  public:
+    MappedFile( MappedFile const & ) = delete;
+    MappedFile const & operator = ( MappedFile const & ) = delete;
+
+    MappedFile( string_view file_name, bool use_mmap );
+    ~MappedFile();
+
+    char         * data()      const { return m_data; }
+    size_t         size()      const { return m_size; }
+    bool           is_mapped() const { return m_mapped; }
+    string const & file_name() const { return m_file_name; }
   };
   #endif
 
@@ -430,6 +540,7 @@ namespace Splines {
   //!
   class Spline {
     friend class SplineSet;
+    friend class SplineArena;
   protected:
 
     string const m_name;
@@ -444,13 +555,63 @@ namespace Splines {
 
     SearchInterval m_search;
 
+    // timings of the last `build` (only with `SPLINES_STATS`)
+    #ifdef SPLINES_STATS
+    double m_build_copy_ms{0};
+    double m_build_coeffs_ms{0};
+    #endif
+
+    // lazy table of the integrals from `m_X[0]` to `m_X[i]`
+    mutable vector<real_type>          m_integral_table;
+    mutable std::atomic<unsigned long> m_integral_generation{0}; // checked without lock
+    mutable std::mutex                 m_integral_mutex;
+
+    real_type const * integral_table() const;
+    real_type primitive( real_type const * T, real_type x ) const;
+
+    // lazy tables for range min/max: extrema `[x_min,y_min,x_max,y_max]`
+    // of each segment and two segment trees (min then max) of segment indices
+    mutable vector<real_type>          m_minmax_segment;
+    mutable vector<integer>            m_minmax_tree;
+    mutable std::atomic<unsigned long> m_minmax_generation{0}; // checked without lock
+    mutable std::mutex                 m_minmax_mutex;
+
+    void build_minmax_tree() const;
+
+    // lazy table for `inverse`: monotony of the node values (`+1`/`-1`) and,
+    // for each cell of a uniform grid on `sign*y`, the last segment starting
+    // at or below the cell (the segments of a value are in `[T[c],T[c+1]]`)
+    mutable vector<integer>            m_inverse_table;
+    mutable integer                    m_inverse_sign{0};
+    mutable real_type                  m_inverse_v0{0};
+    mutable real_type                  m_inverse_inv_dv{0};
+    mutable std::atomic<unsigned long> m_inverse_generation{0}; // checked without lock
+    mutable std::mutex                 m_inverse_mutex;
+
+    void      build_inverse_table() const;
+    integer   inverse_segment( real_type v ) const;
+    real_type inverse_solve( integer ni, real_type y ) const;
+
   protected:
 
+    // as `Utils::check_NaN`, the message "`where`[name]::build(): `what`"
+    // is formatted only when a non finite value is found (no allocation otherwise)
+    void
+    check_NaN(
+      real_type const v[],
+      integer         n,
+      string_view     where,
+      string_view     what,
+      int             line,
+      char const      file[]
+    ) const;
+
     void
     copy_flags( Spline const & S ) {
       m_curve_is_closed         = S.m_curve_is_closed;
       m_curve_can_extend        = S.m_curve_can_extend;
       m_curve_extended_constant = S.m_curve_extended_constant;
+      m_search.must_reset();
     }
 
   public:
@@ -495,13 +656,13 @@ namespace Splines {
     //! When evaluated if parameter is outside the domain
     //! is wrapped cyclically before evalation.
     //!
-    void make_closed() { m_curve_is_closed = true;  }
+    void make_closed() { m_curve_is_closed = true;  m_search.must_reset(); }
     //!
     //! Set spline as an opened spline.
     //! When evaluated if parameter is outside the domain
     //! an error is produced.
     //!
-    void make_opened() { m_curve_is_closed = false; }
+    void make_opened() { m_curve_is_closed = false; m_search.must_reset(); }
 
     //!
     //! \return `true` if spline cannot extend outside interval of definition
@@ -512,13 +673,13 @@ namespace Splines {
     //! When evaluated if parameter is outside the domain
     //! an extrapolated value is used.
     //!
-    void make_unbounded() { m_curve_can_extend = true;  }
+    void make_unbounded() { m_curve_can_extend = true;  m_search.must_reset(); }
     //!
     //! Set spline as bounded.
     //! When evaluated if parameter is outside the domain
     //! an error is issued.
     //!
-    void make_bounded() { m_curve_can_extend = false; }
+    void make_bounded() { m_curve_can_extend = false; m_search.must_reset(); }
 
     //!
     //! \return `true` if the spline extend with a constant value
@@ -529,13 +690,13 @@ namespace Splines {
     //! When evaluated if parameter is outside the domain
     //! the value returned is the value of the closed border.
     //!
-    void make_extended_constant()     { m_curve_extended_constant = true;  }
+    void make_extended_constant()     { m_curve_extended_constant = true;  m_search.must_reset(); }
     //!
     //! Set spline to extend NOT constant.
     //! When evaluated if parameter is outside the domain
     //! teh value returned is extrapolated using the last spline polynomial.
     //!
-    void make_extended_not_constant() { m_curve_extended_constant = false; }
+    void make_extended_not_constant() { m_curve_extended_constant = false; m_search.must_reset(); }
 
     ///@}
 
@@ -666,6 +827,34 @@ namespace Splines {
       vector<real_type> & y_max
     ) const;
 
+    //!
+    //! Search the max and min values of `y` along the spline
+    //! restricted to `[a,b]` (clipped to the spline domain).
+    //! The extrema of each segment are computed once and stored
+    //! in a segment tree, so that a query cost `O(log n)` plus
+    //! the search of the extrema on the two partial segments.
+    //!
+    //! \param[in]  a         left border of the range
+    //! \param[in]  b         right border of the range
+    //! \param[out] i_min_pos segment where is the minimum
+    //! \param[out] x_min_pos where is the minimum
+    //! \param[out] y_min     the minimum value
+    //! \param[out] i_max_pos segment where is the maximum
+    //! \param[out] x_max_pos where is the maximum
+    //! \param[out] y_max     the maximum value
+    //!
+    void
+    y_min_max(
+      real_type   a,
+      real_type   b,
+      integer   & i_min_pos,
+      real_type & x_min_pos,
+      real_type & y_min,
+      integer   & i_max_pos,
+      real_type & x_max_pos,
+      real_type & y_max
+    ) const;
+
     ///@}
 
     //! \name Build
@@ -789,7 +978,7 @@ namespace Splines {
     //!
     //! change X-origin of the spline
     //!
-    void set_origin( real_type const x0 ) const;
+    void set_origin( real_type const x0 );
 
     //!
     //! change X-range of the spline
@@ -937,6 +1126,95 @@ namespace Splines {
     //!
     virtual real_type id_DDDDD( integer const, real_type const) const { return real_type(0); }
 
+    //!
+    //! Integral of the polynomial of segment `ni` from `a` to `b`.
+    //! The default implementation uses 3 points Gauss-Legendre
+    //! quadrature, exact up to degree 5.
+    //!
+    virtual
+    real_type
+    id_integral( integer const ni, real_type const a, real_type const b ) const;
+
+    //!
+    //! Minimum and maximum of the polynomial of segment `ni` on `[a,b]`.
+    //! The default implementation checks only `a` and `b`, which is enough
+    //! for piecewise linear splines.
+    //!
+    virtual
+    void
+    id_y_min_max(
+      integer   const ni,
+      real_type const a,
+      real_type const b,
+      real_type     & x_min_pos,
+      real_type     & y_min,
+      real_type     & x_max_pos,
+      real_type     & y_max
+    ) const;
+
+    ///@}
+
+    //!
+    //! \name Integration
+    //!
+    //! The integrals of the spline on each segment are accumulated
+    //! in a table built at the first call after the spline is (re)built,
+    //! so that each query cost two interval searches.
+    //!
+    ///@{
+
+    //!
+    //! Definite integral of the spline from `a` to `b`.
+    //!
+    real_type integral( real_type const a, real_type const b ) const;
+
+    //!
+    //! Definite integrals of the spline from `a[k]` to `b[k]`,
+    //! `k=0..n-1`, stored in `out[k]`.
+    //!
+    void
+    integral(
+      real_type const a[],
+      real_type const b[],
+      real_type       out[],
+      integer   const n
+    ) const;
+
+    ///@}
+
+    //!
+    //! \name Inverse
+    //!
+    //! Solution of `eval(x) = y` in \f$ [x_{\min},x_{\max}] \f$ for splines
+    //! with monotone node values (`LINEAR`, `CUBIC`, `AKIMA`, `BESSEL`,
+    //! `PCHIP`, `HERMITE`, `QUINTIC`). The segment is found on the node
+    //! values with a table as `SearchInterval` (built at the first call after
+    //! the spline is (re)built), then the root is computed analytically for
+    //! linear and cubic segments and polished by Newton safeguarded by
+    //! bisection (used alone for quintic segments). If a segment is not
+    //! monotone one of its solutions is returned.
+    //!
+    ///@{
+
+    //!
+    //! Solve `eval(x) = y`; if `y` is out of the range of the values
+    //! `x` is the nearest end and the result is `false`.
+    //!
+    bool inverse( real_type const y, real_type & x ) const;
+
+    //!
+    //! Solve `eval(x[k]) = y[k]`, `k=0..n-1`, as `inverse(y,x)`.
+    //! Values sorted along the spline are located by a forward sweep.
+    //!
+    //! \return the number of values out of range
+    //!
+    integer
+    inverse(
+      real_type const y[],
+      real_type       x[],
+      integer   const n
+    ) const;
+
     ///@}
 
     //! \name Get Info
@@ -982,6 +1260,17 @@ namespace Splines {
     info( ostream_type & stream ) const
     { stream << this->info() << '\n'; }
 
+    //!
+    //! Counters of the interval search and build timings
+    //! (collected only if compiled with `SPLINES_STATS`).
+    //!
+    SplineStats stats() const;
+
+    //!
+    //! Zero the counters returned by `stats()`.
+    //!
+    void reset_stats();
+
     ///@}
 
     #ifdef SPLINES_BACK_COMPATIBILITY
@@ -1033,6 +1322,7 @@ namespace Splines {
 
     #ifndef DOXYGEN_SHOULD_SKIP_THIS
     using Spline::build;
+    using Spline::y_min_max;
     #endif
 
     //!
@@ -1125,6 +1415,19 @@ namespace Splines {
     real_type id_DDD   ( integer const ni, real_type const x ) const override;
     real_type id_DDDD  ( integer const   , real_type const   ) const override { return 0; }
     real_type id_DDDDD ( integer const   , real_type const   ) const override { return 0; }
+
+    real_type id_integral( integer const ni, real_type const a, real_type const b ) const override;
+
+    void
+    id_y_min_max(
+      integer   const ni,
+      real_type const a,
+      real_type const b,
+      real_type     & x_min_pos,
+      real_type     & y_min,
+      real_type     & x_max_pos,
+      real_type     & y_max
+    ) const override;
     ///@}
 
     #ifdef AUTIDIFF_SUPPORT
@@ -1250,6 +1553,8 @@ namespace Splines {
 
     Malloc_real m_mem;
 
+    friend class Spline2DVariant;
+
   protected:
 
     #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -1273,6 +1578,15 @@ namespace Splines {
     SearchInterval m_search_x;
     SearchInterval m_search_y;
 
+    // timings of the last `build` (only with `SPLINES_STATS`)
+    #ifdef SPLINES_STATS
+    double m_build_copy_ms{0};
+    double m_build_coeffs_ms{0};
+    #endif
+
+    // storage borrowed by `load_binary`
+    std::unique_ptr<MappedFile> m_mapped;
+
     static
     integer
     ipos_C( integer const i, integer const j, integer const ldZ )
@@ -1301,6 +1615,36 @@ namespace Splines {
       bool            transposed
     );
 
+    void
+    load_Z(
+      float   const z[],
+      integer const ldZ,
+      bool          fortran_storage,
+      bool          transposed
+    );
+
+    template <typename T>
+    void
+    load_Z_template(
+      T       const z[],
+      integer const ldZ,
+      bool          fortran_storage,
+      bool          transposed
+    );
+
+    void
+    load_grid_values(
+      std::unique_ptr<MappedFile> file,
+      char            const       z[],
+      integer                     value_size,
+      real_type       const       x[],
+      integer                     nx,
+      real_type       const       y[],
+      integer                     ny,
+      bool                        fortran_storage,
+      bool                        transposed
+    );
+
     virtual void make_spline() = 0;
 
     void make_derivative_x  ( real_type const z[], real_type dz[] );
@@ -1601,6 +1945,57 @@ namespace Splines {
 
     ///@}
 
+    //!
+    //! \name Binary grids
+    //!
+    //! Direct loading of large grids without `GenericContainer`.
+    //! The grid file uses the binary container of `SplineSet::save_binary`
+    //! with a header containing `nx`, `ny`, storage order and value type,
+    //! followed by the axes and the values.
+    //!
+    ///@{
+
+    //!
+    //! Save nodes and values to the binary grid file `file_name`.
+    //!
+    void save_grid( string_view file_name ) const;
+
+    //!
+    //! Load a binary grid file and build the spline.
+    //! When the values are `double` stored in the internal order and
+    //! `use_mmap` is true, the values are used directly from the mapped file.
+    //!
+    void load_grid( string_view file_name, bool use_mmap = true );
+
+    //!
+    //! Load a raw raster of `nx` x `ny` values (native byte order)
+    //! and build the spline.
+    //!
+    //! \param file_name        the raster file
+    //! \param x                the `nx` x-nodes
+    //! \param nx               x-dimension
+    //! \param y                the `ny` y-nodes
+    //! \param ny               y-dimension
+    //! \param single_precision if true values are `float` otherwise `double`
+    //! \param fortran_storage  as in `build`
+    //! \param transposed       as in `build`
+    //! \param use_mmap         memory map the file instead of reading it
+    //!
+    void
+    load_raster(
+      string_view     file_name,
+      real_type const x[],
+      integer         nx,
+      real_type const y[],
+      integer         ny,
+      bool            single_precision = false,
+      bool            fortran_storage  = false,
+      bool            transposed       = false,
+      bool            use_mmap         = true
+    );
+
+    ///@}
+
     //!
     //! \name Evaluate
     //!
@@ -1727,6 +2122,17 @@ namespace Splines {
     info( ostream_type & stream ) const
     { stream << this->info() << '\n'; }
 
+    //!
+    //! Counters of the interval searches in both directions and build
+    //! timings (collected only if compiled with `SPLINES_STATS`).
+    //!
+    SplineStats stats() const;
+
+    //!
+    //! Zero the counters returned by `stats()`.
+    //!
+    void reset_stats();
+
     //!
     //! Print stored data x, y, and matrix z.
     //!
@@ -1764,11 +2170,22 @@ namespace Splines {
 #include "Splines/SplineBiCubic.hxx"
 #include "Splines/SplineAkima2D.hxx"
 #include "Splines/SplineBiQuintic.hxx"
+#include "Splines/SplineBiCubicTiled.hxx"
+#include "Splines/SplineVol.hxx"
 
 #include "Splines/SplineVec.hxx"
 #include "Splines/SplineSet.hxx"
 #include "Splines/Splines1D.hxx"
 #include "Splines/Splines2D.hxx"
+#include "Splines/SplinesVariant.hxx"
+#include "Splines/SplineStatic.hxx"
+#include "Splines/SplineFixed.hxx"
+#include "Splines/SplineArena.hxx"
+#include "Splines/SplinesParallel.hxx"
+#include "Splines/SplineBank.hxx"
+#include "Splines/SplineCompress.hxx"
+#include "Splines/SplineLUT.hxx"
+#include "Splines/SplineSampler.hxx"
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
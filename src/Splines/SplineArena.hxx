@@ -0,0 +1,159 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+/*\
+ |   ____        _ _               _
+ |  / ___| _ __ | (_)_ __   ___   / \   _ __ ___ _ __   __ _
+ |  \___ \| '_ \| | | '_ \ / _ \ / _ \ | '__/ _ \ '_ \ / _` |
+ |   ___) | |_) | | | | | |  __// ___ \| | |  __/ | | | (_| |
+ |  |____/| .__/|_|_|_| |_|\___/_/   \_\_|  \___|_| |_|\__,_|
+ |        |_|
+\*/
+
+namespace Splines {
+
+  //!
+  //! Monotonic arena for large collections of small 1D splines.
+  //!
+  //! `make<SPLINE>(npts)` constructs the spline object inside the arena and
+  //! binds its node and derivative arrays (via `reserve_external`) and the
+  //! lookup table of the interval search to memory carved from the same
+  //! block, so a following `build(x,y,n)` with `n <= npts` and the
+  //! evaluations do not touch the heap.  Splines made with an empty name
+  //! (the default) do not store a name either.
+  //!
+  //! Nothing is freed one by one: `release()` (and the destructor) calls the
+  //! destructors of all the splines and gives back the whole memory at once.
+  //! The memory is obtained from a `std::pmr::monotonic_buffer_resource`,
+  //! which can start from a caller provided buffer and/or use a caller
+  //! provided upstream resource.
+  //!
+  //! The arena is not thread safe, the splines it contains are as usual.
+  //!
+  class SplineArena {
+
+    #ifndef DOXYGEN_SHOULD_SKIP_THIS
+    std::pmr::monotonic_buffer_resource m_resource;
+    std::pmr::vector<Spline*>           m_splines; // destroyed in `release`
+    size_t                              m_bytes{0};
+    #endif
+
+  public:
+
+    SplineArena( SplineArena const & ) = delete;
+    SplineArena const & operator = ( SplineArena const & ) = delete;
+
+    //!
+    //! Arena whose blocks (first one of `initial_bytes`) come from `upstream`.
+    //!
+    explicit
+    SplineArena(
+      size_t                      initial_bytes = 1<<20,
+      std::pmr::memory_resource * upstream      = std::pmr::get_default_resource()
+    );
+
+    //!
+    //! Arena starting from the caller provided `buffer` of `bytes` bytes,
+    //! when exhausted further blocks come from `upstream`
+    //! (use `std::pmr::null_memory_resource()` to forbid them).
+    //!
+    SplineArena(
+      void                      * buffer,
+      size_t                      bytes,
+      std::pmr::memory_resource * upstream = std::pmr::get_default_resource()
+    );
+
+    ~SplineArena() { release(); }
+
+    //!
+    //! Destroy all the splines made in the arena and release the memory.
+    //!
+    void release();
+
+    //! memory resource of the arena, to place other containers in it
+    std::pmr::memory_resource * resource() { return &m_resource; }
+
+    //! number of splines alive in the arena
+    integer num_splines() const { return integer(m_splines.size()); }
+
+    //! bytes requested to the arena since the last `release`
+    size_t bytes_allocated() const { return m_bytes; }
+
+    //!
+    //! Uninitialized storage for `n` reals, valid until `release`.
+    //!
+    real_type * alloc_real( integer n );
+
+    //!
+    //! Construct a spline of type `SPLINE` with storage for `npts` points.
+    //! The pointer is owned by the arena, do not delete it.
+    //!
+    //! `SPLINE` is `ConstantSpline`, `LinearSpline`, a spline derived
+    //! from `CubicSplineBase` or `QuinticSpline`.
+    //!
+    template <typename SPLINE>
+    SPLINE *
+    make( integer npts, string_view name = "" ) {
+      constexpr bool is_2 {
+        std::is_same_v<SPLINE,ConstantSpline> || std::is_same_v<SPLINE,LinearSpline>
+      };
+      constexpr bool is_3 { std::is_base_of_v<CubicSplineBase,SPLINE>   };
+      constexpr bool is_4 { std::is_base_of_v<QuinticSplineBase,SPLINE> };
+      static_assert(
+        is_2 || is_3 || is_4,
+        "SplineArena::make, SPLINE must be a 1D spline with external storage"
+      );
+      UTILS_ASSERT( npts > 0, "SplineArena::make, npts = {} must be > 0\n", npts );
+
+      void * p{ m_resource.allocate( sizeof(SPLINE), alignof(SPLINE) ) };
+      m_bytes += sizeof(SPLINE);
+      // grow in advance so that `push_back` cannot throw
+      if ( m_splines.size() == m_splines.capacity() ) m_splines.reserve( 2*m_splines.size()+16 );
+      SPLINE * S{ new (p) SPLINE( name ) };
+      m_splines.push_back( S );
+
+      real_type * pX{ alloc_real( npts ) };
+      real_type * pY{ alloc_real( npts ) };
+      if constexpr ( is_2 ) {
+        S->reserve_external( npts, pX, pY );
+      } else if constexpr ( is_3 ) {
+        real_type * pYp{ alloc_real( npts ) };
+        S->reserve_external( npts, pX, pY, pYp );
+      } else {
+        real_type * pYp  { alloc_real( npts ) };
+        real_type * pYpp { alloc_real( npts ) };
+        S->reserve_external( npts, pX, pY, pYp, pYpp );
+      }
+      // allocated here, not lazily in `find`: the arena is not thread safe
+      integer const nt{ SearchInterval::table_size( npts ) };
+      if ( nt > 0 ) {
+        size_t const bytes{ static_cast<size_t>(nt)*sizeof(integer) };
+        m_bytes += bytes;
+        static_cast<Spline*>(S)->m_search.set_external_table(
+          static_cast<integer*>( m_resource.allocate( bytes, alignof(integer) ) )
+        );
+      }
+      return S;
+    }
+
+  };
+
+}
+
+// EOF: SplineArena.hxx
@@ -0,0 +1,259 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+/*\
+ |   ____        _ _            ____              _
+ |  / ___| _ __ | (_)_ __   ___| __ )  __ _ _ __ | | __
+ |  \___ \| '_ \| | | '_ \ / _ \  _ \ / _` | '_ \| |/ /
+ |   ___) | |_) | | | | | |  __/ |_) | (_| | | | |   <
+ |  |____/| .__/|_|_|_| |_|\___|____/ \__,_|_| |_|_|\_\
+ |        |_|
+\*/
+
+namespace Splines {
+
+  //!
+  //! Collection of many independent small 1D splines of the same type.
+  //!
+  //! Instead of one `Spline` object for each member (vtable, mutex, search
+  //! structure, name and heap blocks) the nodes, values and slopes of all the
+  //! members are stored in three flat arrays, member `id` owning the entries
+  //! `offset(id) .. offset(id+1)-1` (CSR layout).
+  //!
+  //! Usage:
+  //!
+  //! - `setup` the type, optionally `reserve`;
+  //! - `add` the members (nodes strictly increasing, at least 2 points),
+  //!   or pass all of them at once to `build( nspl, offset, X, Y )`;
+  //! - `build` computes the slopes of all the members in parallel;
+  //! - evaluate one point with `eval(id,x)` or a batch with
+  //!   `eval(ids,xs,out,n)`, the queries are grouped by member before
+  //!   the evaluation to keep the nodes of each member in cache.
+  //!
+  //! Types: `LINEAR` (constant outside the nodes as `LinearSpline`),
+  //! `CUBIC` (boundary conditions as in `CubicSpline`), `AKIMA`, `BESSEL`,
+  //! `PCHIP` and `HERMITE` (slopes given by the user). The cubic types
+  //! extrapolate with the first/last polynomial. The interval is found by
+  //! binary search.
+  //!
+  //! Evaluation is thread safe, `add` and `build` are not. The pool runs
+  //! one batch at a time: a batched `eval` issued while another thread owns
+  //! the pool is evaluated serially in the calling thread (no waiting).
+  //!
+  class SplineBank {
+
+    #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+    string            m_name;
+    SplineType1D      m_type{SplineType1D::CUBIC};
+    CubicSpline_BC    m_bc0{CubicSpline_BC::EXTRAPOLATE};
+    CubicSpline_BC    m_bcn{CubicSpline_BC::EXTRAPOLATE};
+    bool              m_built{false};
+
+    vector<integer>   m_offset{0}; // `num_splines()+1` entries
+    vector<real_type> m_X;
+    vector<real_type> m_Y;
+    vector<real_type> m_Yp;        // empty for `LINEAR`
+
+    std::unique_ptr<WorkStealingPool> m_pool;
+    mutable std::mutex                m_run_mutex;
+
+    bool is_linear() const { return m_type == SplineType1D::LINEAR; }
+
+    void check_id( integer id, char const where[] ) const;
+    void check_nodes( integer id, real_type const x[], integer n, char const where[] ) const;
+    void build_member( integer id, vector<real_type> & work );
+
+    // runs `task(0..ntasks-1)` on the pool, or in the calling thread
+    // when the pool is busy with the batch of another thread
+    void run( integer ntasks, std::function<void(integer)> const & task ) const;
+
+    // `DER`-th derivative of member `id` at `x`
+    template <integer DER>
+    real_type
+    eval_der( integer id, real_type x ) const {
+      size_t const      i0 { size_t(m_offset[size_t(id)]) };
+      integer const     n  { m_offset[size_t(id)+1] - m_offset[size_t(id)] };
+      real_type const * X  { m_X.data() + i0 };
+      real_type const * Y  { m_Y.data() + i0 };
+      if ( is_linear() ) {
+        if ( x <= X[0]   ) return DER == 0 ? Y[0]   : 0;
+        if ( x >= X[n-1] ) return DER == 0 ? Y[n-1] : 0;
+      }
+      integer i{ integer( std::upper_bound( X+1, X+n-1, x ) - X ) - 1 };
+      real_type const h  { X[i+1] - X[i] };
+      real_type const s  { x - X[i] };
+      real_type const dy { (Y[i+1] - Y[i])/h };
+      if ( is_linear() ) {
+        if constexpr ( DER == 0 ) return Y[i] + s*dy;
+        else if constexpr ( DER == 1 ) return dy;
+        else return 0;
+      }
+      // p(s) = y0 + s*(yp0 + s*(B + s*A))
+      real_type const * Yp  { m_Yp.data() + i0 };
+      real_type const   yp0 { Yp[i] };
+      real_type const   yp1 { Yp[i+1] };
+      real_type const   B   { (3*dy - 2*yp0 - yp1)/h };
+      real_type const   A   { (yp0 + yp1 - 2*dy)/(h*h) };
+      if      constexpr ( DER == 0 ) return Y[i] + s*(yp0 + s*(B + s*A));
+      else if constexpr ( DER == 1 ) return yp0 + s*(2*B + 3*s*A);
+      else if constexpr ( DER == 2 ) return 2*B + 6*s*A;
+      else return 6*A;
+    }
+
+    #endif
+
+  public:
+
+    SplineBank( SplineBank const & ) = delete;
+    SplineBank const & operator = ( SplineBank const & ) = delete;
+
+    //!
+    //! Empty bank of `CUBIC` splines.
+    //!
+    //! \param name        the name of the bank
+    //! \param num_threads threads used by `build` and batched `eval`
+    //!                    (`0` = hardware concurrency, `1` = no threads)
+    //!
+    explicit
+    SplineBank( string_view name = "SplineBank", integer num_threads = 0 );
+
+    ~SplineBank();
+
+    //! \name Setup and build
+    ///@{
+
+    //!
+    //! Set the type of the members (clear the bank).
+    //!
+    void setup( SplineType1D type );
+
+    //! set the initial boundary condition for `CUBIC` members
+    void set_initial_BC( CubicSpline_BC bc0 ) { m_bc0 = bc0; m_built = false; }
+
+    //! set the final boundary condition for `CUBIC` members
+    void set_final_BC( CubicSpline_BC bcn ) { m_bcn = bcn; m_built = false; }
+
+    //!
+    //! Reserve memory for `nspl` members with `npts` points in total.
+    //!
+    void reserve( integer nspl, integer npts );
+
+    //!
+    //! Remove all the members.
+    //!
+    void clear();
+
+    //!
+    //! Append a member interpolating `(x[i],y[i])`, return its `id`.
+    //!
+    integer add( real_type const x[], real_type const y[], integer n );
+
+    //!
+    //! Append a `HERMITE` member with slopes `yp`, return its `id`.
+    //!
+    integer add( real_type const x[], real_type const y[], real_type const yp[], integer n );
+
+    //!
+    //! Compute the slopes of all the members added (in parallel).
+    //!
+    void build();
+
+    //!
+    //! Replace the content of the bank with `nspl` members in CSR format
+    //! and build it: member `id` is `X[offset[id]..offset[id+1]-1]`, same for
+    //! `Y` and (only for `HERMITE`) `Yp`, `offset[0]` must be `0`.
+    //!
+    void
+    build(
+      integer         nspl,
+      integer   const offset[],
+      real_type const X[],
+      real_type const Y[],
+      real_type const Yp[] = nullptr
+    );
+
+    ///@}
+
+    //! \name Info
+    ///@{
+
+    string_view  name()        const { return m_name; }
+    SplineType1D type()        const { return m_type; }
+    integer      num_splines() const { return integer(m_offset.size())-1; }
+    integer      num_points()  const { return m_offset.back(); }
+    bool         is_built()    const { return m_built; }
+
+    //! number of points of member `id`
+    integer
+    num_points( integer id ) const
+    { return m_offset[size_t(id)+1] - m_offset[size_t(id)]; }
+
+    //! first entry of member `id` in the flat arrays
+    integer offset( integer id ) const { return m_offset[size_t(id)]; }
+
+    real_type x_min( integer id ) const { return m_X[size_t(m_offset[size_t(id)])]; }
+    real_type x_max( integer id ) const { return m_X[size_t(m_offset[size_t(id)+1])-1]; }
+
+    //! flat arrays of the nodes, values and slopes (empty for `LINEAR`)
+    real_type const * X_data()  const { return m_X.data(); }
+    real_type const * Y_data()  const { return m_Y.data(); }
+    real_type const * Yp_data() const { return m_Yp.data(); }
+
+    //! bytes used by the data of the bank
+    size_t memory_bytes() const;
+
+    string info() const;
+    void info( ostream_type & stream ) const { stream << this->info() << '\n'; }
+
+    ///@}
+
+    //! \name Evaluation
+    ///@{
+
+    //! value of member `id` at `x`
+    real_type eval( integer id, real_type x ) const { check_id( id, "eval" ); return eval_der<0>( id, x ); }
+    //! first derivative of member `id` at `x`
+    real_type D( integer id, real_type x ) const { check_id( id, "D" ); return eval_der<1>( id, x ); }
+    //! second derivative of member `id` at `x`
+    real_type DD( integer id, real_type x ) const { check_id( id, "DD" ); return eval_der<2>( id, x ); }
+    //! third derivative of member `id` at `x`
+    real_type DDD( integer id, real_type x ) const { check_id( id, "DDD" ); return eval_der<3>( id, x ); }
+
+    //!
+    //! Evaluate `out[k]` = derivative `deriv` (0..3) of member `ids[k]` at `xs[k]`,
+    //! for `k = 0..n-1`. The queries are grouped by member and
+    //! evaluated in parallel.
+    //!
+    void
+    eval(
+      integer   const ids[],
+      real_type const xs[],
+      real_type       out[],
+      integer         n,
+      integer         deriv = 0
+    ) const;
+
+    ///@}
+
+  };
+
+}
+
+// EOF: SplineBank.hxx
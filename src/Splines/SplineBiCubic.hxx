@@ -95,6 +95,26 @@ namespace Splines {
 
     ///@}
 
+    //!
+    //! \name Binary I/O
+    //!
+    ///@{
+
+    //!
+    //! Save nodes, values and estimated derivatives to the binary
+    //! file `file_name` (same format family of `SplineSet::save_binary`).
+    //!
+    void save_binary( string_view file_name ) const;
+
+    //!
+    //! Load a spline saved with `save_binary` by a spline of the same type.
+    //! Derivatives are not recomputed; with `use_mmap` the arrays
+    //! are used directly from the memory mapped file.
+    //!
+    void load_binary( string_view file_name, bool use_mmap = true );
+
+    ///@}
+
     //!
     //! \name Evaluate
     //!
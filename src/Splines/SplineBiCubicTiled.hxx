@@ -0,0 +1,202 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+namespace Splines {
+
+  /*\
+   |   _____ _ _          _ ____  _  ____      _     _
+   |  |_   _(_) | ___  __| | __ )(_)/ ___|   _| |__ (_) ___
+   |    | | | | |/ _ \/ _` |  _ \| | |  | | | | '_ \| |/ __|
+   |    | | | | |  __/ (_| | |_) | | |__| |_| | |_) | | (__
+   |    |_| |_|_|\___|\__,_|____/|_|\____\__,_|_.__/|_|\___|
+  \*/
+
+  //!
+  //! Bicubic spline surface evaluated out of core.
+  //!
+  //! The grid stays on disk (a file written by `SplineSurf::save_grid` or a
+  //! raw raster) and is split into tiles of `tile_nx` x `tile_ny` cells.
+  //! Each tile is read with one node of overlap on every side and built as a
+  //! `BiCubicSpline`: the derivative estimate uses a three point stencil, so
+  //! derivatives (and values) are the same of the spline built on the whole
+  //! grid and tiles join seamlessly.
+  //!
+  //! Tiles are loaded on demand and kept in a LRU cache bounded by
+  //! `set_cache_bytes`. Evaluation is thread safe: concurrent readers share
+  //! the cache and a tile is released only when no reader uses it.
+  //! Node values are not kept in memory, so `z_node` is not available.
+  //! Closed surfaces are not supported.
+  //!
+  class TiledBiCubicSpline : public SplineSurf {
+
+    #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+    using Tile = std::shared_ptr<BiCubicSpline const>;
+
+    Malloc_real m_mem_tiled;
+
+    // source file
+    string                m_file_name;
+    size_t                m_offset{0};     // byte offset of the values
+    integer               m_value_size{8}; // 4 = float, 8 = double
+    bool                  m_by_x_rows{true};
+    mutable std::ifstream m_file;
+    mutable std::mutex    m_file_mutex;
+
+    // tiles
+    integer m_tile_nx{256};
+    integer m_tile_ny{256};
+    integer m_num_tiles_x{0};
+    integer m_num_tiles_y{0};
+
+    // LRU cache, most recently used first
+    size_t  m_cache_bytes{ size_t(256) << 20 };
+    size_t  m_max_tiles{1};
+    mutable std::mutex                                  m_cache_mutex;
+    mutable std::list<std::pair<integer,Tile>>          m_lru;
+    mutable std::unordered_map<integer,std::list<std::pair<integer,Tile>>::iterator> m_lru_pos;
+    mutable size_t m_tile_loads{0};
+
+    void make_spline() override;
+
+    void
+    open_source(
+      string_view     file_name,
+      size_t          offset,
+      integer         value_size,
+      bool            by_x_rows,
+      real_type const x[],
+      integer         nx,
+      real_type const y[],
+      integer         ny
+    );
+
+    void   setup_tiles();
+    Tile   load_tile( integer ti, integer tj ) const;
+    Tile   get_tile( integer ti, integer tj ) const;
+    Tile   find_tile( real_type x, real_type y ) const;
+    size_t tile_bytes() const;
+
+    #endif
+
+  public:
+
+    using SplineSurf::eval;
+
+    //!
+    //! Build an empty spline of `TiledBiCubicSpline` type
+    //!
+    //! \param name the name of the spline
+    //!
+    explicit
+    TiledBiCubicSpline( string_view name = "TiledBiCubicSpline" );
+
+    ~TiledBiCubicSpline() override {}
+
+    //!
+    //! \name Setup
+    //!
+    ///@{
+
+    //!
+    //! Set the number of cells of a tile in `x` and `y` direction
+    //! (default 256 x 256). The cache is cleared.
+    //!
+    void set_tile_size( integer tile_nx, integer tile_ny );
+
+    //!
+    //! Set the maximum memory used by the cached tiles (default 256MB,
+    //! at least one tile is always kept). The cache is trimmed if needed.
+    //!
+    void set_cache_bytes( size_t bytes );
+
+    //!
+    //! Open a grid file written by `SplineSurf::save_grid`.
+    //! Only the axes are loaded, the values are streamed once to compute
+    //! `z_min` and `z_max`.
+    //!
+    void open_grid( string_view file_name );
+
+    //!
+    //! Open a raw raster of `nx` x `ny` values (native byte order),
+    //! arguments as in `SplineSurf::load_raster`.
+    //!
+    void
+    open_raster(
+      string_view     file_name,
+      real_type const x[],
+      integer         nx,
+      real_type const y[],
+      integer         ny,
+      bool            single_precision = false,
+      bool            fortran_storage  = false,
+      bool            transposed       = false
+    );
+
+    //!
+    //! Drop all the cached tiles
+    //!
+    void clear_cache();
+
+    ///@}
+
+    //!
+    //! \name Info
+    //!
+    ///@{
+
+    //! number of tiles in `x` direction
+    integer num_tiles_x() const { return m_num_tiles_x; }
+
+    //! number of tiles in `y` direction
+    integer num_tiles_y() const { return m_num_tiles_y; }
+
+    //! number of tiles currently cached
+    integer cached_tiles() const;
+
+    //! total number of tiles read from file
+    size_t tile_loads() const;
+
+    //! memory limit of the tile cache
+    size_t cache_bytes() const { return m_cache_bytes; }
+
+    ///@}
+
+    //!
+    //! \name Evaluate
+    //!
+    ///@{
+    real_type eval( real_type const x, real_type const y ) const override;
+    void      D   ( real_type const x, real_type const y, real_type d[3] ) const override;
+    real_type Dx  ( real_type const x, real_type const y ) const override;
+    real_type Dy  ( real_type const x, real_type const y ) const override;
+    void      DD  ( real_type const x, real_type const y, real_type dd[6] ) const override;
+    real_type Dxx ( real_type const x, real_type const y ) const override;
+    real_type Dxy ( real_type const x, real_type const y ) const override;
+    real_type Dyy ( real_type const x, real_type const y ) const override;
+    ///@}
+
+    void write_to_stream( ostream_type & s ) const override;
+    char const * type_name() const override;
+
+  };
+
+}
+
+// EOF: SplineBiCubicTiled.hxx
@@ -0,0 +1,136 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+/*\
+ |   ____        _ _             ____
+ |  / ___| _ __ | (_)_ __   ___ / ___|___  _ __ ___  _ __  _ __ ___  ___ ___
+ |  \___ \| '_ \| | | '_ \ / _ \ |   / _ \| '_ ` _ \| '_ \| '__/ _ \/ __/ __|
+ |   ___) | |_) | | | | | |  __/ |__| (_) | | | | | | |_) | | |  __/\__ \__ \
+ |  |____/| .__/|_|_|_| |_|\___|\____\___/|_| |_| |_| .__/|_|  \___||___/___/
+ |        |_|                                       |_|
+\*/
+
+namespace Splines {
+
+  //!
+  //! Statistics of the last `SplineCompressor::compress`.
+  //!
+  struct SplineCompressInfo {
+    integer   npts_in{0};   //!< number of nodes of the input
+    integer   npts_out{0};  //!< number of nodes kept
+    integer   passes{0};    //!< refinement passes
+    real_type max_error{0}; //!< bound of the max abs error (see `SplineCompressor`)
+    bool      bounded{true}; //!< `false` if `max_error` exceeds the tolerance
+    string to_string() const;
+  };
+
+  //!
+  //! Knot reduction of 1D splines with an \f$ L_\infty \f$ bound.
+  //!
+  //! The output is a spline of the same type (and settings: boundary
+  //! conditions, quintic type, extension flags) built on a subset of the
+  //! input nodes, such that the error is at most the tolerance:
+  //!
+  //! - raw data: the error is measured on the data points only;
+  //! - `Spline`: the error against the input spline is bounded on the whole
+  //!   range; on each input interval the difference \f$ e \f$ is a
+  //!   polynomial and
+  //!   \f$ |e| \le \max(|e(x_j)|,|e(x_{j+1})|) + h^2/8 \max|e''| \f$,
+  //!   with \f$ e'' \f$ bounded by its Taylor expansion at the midpoint
+  //!   (derivatives up to the fifth), so `max_error` is an upper bound
+  //!   (up to rounding), not a sampled estimate;
+  //! - `SplineSet`: the same for every column, one common subset of nodes.
+  //!
+  //! The knots are selected top down: starting from the end points, at each
+  //! pass the spline is rebuilt and every interval whose error exceeds the
+  //! tolerance is split at its worst node (restricted to the central half of
+  //! the interval, so each interval shrinks at least by 1/4 and the passes are
+  //! \f$ O(\log n) \f$). A pass costs \f$ O(n) \f$ evaluations without interval
+  //! search (`id_eval`), split among the threads of the compressor.
+  //!
+  //! With all the nodes kept the spline interpolates the data, so the bound
+  //! on the nodes is always reached; an error inside an interval of two
+  //! consecutive nodes cannot be reduced and is reported in `info().bounded`.
+  //!
+  class SplineCompressor {
+
+    #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+    struct Column;
+
+    real_type                         m_tolerance{1e-6};
+    std::unique_ptr<WorkStealingPool> m_pool;
+    SplineCompressInfo                m_info;
+
+    static void set_column( Column & C, Spline const & S );
+    void select( vector<Column> & cols, real_type const X[], integer n, vector<integer> & keep );
+
+    #endif
+
+  public:
+
+    SplineCompressor( SplineCompressor const & ) = delete;
+    SplineCompressor const & operator = ( SplineCompressor const & ) = delete;
+
+    //!
+    //! \param tolerance   max abs error allowed
+    //! \param num_threads threads used (`0` = hardware concurrency)
+    //!
+    explicit
+    SplineCompressor( real_type tolerance = 1e-6, integer num_threads = 0 );
+
+    ~SplineCompressor();
+
+    //! set the max abs error allowed
+    void set_tolerance( real_type tol );
+
+    //! max abs error allowed
+    real_type tolerance() const { return m_tolerance; }
+
+    //! statistics of the last compression
+    SplineCompressInfo const & info() const { return m_info; }
+
+    //!
+    //! Spline of type `type` (not `HERMITE`) on a subset of the data
+    //! `(x[i],y[i])`, `x` strictly increasing.
+    //!
+    std::unique_ptr<Spline>
+    compress(
+      SplineType1D    type,
+      real_type const x[],
+      real_type const y[],
+      integer         n,
+      string_view     name = "compressed"
+    );
+
+    //!
+    //! Spline of the same type and settings of `S` on a subset of its nodes.
+    //!
+    std::unique_ptr<Spline> compress( Spline const & S, string_view name = "compressed" );
+
+    //!
+    //! Build `out` with the columns of `in` on a common subset of its nodes.
+    //!
+    void compress( SplineSet const & in, SplineSet & out );
+
+  };
+
+}
+
+// EOF: SplineCompress.hxx
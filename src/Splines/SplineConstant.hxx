@@ -39,6 +39,7 @@ namespace Splines {
 
     #ifndef DOXYGEN_SHOULD_SKIP_THIS
     using Spline::build;
+    using Spline::y_min_max;
     #endif
 
     //!
@@ -112,6 +113,20 @@ namespace Splines {
     real_type id_D    ( integer const   , real_type const   ) const override { return 0; }
     real_type id_DD   ( integer const   , real_type const   ) const override { return 0; }
     real_type id_DDD  ( integer const   , real_type const   ) const override { return 0; }
+
+    real_type id_integral( integer const ni, real_type const a, real_type const b ) const override;
+
+    // the value is reached at `a` (at `b` the next segment is evaluated)
+    void
+    id_y_min_max(
+      integer   const ni,
+      real_type const a,
+      real_type const b,
+      real_type     & x_min_pos,
+      real_type     & y_min,
+      real_type     & x_max_pos,
+      real_type     & y_max
+    ) const override;
     ///@}
 
     #ifdef AUTIDIFF_SUPPORT
@@ -175,6 +190,7 @@ namespace Splines {
       copy_n( S.m_X,  m_npts,   m_X );
       copy_n( S.m_Y,  m_npts-1, m_Y );
       copy_flags( S );
+      m_search.must_reset();
     }
 
   };
@@ -119,6 +119,12 @@ namespace Splines {
     set_final_BC( CubicSpline_BC bcn )
     { m_bcn = bcn; }
 
+    //! \return the boundary condition at the initial point
+    CubicSpline_BC initial_BC() const { return m_bc0; }
+
+    //! \return the boundary condition at the final point
+    CubicSpline_BC final_BC() const { return m_bcn; }
+
     // --------------------------- VIRTUALS -----------------------------------
 
     void build() override;
@@ -0,0 +1,310 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+/*\
+ |   _____ _              _ ____        _ _
+ |  |  ___(_)_  _____  __| / ___| _ __ | (_)_ __   ___
+ |  | |_  | \ \/ / _ \/ _` \___ \| '_ \| | | '_ \ / _ \
+ |  |  _| | |>  <  __/ (_| |___) | |_) | | | | | |  __/
+ |  |_|   |_/_/\_\___|\__,_|____/| .__/|_|_|_| |_|\___|
+ |                               |_|
+\*/
+
+namespace Splines {
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  namespace fixed_spline_detail {
+
+    constexpr real_type c_abs( real_type a ) { return a < 0 ? -a : a; }
+
+    constexpr int
+    c_sign( real_type a ) { return a > 0 ? 1 : ( a < 0 ? -1 : 0 ); }
+
+  }
+
+  #endif
+
+  //!
+  //! Small spline with `N` nodes stored inline in `std::array`.
+  //!
+  //! Meant for calibration tables and maps known at compile time: no heap,
+  //! no name, no search table and no mutex.  The object is trivially
+  //! copyable, construction and evaluation are `constexpr`, so a table
+  //! declared `constexpr` is built by the compiler and lives in read-only data.
+  //!
+  //! - `KIND = LINEAR`: piecewise linear, constant outside the nodes
+  //!   (as `LinearSpline`).
+  //! - `KIND = CUBIC`: cubic spline with natural boundary conditions.
+  //! - `KIND = AKIMA`, `KIND = PCHIP`: same slopes as `AkimaSpline`
+  //!   and `PchipSpline`.
+  //!
+  //! The cubic kinds extrapolate with the first/last polynomial. The interval
+  //! is found by binary search (`N` is small), nodes must be strictly increasing.
+  //!
+  template <integer N, SplineType1D KIND>
+  class FixedSpline {
+
+    static_assert( N >= 2, "FixedSpline: N must be >= 2" );
+    static_assert(
+      KIND == SplineType1D::LINEAR || KIND == SplineType1D::CUBIC ||
+      KIND == SplineType1D::AKIMA  || KIND == SplineType1D::PCHIP,
+      "FixedSpline: KIND must be LINEAR, CUBIC, AKIMA or PCHIP"
+    );
+
+  public:
+
+    using array_type = std::array<real_type,static_cast<size_t>(N)>;
+
+  private:
+
+    #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+    array_type m_X{};
+    array_type m_Y{};
+    array_type m_Yp{}; // slopes at the nodes (unused for LINEAR)
+
+    constexpr void
+    build_natural() {
+      // tridiagonal system for the second derivatives Z, natural BC: Z[0] = Z[N-1] = 0
+      array_type Z{}, U{};
+      for ( integer i{1}; i < N-1; ++i ) {
+        real_type const HL{ m_X[i] - m_X[i-1] };
+        real_type const HR{ m_X[i+1] - m_X[i] };
+        real_type const HH{ HL + HR };
+        real_type const L { HL/HH };
+        real_type const R { 6*((m_Y[i+1]-m_Y[i])/HR-(m_Y[i]-m_Y[i-1])/HL)/HH };
+        // forward elimination (Thomas), row 0 is the identity
+        real_type const D { 2 - L * U[i-1] };
+        U[i] = (HR/HH)/D;
+        Z[i] = (R - L * Z[i-1])/D;
+      }
+      for ( integer i{N-2}; i > 0; --i ) Z[i] -= U[i] * Z[i+1];
+      for ( integer i{0}; i < N-1; ++i ) {
+        real_type const DX{ m_X[i+1] - m_X[i] };
+        m_Yp[i] = (m_Y[i+1]-m_Y[i])/DX - (2*Z[i] + Z[i+1]) * (DX/6);
+      }
+      real_type const DX2{ (m_X[N-1] - m_X[N-2])/2 };
+      m_Yp[N-1] = m_Yp[N-2] + DX2 * (Z[N-2] + Z[N-1]);
+    }
+
+    constexpr void
+    build_akima() {
+      using fixed_spline_detail::c_abs;
+      array_type m{};
+      for ( integer i{0}; i < N-1; ++i ) m[i] = (m_Y[i+1]-m_Y[i])/(m_X[i+1]-m_X[i]);
+      real_type epsi{0};
+      for ( integer i{0}; i < N-2; ++i ) {
+        real_type const dm{ c_abs(m[i+1]-m[i]) };
+        if ( dm > epsi ) epsi = dm;
+      }
+      epsi *= 1E-8;
+      for ( integer i{1}; i < N-1; ++i ) {
+        real_type const m_im2 { (i >= 2) ? m[i-2] : 2*m[i-1] - m[i]  };
+        real_type const m_im1 { m[i-1]                               };
+        real_type const m_i   { m[i]                                 };
+        real_type const m_ip1 { (i < N-2) ? m[i+1] : 2*m[i] - m[i-1] };
+        real_type const w_left  { c_abs( m_ip1 - m_i )   + c_abs( m_ip1 + m_i   ) / 2 };
+        real_type const w_right { c_abs( m_im1 - m_im2 ) + c_abs( m_im1 + m_im2 ) / 2 };
+        real_type const sum_w   { w_left + w_right };
+        if ( sum_w > epsi ) m_Yp[i] = (w_right * m_im1 + w_left * m_i) / sum_w;
+        else                m_Yp[i] = 0.5*(m_im1 + m_i);
+      }
+      m_Yp[0]   = m[0] + (m[0] - m[1]) * (m_X[0] - m_X[1]) / (m_X[2] - m_X[0]);
+      m_Yp[N-1] = m[N-2] + (m[N-2] - m[N-3]) * (m_X[N-1] - m_X[N-2]) / (m_X[N-1] - m_X[N-3]);
+    }
+
+    constexpr void
+    build_pchip() {
+      using fixed_spline_detail::c_abs;
+      using fixed_spline_detail::c_sign;
+      integer const n{ N-1 };
+      real_type h1   { m_X[1] - m_X[0] };
+      real_type del1 { (m_Y[1]-m_Y[0])/h1 };
+      real_type h2   { m_X[2] - m_X[1] };
+      real_type del2 { (m_Y[2]-m_Y[1])/h2 };
+      real_type hsum { h1 + h2 };
+      m_Yp[0] = (1+h1/hsum)*del1 - (h1/hsum)*del2;
+      if ( c_sign(m_Yp[0])*c_sign(del1) <= 0 ) {
+        m_Yp[0] = 0;
+      } else if ( c_sign(del1)*c_sign(del2) < 0 ) {
+        real_type const dmax{ 3*del1 };
+        if ( c_abs(m_Yp[0]) > c_abs(dmax) ) m_Yp[0] = dmax;
+      }
+      for ( integer i{1}; i < n; ++i ) {
+        if ( i > 1 ) {
+          h1   = h2;
+          h2   = m_X[i+1] - m_X[i];
+          hsum = h1 + h2;
+          del1 = del2;
+          del2 = (m_Y[i+1] - m_Y[i])/h2;
+        }
+        m_Yp[i] = 0;
+        if ( c_sign(del1)*c_sign(del2) == 1 ) {
+          // Brodlie modification of Butland formula
+          real_type const w1   { (1+h1/hsum)/3 };
+          real_type const w2   { (1+h2/hsum)/3 };
+          real_type const dmax { c_abs(del1) > c_abs(del2) ? del1 : del2 };
+          real_type const dmin { c_abs(del1) > c_abs(del2) ? del2 : del1 };
+          m_Yp[i] = dmin/(w1*(del1/dmax) + w2*(del2/dmax));
+        }
+      }
+      m_Yp[n] = -(h2/hsum)*del1 + ((h2+hsum)/hsum)*del2;
+      if ( c_sign(m_Yp[n])*c_sign(del2) <= 0 ) {
+        m_Yp[n] = 0;
+      } else if ( c_sign(del1)*c_sign(del2) < 0 ) {
+        real_type const dmax{ 3*del2 };
+        if ( c_abs(m_Yp[n]) > c_abs(dmax) ) m_Yp[n] = dmax;
+      }
+    }
+
+    // interval `i` such that `x[i] <= x < x[i+1]`, clamped to `[0,N-2]`
+    constexpr integer
+    locate( real_type x ) const {
+      integer lo{0}, hi{N-1};
+      while ( hi - lo > 1 ) {
+        integer const mid{ (lo+hi)/2 };
+        if ( x < m_X[mid] ) hi = mid;
+        else                lo = mid;
+      }
+      return lo;
+    }
+
+    // `DER`-th derivative of the Hermite cubic (or segment) of interval `i`
+    template <integer DER>
+    constexpr real_type
+    eval_der( real_type x ) const {
+      if constexpr ( KIND == SplineType1D::LINEAR ) {
+        if ( x <= m_X[0]   ) return DER == 0 ? m_Y[0]   : 0;
+        if ( x >= m_X[N-1] ) return DER == 0 ? m_Y[N-1] : 0;
+      }
+      integer   const i { locate( x ) };
+      real_type const h { m_X[i+1] - m_X[i] };
+      real_type const s { x - m_X[i] };
+      real_type const dy{ (m_Y[i+1] - m_Y[i])/h };
+      if constexpr ( KIND == SplineType1D::LINEAR ) {
+        if constexpr ( DER == 0 ) return m_Y[i] + s*dy;
+        else if constexpr ( DER == 1 ) return dy;
+        else return 0;
+      } else {
+        // p(s) = y0 + s*(yp0 + s*(B + s*A))
+        real_type const yp0{ m_Yp[i] };
+        real_type const yp1{ m_Yp[i+1] };
+        real_type const B  { (3*dy - 2*yp0 - yp1)/h };
+        real_type const A  { (yp0 + yp1 - 2*dy)/(h*h) };
+        if      constexpr ( DER == 0 ) return m_Y[i] + s*(yp0 + s*(B + s*A));
+        else if constexpr ( DER == 1 ) return yp0 + s*(2*B + 3*s*A);
+        else if constexpr ( DER == 2 ) return 2*B + 6*s*A;
+        else if constexpr ( DER == 3 ) return 6*A;
+        else return 0;
+      }
+    }
+
+    #endif
+
+  public:
+
+    //! Empty spline (all nodes zero), assign a built one before use.
+    constexpr FixedSpline() = default;
+
+    //!
+    //! Build the spline interpolating `(x[i],y[i])`, `x` strictly increasing.
+    //! Usable in constant expressions.
+    //!
+    constexpr
+    FixedSpline( array_type const & x, array_type const & y )
+    : m_X{ x }
+    , m_Y{ y }
+    {
+      for ( integer i{1}; i < N; ++i ) {
+        UTILS_ASSERT(
+          m_X[i-1] < m_X[i],
+          "FixedSpline, nodes must be strictly increasing, X[{}] = {} >= X[{}] = {}\n",
+          i-1, m_X[i-1], i, m_X[i]
+        );
+      }
+      if constexpr ( KIND != SplineType1D::LINEAR ) {
+        if ( N == 2 ) {
+          m_Yp[0] = m_Yp[N-1] = (m_Y[N-1]-m_Y[0])/(m_X[N-1]-m_X[0]);
+        } else if constexpr ( KIND == SplineType1D::CUBIC ) {
+          build_natural();
+        } else if constexpr ( KIND == SplineType1D::AKIMA ) {
+          build_akima();
+        } else {
+          build_pchip();
+        }
+      }
+    }
+
+    //! \name Info
+    ///@{
+    static constexpr integer      num_points() { return N; }
+    static constexpr SplineType1D type()       { return KIND; }
+
+    constexpr real_type x_min() const { return m_X[0]; }
+    constexpr real_type x_max() const { return m_X[N-1]; }
+
+    constexpr real_type x_node( integer i ) const { return m_X[i]; }
+    constexpr real_type y_node( integer i ) const { return m_Y[i]; }
+
+    //! slope at node `i` (for `LINEAR` the slope of the segment to the right)
+    constexpr real_type
+    yp_node( integer i ) const {
+      if constexpr ( KIND == SplineType1D::LINEAR ) {
+        integer const j{ i < N-1 ? i : N-2 };
+        return (m_Y[j+1]-m_Y[j])/(m_X[j+1]-m_X[j]);
+      } else {
+        return m_Yp[i];
+      }
+    }
+    ///@}
+
+    //! \name Evaluation
+    ///@{
+    constexpr real_type eval( real_type x )        const { return eval_der<0>( x ); }
+    constexpr real_type D( real_type x )           const { return eval_der<1>( x ); }
+    constexpr real_type DD( real_type x )          const { return eval_der<2>( x ); }
+    constexpr real_type DDD( real_type x )         const { return eval_der<3>( x ); }
+    constexpr real_type operator () ( real_type x ) const { return eval_der<0>( x ); }
+    ///@}
+
+    //!
+    //! Copy to a heap allocated `StaticSpline` of the same kind
+    //! (for the cubic kinds the slopes are copied, not recomputed).
+    //!
+    StaticSpline<KIND>
+    to_static() const {
+      StaticSpline<KIND> S;
+      if constexpr ( KIND == SplineType1D::LINEAR ) {
+        S.build( m_X.data(), m_Y.data(), N );
+      } else {
+        S.build( m_X.data(), m_Y.data(), m_Yp.data(), N );
+      }
+      return S;
+    }
+
+  };
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+  static_assert( std::is_trivially_copyable_v<FixedSpline<4,SplineType1D::CUBIC>> );
+  #endif
+
+}
+
+// EOF: SplineFixed.hxx
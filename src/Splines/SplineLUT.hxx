@@ -0,0 +1,305 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+/*\
+ |   ____        _ _            _    _   _ _____
+ |  / ___| _ __ | (_)_ __   ___| |  | | | |_   _|
+ |  \___ \| '_ \| | | '_ \ / _ \ |  | | | | | |
+ |   ___) | |_) | | | | | |  __/ |__| |_| | | |
+ |  |____/| .__/|_|_|_| |_|\___|_____\___/  |_|
+ |        |_|
+\*/
+
+namespace Splines {
+
+  //!
+  //! Interpolation used by the cells of a uniform-grid table.
+  //!
+  using SplineLUTType = enum class SplineLUTType : integer {
+    LINEAR  = 0, //!< (bi)linear on the node values
+    HERMITE = 1  //!< (bi)cubic Hermite on the node values and derivatives
+  };
+
+  extern char const * to_string( SplineLUTType t );
+
+  class SplineLUTCompiler;
+
+  //!
+  //! Spline resampled on a uniform grid of \f$ [x_{\min},x_{\max}] \f$.
+  //!
+  //! Each cell stores the polynomial coefficients in the local variable
+  //! \f$ s\in[0,1] \f$ (2 for `LINEAR`, 4 for `HERMITE`) contiguously, so
+  //! an evaluation is a multiply, a floor and one load of the cell.
+  //! Outside \f$ [x_{\min},x_{\max}] \f$ the first/last cell is used
+  //! with \f$ s \f$ clamped, i.e. the table is extended constant.
+  //!
+  //! Built by `SplineLUTCompiler`.
+  //!
+  class SplineLUT1D {
+    friend class SplineLUTCompiler;
+
+    #ifndef DOXYGEN_SHOULD_SKIP_THIS
+    SplineLUTType     m_type{SplineLUTType::HERMITE};
+    integer           m_stride{4};
+    integer           m_ncells{0};
+    real_type         m_x_min{0};
+    real_type         m_x_max{0};
+    real_type         m_inv_dx{0};
+    vector<real_type> m_coeffs;
+    real_type         m_max_error{0};
+    real_type         m_tolerance{0};
+    integer           m_passes{0};
+
+    real_type const *
+    cell( real_type x, real_type & s ) const {
+      real_type t{ (x - m_x_min) * m_inv_dx };
+      t = std::clamp( t, real_type(0), real_type(m_ncells) );
+      integer const i{ std::min( static_cast<integer>(t), m_ncells-1 ) };
+      s = t - i;
+      return m_coeffs.data() + i*m_stride;
+    }
+    #endif
+
+  public:
+
+    //! value at `x`
+    real_type
+    eval( real_type const x ) const {
+      real_type s;
+      real_type const * c{ this->cell( x, s ) };
+      if ( m_type == SplineLUTType::LINEAR ) return c[0] + s*c[1];
+      return c[0] + s*(c[1] + s*(c[2] + s*c[3]));
+    }
+
+    //! first derivative at `x`
+    real_type
+    D( real_type const x ) const {
+      real_type s;
+      real_type const * c{ this->cell( x, s ) };
+      if ( m_type == SplineLUTType::LINEAR ) return c[1]*m_inv_dx;
+      return (c[1] + s*(2*c[2] + 3*s*c[3]))*m_inv_dx;
+    }
+
+    //! value at `x`
+    real_type operator () ( real_type const x ) const { return this->eval(x); }
+
+    //! evaluate the table at `n` points
+    void
+    eval( real_type const x[], real_type y[], integer n ) const {
+      for ( integer i{0}; i < n; ++i ) y[i] = this->eval( x[i] );
+    }
+
+    SplineLUTType type()      const { return m_type; }   //!< cell interpolation
+    integer       num_cells() const { return m_ncells; } //!< number of cells
+    real_type     x_min()     const { return m_x_min; }  //!< left end of the table
+    real_type     x_max()     const { return m_x_max; }  //!< right end of the table
+
+    //! bound of the max abs error against the input spline
+    real_type max_error() const { return m_max_error; }
+
+    //! `true` if `max_error` is within the tolerance requested
+    bool tolerance_met() const { return m_max_error <= m_tolerance; }
+
+    //! bytes used by the table
+    size_t
+    memory_bytes() const
+    { return sizeof(*this) + m_coeffs.capacity()*sizeof(real_type); }
+
+    //! one line description of the table
+    string info() const;
+  };
+
+  //!
+  //! Surface resampled on a uniform grid of
+  //! \f$ [x_{\min},x_{\max}]\times[y_{\min},y_{\max}] \f$.
+  //!
+  //! Each cell stores the coefficients of \f$ \sum c_{ij} s^i t^j \f$
+  //! (4 for `LINEAR`, 16 for `HERMITE`) contiguously; out of range
+  //! the table is extended constant as `SplineLUT1D`.
+  //!
+  class SplineLUT2D {
+    friend class SplineLUTCompiler;
+
+    #ifndef DOXYGEN_SHOULD_SKIP_THIS
+    SplineLUTType     m_type{SplineLUTType::HERMITE};
+    integer           m_stride{16};
+    integer           m_nx{0};
+    integer           m_ny{0};
+    real_type         m_x_min{0};
+    real_type         m_x_max{0};
+    real_type         m_y_min{0};
+    real_type         m_y_max{0};
+    real_type         m_inv_dx{0};
+    real_type         m_inv_dy{0};
+    vector<real_type> m_coeffs; // cell (i,j) at (i*m_ny+j)*m_stride
+    real_type         m_max_error{0};
+    real_type         m_tolerance{0};
+    integer           m_passes{0};
+
+    real_type const *
+    cell( real_type x, real_type y, real_type & s, real_type & t ) const {
+      real_type u{ (x - m_x_min) * m_inv_dx };
+      real_type v{ (y - m_y_min) * m_inv_dy };
+      u = std::clamp( u, real_type(0), real_type(m_nx) );
+      v = std::clamp( v, real_type(0), real_type(m_ny) );
+      integer const i{ std::min( static_cast<integer>(u), m_nx-1 ) };
+      integer const j{ std::min( static_cast<integer>(v), m_ny-1 ) };
+      s = u - i;
+      t = v - j;
+      return m_coeffs.data() + (i*m_ny+j)*m_stride;
+    }
+    #endif
+
+  public:
+
+    //! value at `(x,y)`
+    real_type
+    eval( real_type const x, real_type const y ) const {
+      real_type s, t;
+      real_type const * c{ this->cell( x, y, s, t ) };
+      if ( m_type == SplineLUTType::LINEAR )
+        return c[0] + s*c[1] + t*(c[2] + s*c[3]);
+      real_type r[4];
+      for ( integer i{0}; i < 4; ++i, c += 4 ) r[i] = c[0] + t*(c[1] + t*(c[2] + t*c[3]));
+      return r[0] + s*(r[1] + s*(r[2] + s*r[3]));
+    }
+
+    //! x-derivative at `(x,y)`
+    real_type
+    Dx( real_type const x, real_type const y ) const {
+      real_type s, t;
+      real_type const * c{ this->cell( x, y, s, t ) };
+      if ( m_type == SplineLUTType::LINEAR ) return (c[1] + t*c[3])*m_inv_dx;
+      real_type r[4];
+      for ( integer i{0}; i < 4; ++i, c += 4 ) r[i] = c[0] + t*(c[1] + t*(c[2] + t*c[3]));
+      return (r[1] + s*(2*r[2] + 3*s*r[3]))*m_inv_dx;
+    }
+
+    //! y-derivative at `(x,y)`
+    real_type
+    Dy( real_type const x, real_type const y ) const {
+      real_type s, t;
+      real_type const * c{ this->cell( x, y, s, t ) };
+      if ( m_type == SplineLUTType::LINEAR ) return (c[2] + s*c[3])*m_inv_dy;
+      real_type r[4];
+      for ( integer i{0}; i < 4; ++i, c += 4 ) r[i] = c[1] + t*(2*c[2] + 3*t*c[3]);
+      return (r[0] + s*(r[1] + s*(r[2] + s*r[3])))*m_inv_dy;
+    }
+
+    //! value at `(x,y)`
+    real_type
+    operator () ( real_type const x, real_type const y ) const
+    { return this->eval( x, y ); }
+
+    SplineLUTType type()        const { return m_type; }  //!< cell interpolation
+    integer       num_cells_x() const { return m_nx; }    //!< cells along x
+    integer       num_cells_y() const { return m_ny; }    //!< cells along y
+    real_type     x_min()       const { return m_x_min; } //!< table x range
+    real_type     x_max()       const { return m_x_max; } //!< table x range
+    real_type     y_min()       const { return m_y_min; } //!< table y range
+    real_type     y_max()       const { return m_y_max; } //!< table y range
+
+    //! bound of the max abs error against the input surface
+    real_type max_error() const { return m_max_error; }
+
+    //! `true` if `max_error` is within the tolerance requested
+    bool tolerance_met() const { return m_max_error <= m_tolerance; }
+
+    //! bytes used by the table
+    size_t
+    memory_bytes() const
+    { return sizeof(*this) + m_coeffs.capacity()*sizeof(real_type); }
+
+    //! one line description of the table
+    string info() const;
+  };
+
+  //!
+  //! Compile splines into uniform-grid tables (`SplineLUT1D`, `SplineLUT2D`)
+  //! with the resolution chosen to meet a tolerance.
+  //!
+  //! The table nodes are filled with `eval`/`D` (`eval`/`D`/`Dxy` for
+  //! surfaces) of the input, split among the threads of the compiler.
+  //! The error is bounded on each piece of a cell inside one polynomial
+  //! segment (patch for surfaces) of the input, so the knots of the input
+  //! are never missed: by the end values plus the interpolation remainder
+  //! for splines, by the Bernstein coefficients of the error for surfaces;
+  //! if the bound exceeds the tolerance the number of cells is increased using
+  //! the convergence order of the cells (\f$ h^4 \f$ for `HERMITE`,
+  //! \f$ h^2 \f$ for `LINEAR`, at least doubled) and the table is rebuilt.
+  //! Inputs that are not smooth enough (e.g. `ConstantSpline`) stop at the
+  //! memory limit; check `tolerance_met()` of the result.
+  //!
+  class SplineLUTCompiler {
+
+    #ifndef DOXYGEN_SHOULD_SKIP_THIS
+    real_type                         m_tolerance{1e-6};
+    SplineLUTType                     m_type{SplineLUTType::HERMITE};
+    size_t                            m_max_bytes{size_t(64) << 20};
+    std::unique_ptr<WorkStealingPool> m_pool;
+
+    void fill( Spline const & S, SplineLUT1D & T, integer ncells );
+    void fill( SplineSurf const & S, SplineLUT2D & T, integer nx, integer ny );
+    #endif
+
+  public:
+
+    SplineLUTCompiler( SplineLUTCompiler const & ) = delete;
+    SplineLUTCompiler const & operator = ( SplineLUTCompiler const & ) = delete;
+
+    //!
+    //! \param tolerance   max abs error requested
+    //! \param type        cell interpolation
+    //! \param num_threads threads used (`0` = hardware concurrency)
+    //!
+    explicit
+    SplineLUTCompiler(
+      real_type     tolerance   = 1e-6,
+      SplineLUTType type        = SplineLUTType::HERMITE,
+      integer       num_threads = 0
+    );
+
+    ~SplineLUTCompiler();
+
+    //! set the max abs error requested
+    void set_tolerance( real_type tol );
+
+    //! set the cell interpolation
+    void set_type( SplineLUTType t ) { m_type = t; }
+
+    //! set the max size of a table (the refinement stops there)
+    void set_max_bytes( size_t bytes );
+
+    real_type     tolerance() const { return m_tolerance; } //!< max abs error requested
+    SplineLUTType type()      const { return m_type; }      //!< cell interpolation
+    size_t        max_bytes() const { return m_max_bytes; } //!< max size of a table
+
+    //! table of `S` on \f$ [x_{\min},x_{\max}] \f$ of its nodes
+    void compile( Spline const & S, SplineLUT1D & T );
+
+    //! table of the column `spl` of `S`
+    void compile( SplineSet const & S, integer spl, SplineLUT1D & T );
+
+    //! table of `S` on the rectangle of its nodes
+    void compile( SplineSurf const & S, SplineLUT2D & T );
+  };
+
+}
+
+// EOF: SplineLUT.hxx
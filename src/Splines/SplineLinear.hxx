@@ -39,6 +39,7 @@ namespace Splines {
 
     #ifndef DOXYGEN_SHOULD_SKIP_THIS
     using Spline::build;
+    using Spline::y_min_max;
     #endif
 
     //!
@@ -77,6 +78,8 @@ namespace Splines {
     real_type id_DD   ( integer const   , real_type const   ) const override { return 0; }
     real_type id_DDD  ( integer const   , real_type const   ) const override { return 0; }
 
+    real_type id_integral( integer const ni, real_type const a, real_type const b ) const override;
+
     void write_to_stream( ostream_type & s ) const override;
     SplineType1D type() const override { return SplineType1D::LINEAR; }
 
@@ -136,6 +139,7 @@ namespace Splines {
       copy_n( S.m_X, m_npts, m_X );
       copy_n( S.m_Y, m_npts, m_Y );
       copy_flags( S );
+      m_search.must_reset();
     }
 
   };
@@ -88,6 +88,9 @@ namespace Splines {
     setQuinticType( QuinticSpline_sub_type qt )
     { m_q_sub_type = qt; }
 
+    //! \return the method used to estimate the derivatives
+    QuinticSpline_sub_type quintic_type() const { return m_q_sub_type; }
+
     // --------------------------- VIRTUALS -----------------------------------
     //! Build a Monotone quintic spline from previously inserted points
     void build() override;
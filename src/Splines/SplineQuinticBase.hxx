@@ -52,6 +52,7 @@ namespace Splines {
 
     #ifndef DOXYGEN_SHOULD_SKIP_THIS
     using Spline::build;
+    using Spline::y_min_max;
     #endif
 
     //!
@@ -74,6 +75,25 @@ namespace Splines {
     //!
     void copy_spline( QuinticSplineBase const & S );
 
+    //!
+    //! Build the spline from values and first and second derivatives
+    //! at the nodes (no derivative is recomputed).
+    //!
+    //! \param[in] x   vector of x-coordinates
+    //! \param[in] y   vector of y-coordinates
+    //! \param[in] yp  vector of y'-coordinates
+    //! \param[in] ypp vector of y''-coordinates
+    //! \param[in] n   total number of points
+    //!
+    void
+    build(
+      real_type const x[],
+      real_type const y[],
+      real_type const yp[],
+      real_type const ypp[],
+      integer         n
+    );
+
     //!
     //! \name Info
     //!
@@ -180,6 +200,19 @@ namespace Splines {
     real_type id_DDD   ( integer const ni, real_type const x ) const override;
     real_type id_DDDD  ( integer const ni, real_type const x ) const override;
     real_type id_DDDDD ( integer const ni, real_type const x ) const override;
+
+    real_type id_integral( integer const ni, real_type const a, real_type const b ) const override;
+
+    void
+    id_y_min_max(
+      integer   const ni,
+      real_type const a,
+      real_type const b,
+      real_type     & x_min_pos,
+      real_type     & y_min,
+      real_type     & x_max_pos,
+      real_type     & y_max
+    ) const override;
     ///@}
 
     void reserve( integer npts ) override;
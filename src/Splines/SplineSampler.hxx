@@ -0,0 +1,135 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+/*\
+ |   ____        _ _            ____                        _
+ |  / ___| _ __ | (_)_ __   ___/ ___|  __ _ _ __ ___  _ __ | | ___ _ __
+ |  \___ \| '_ \| | | '_ \ / _ \___ \ / _` | '_ ` _ \| '_ \| |/ _ \ '__|
+ |   ___) | |_) | | | | | |  __/___) | (_| | | | | | | |_) | |  __/ |
+ |  |____/| .__/|_|_|_| |_|\___|____/ \__,_|_| |_| |_| .__/|_|\___|_|
+ |        |_|                                         |_|
+\*/
+
+namespace Splines {
+
+  //!
+  //! How `SplineSampler` measures the distance of the polyline
+  //! of the samples from the curve.
+  //!
+  using SplineSampleMode = enum class SplineSampleMode : integer {
+    VALUE = 0, //!< max abs difference of the values (of each column/component)
+    CHORD = 1  //!< distance from the chord in the plot plane (see `set_scale`)
+  };
+
+  //!
+  //! Adaptive sampling of splines for plotting and export.
+  //!
+  //! Alternative to the uniform `Spline::dump`, `SplineSet::dump_table`
+  //! and `SplineVec::dump_table`: the nodes are always sampled and every
+  //! interval between nodes is bisected until the polyline of the samples
+  //! is within the tolerance from the curve. The distance on a segment of
+  //! width \f$ h \f$ is bounded by \f$ h^2 \max|y''|/8 \f$ with \f$ y'' \f$
+  //! evaluated at the ends and at the middle of the segment on the piece of
+  //! the interval (no search); the bound is exact for piecewise cubics.
+  //! Linear pieces get no extra samples, curved ones get
+  //! \f$ O(h\sqrt{|y''|/\epsilon}) \f$.
+  //!
+  //! The output is written in blocks of intervals: each block is sampled
+  //! and formatted (shortest round-trip representation) into a buffer by a
+  //! task of the sampler pool, then the buffers are written in order on
+  //! the stream.
+  //!
+  class SplineSampler {
+
+    #ifndef DOXYGEN_SHOULD_SKIP_THIS
+    real_type                         m_tolerance{1e-3};
+    SplineSampleMode                  m_mode{SplineSampleMode::VALUE};
+    real_type                         m_sx{1};
+    real_type                         m_sy{1};
+    integer                           m_max_depth{20};
+    integer                           m_num_samples{0};
+    std::unique_ptr<WorkStealingPool> m_pool;
+
+    template <typename SRC>
+    void run( SRC const & src, vector<real_type> * xs, ostream_type * s );
+    #endif
+
+  public:
+
+    SplineSampler( SplineSampler const & ) = delete;
+    SplineSampler const & operator = ( SplineSampler const & ) = delete;
+
+    //!
+    //! \param tolerance   max distance of the polyline from the curve
+    //! \param num_threads threads used (`0` = hardware concurrency)
+    //!
+    explicit
+    SplineSampler( real_type tolerance = 1e-3, integer num_threads = 0 );
+
+    ~SplineSampler();
+
+    //! set the max distance of the polyline from the curve
+    void set_tolerance( real_type tol );
+
+    //! set how the distance is measured
+    void set_mode( SplineSampleMode mode ) { m_mode = mode; }
+
+    //!
+    //! Units of the plot for the `CHORD` mode: a point \f$ (x,y) \f$ is
+    //! drawn at \f$ (s_x x, s_y y) \f$ (e.g. pixels per unit), so the
+    //! tolerance is a visual one (e.g. half a pixel). For a `SplineVec`
+    //! the distance is the euclidean one of the curve and the scale is not used.
+    //!
+    void set_scale( real_type sx, real_type sy );
+
+    //! set the max number of bisections of an interval
+    void set_max_depth( integer depth );
+
+    real_type        tolerance() const { return m_tolerance; } //!< max distance from the curve
+    SplineSampleMode mode()      const { return m_mode; }      //!< how the distance is measured
+    integer          max_depth() const { return m_max_depth; } //!< max bisections of an interval
+
+    //! number of samples of the last `sample` or `dump`
+    integer num_samples() const { return m_num_samples; }
+
+    //! \name Samples
+    ///@{
+    void sample( Spline    const & S, vector<real_type> & x ); //!< abscissae of the samples of `S`
+    void sample( SplineSet const & S, vector<real_type> & x ); //!< common abscissae for all the splines
+    void sample( SplineVec const & S, vector<real_type> & x ); //!< parameters of the samples of the curve
+    ///@}
+
+    //! \name Dump Data
+    ///@{
+
+    //! write `x` and `y` of the samples as `Spline::dump`
+    void dump( Spline const & S, ostream_type & s, string_view header = "x\ty" );
+
+    //! write the samples as `SplineSet::dump_table`
+    void dump_table( SplineSet const & S, ostream_type & s );
+
+    //! write the samples as `SplineVec::dump_table`
+    void dump_table( SplineVec const & S, ostream_type & s );
+
+    ///@}
+  };
+
+}
+
+// EOF: SplineSampler.hxx
@@ -77,8 +77,58 @@ namespace Splines {
 
     std::map<string,integer> m_header_to_position;
 
+    // storage borrowed by `load_binary`
+    std::unique_ptr<MappedFile> m_mapped;
+
+    // columns `X`, `Y` filled by `load_csv` / `load_raw`
+    std::unique_ptr<real_type[]> m_table;
+
+    #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+    // columns evaluated with the same kernel after one shared interval search.
+    // When the set owns its data (`build`) the group keeps them point major,
+    // `Y[i*cols.size()+c]` is node `i` of column `cols[c]`; borrowed, mapped
+    // or loaded columns are read in place through `pY`, `pYp`, `pYpp`
+    struct ColumnGroup {
+      SplineType1D              type{SplineType1D::CUBIC}; // CONSTANT, LINEAR, CUBIC (any Hermite cubic) or QUINTIC
+      bool                      extended_constant{false};
+      vector<integer>           cols;
+      vector<real_type>         Y, Yp, Ypp;
+      vector<real_type const *> pY, pYp, pYpp;
+    };
+
+    bool                               m_owned{false}; // data allocated by `build`
+    mutable vector<ColumnGroup>        m_groups;
+    mutable vector<integer>            m_generic_cols;  // evaluated with a virtual call
+    mutable std::atomic<unsigned long> m_groups_key{0}; // `splines_key()` when grouped
+    mutable std::mutex                 m_groups_mutex;
+
+    bool           m_closed{false};
+    bool           m_can_extend{true};
+    mutable SearchInterval m_search; // shared by all the grouped columns
+
+    friend class SplineCompressor; // regroups the columns after copying the flags
+
+    unsigned long splines_key() const;
+    void build_groups() const;
+    void eval_grouped( real_type x, integer deriv, real_type vals[], integer incy ) const;
+
+    #endif
+
   private:
 
+    void
+    build_internal(
+      integer                    nspl,
+      integer                    npts,
+      char         const * const headers[],
+      SplineType1D const         stype[],
+      real_type    const         X[],
+      real_type    const * const Y[],
+      real_type    const * const Yp[],
+      bool                       borrow
+    );
+
     //!
     //! find `x` value such that the monotone spline
     //! `(spline[spl])(x)` intersect the value `zeta`
@@ -224,6 +274,11 @@ namespace Splines {
     //!
     //! Return pointer to the `i`-th spline.
     //!
+    //! \note the evaluation of all the splines (`eval(x,vals)` and derivatives)
+    //!       groups the columns by type and flags; a spline rebuilt or with
+    //!       flags changed through this pointer is regrouped at the next
+    //!       evaluation (not concurrently with evaluations).
+    //!
     Spline * get_spline( integer i ) const;
 
     //!
@@ -430,6 +485,61 @@ namespace Splines {
 
     ///@}
 
+    //! \name Integration
+    ///@{
+
+    //!
+    //! Definite integral of spline n. `spl` from `a` to `b`.
+    //!
+    real_type
+    integral( real_type const a, real_type const b, integer const spl ) const {
+      Spline const * S{ this->get_spline(spl) };
+      return S->integral(a,b);
+    }
+
+    //!
+    //! Definite integral of spline `name` from `a` to `b`.
+    //!
+    real_type
+    integral( real_type const a, real_type const b, string_view name ) const {
+      Spline const * S{ this->get_spline(name) };
+      return S->integral(a,b);
+    }
+
+    //!
+    //! Definite integrals of spline n. `spl` from `a[k]` to `b[k]`,
+    //! `k=0..n-1`, stored in `out[k]`.
+    //!
+    void
+    integral(
+      real_type const a[],
+      real_type const b[],
+      real_type       out[],
+      integer   const n,
+      integer   const spl
+    ) const {
+      Spline const * S{ this->get_spline(spl) };
+      S->integral( a, b, out, n );
+    }
+
+    //!
+    //! Definite integrals of spline `name` from `a[k]` to `b[k]`,
+    //! `k=0..n-1`, stored in `out[k]`.
+    //!
+    void
+    integral(
+      real_type const a[],
+      real_type const b[],
+      real_type       out[],
+      integer   const n,
+      string_view     name
+    ) const {
+      Spline const * S{ this->get_spline(name) };
+      S->integral( a, b, out, n );
+    }
+
+    ///@}
+
     #ifdef AUTIDIFF_SUPPORT
     //!
     //! \name Autodiff
@@ -1422,6 +1532,29 @@ namespace Splines {
       real_type    const * const Yp[] = nullptr
     );
 
+    //!
+    //! Build a set of splines using the caller arrays without copying them.
+    //!
+    //! Only the derivative arrays (`Yp` of cubic splines, `Yp` and `Ypp` of
+    //! quintic splines) are allocated; `X`, `Y` and the `Yp` of Hermite
+    //! splines are used in place.
+    //!
+    //! \warning the borrowed arrays are never written, but they must stay
+    //! valid and unchanged until the set is destroyed or built again.
+    //!
+    //! Arguments are the same of `build`.
+    //!
+    void
+    build_external(
+      integer                    nspl,
+      integer                    npts,
+      char         const * const headers[],
+      SplineType1D const         stype[],
+      real_type    const         X[],
+      real_type    const * const Y[],
+      real_type    const * const Yp[] = nullptr
+    );
+
     //!
     //! Copy to SplineSet `S`
     //!
@@ -1443,6 +1576,86 @@ namespace Splines {
 
     ///@}
 
+    //!
+    //! \name Binary I/O
+    //!
+    //! The file stores the built spline set (nodes, values and derivatives)
+    //! with a magic string, an endianness tag and a format version.
+    //! Loading does not recompute the splines: the arrays are used
+    //! in place from the (memory mapped) file.
+    //!
+    ///@{
+
+    //!
+    //! Save the built spline set to the binary file `file_name`
+    //!
+    void save_binary( string_view file_name ) const;
+
+    //!
+    //! Load a spline set saved with `save_binary`.
+    //!
+    //! \param file_name the binary file
+    //! \param use_mmap  if `true` the file is memory mapped and the splines
+    //!                  use its pages directly, otherwise it is read in memory
+    //!
+    void load_binary( string_view file_name, bool use_mmap = true );
+
+    ///@}
+
+    //!
+    //! \name Table loading
+    //!
+    //! Stream a table of columns from a file directly into the storage
+    //! of the spline set and build it (no intermediate copies).
+    //! The first column is `X`, the others are the `Y` of the splines.
+    //! Hermite splines are not allowed (no derivative columns).
+    //!
+    ///@{
+
+    //!
+    //! Load a CSV table: the first row contains the headers (names of the
+    //! splines), the following rows the values. The file is read in blocks
+    //! parsed in parallel.
+    //!
+    //! \param file_name   the CSV file
+    //! \param stype       the type of each spline (one for each `Y` column)
+    //! \param sep         the field separator
+    //! \param num_threads number of parsing threads (0 = hardware concurrency)
+    //!
+    void
+    load_csv(
+      string_view                  file_name,
+      vector<SplineType1D> const & stype,
+      char                         sep         = ',',
+      integer                      num_threads = 0
+    );
+
+    //!
+    //! Load a CSV table using the same spline type for all the columns.
+    //!
+    void
+    load_csv(
+      string_view  file_name,
+      SplineType1D stype,
+      char         sep         = ',',
+      integer      num_threads = 0
+    );
+
+    //!
+    //! Load a raw binary table: `headers.size()+1` columns of `npts`
+    //! little endian doubles stored one after the other (`X` first).
+    //! If `npts` is 0 it is deduced from the file size.
+    //!
+    void
+    load_raw(
+      string_view                  file_name,
+      vector<string>       const & headers,
+      vector<SplineType1D> const & stype,
+      integer                      npts = 0
+    );
+
+    ///@}
+
     //! Return spline type (as number)
     SplineType1D type() const { return SplineType1D::SPLINE_SET; }
 
@@ -0,0 +1,353 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+/*\
+ |   ____  _        _   _      ____        _ _
+ |  / ___|| |_ __ _| |_(_) ___/ ___| _ __ | (_)_ __   ___
+ |  \___ \| __/ _` | __| |/ __\___ \| '_ \| | | '_ \ / _ \
+ |   ___) | || (_| | |_| | (__ ___) | |_) | | | | | |  __/
+ |  |____/ \__\__,_|\__|_|\___|____/| .__/|_|_|_| |_|\___|
+ |                                  |_|
+\*/
+
+namespace Splines {
+
+  //!
+  //! Behaviour of a `StaticSpline` outside the range of the nodes.
+  //!
+  using SplineBoundary = enum class SplineBoundary : integer {
+    CLAMP       = 0, //!< `x` is clamped to the range of the nodes
+    EXTRAPOLATE = 1, //!< the first/last polynomial is extended
+    PERIODIC    = 2, //!< `x` is wrapped in the range (closed curve)
+    CONSTANT    = 3  //!< extended with the first/last value, zero derivatives
+  };
+
+  //!
+  //! Spline with type and boundary behaviour fixed at compile time.
+  //!
+  //! Header only: each segment is stored as a polynomial (`order` coefficients,
+  //! highest degree first, in the local variable `x-x[i]`), the interval is
+  //! found by binary search and the boundary policy is resolved with
+  //! `if constexpr`, so `eval` and derivatives can be fully inlined.
+  //!
+  //! - `KIND`: any `SplineType1D` except `SPLINE_SET` and `SPLINE_VEC`.
+  //!   `CUBIC`, `AKIMA`, `BESSEL`, `PCHIP` and `HERMITE` share the piecewise
+  //!   cubic representation and differ only in how `build` computes the slopes.
+  //! - `BC`: the `SplineBoundary` policy.
+  //!
+  //! A `StaticSpline` can be built from a runtime spline of the same order
+  //! and converted back with `to_spline`.
+  //!
+  template <SplineType1D KIND, SplineBoundary BC = SplineBoundary::EXTRAPOLATE>
+  class StaticSpline {
+
+    static_assert(
+      KIND != SplineType1D::SPLINE_SET && KIND != SplineType1D::SPLINE_VEC,
+      "StaticSpline: KIND must be a single 1D spline type"
+    );
+
+  public:
+
+    //! number of coefficients of each polynomial
+    static constexpr integer order{
+      KIND == SplineType1D::CONSTANT ? 1 :
+      KIND == SplineType1D::LINEAR   ? 2 :
+      KIND == SplineType1D::QUINTIC  ? 6 : 4
+    };
+
+  private:
+
+    #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+    vector<real_type> m_X; // nodes
+    vector<real_type> m_C; // `order` coefficients for each segment
+
+    integer nseg() const { return integer(m_X.size())-1; }
+
+    // segment containing `x`, `x` is changed according to the policy
+    integer
+    locate( real_type & x ) const {
+      real_type const a{ m_X.front() };
+      real_type const b{ m_X.back() };
+      if constexpr ( BC == SplineBoundary::PERIODIC ) {
+        if ( x < a || x > b ) x -= (b-a) * std::floor( (x-a)/(b-a) );
+      } else if constexpr ( BC == SplineBoundary::CLAMP ) {
+        x = std::clamp( x, a, b );
+      }
+      integer i{ integer( std::upper_bound( m_X.begin(), m_X.end(), x ) - m_X.begin() ) - 1 };
+      return std::clamp( i, integer(0), nseg()-1 );
+    }
+
+    // `DER`-th derivative of the polynomial of segment `i` at `x`
+    template <integer DER>
+    real_type
+    eval_poly( integer i, real_type x ) const {
+      if constexpr ( DER >= order ) {
+        return 0;
+      } else {
+        real_type const   s{ x - m_X[size_t(i)] };
+        real_type const * c{ m_C.data() + size_t(i)*order };
+        real_type res{0};
+        for ( integer k{0}; k < order-DER; ++k ) {
+          // coefficient of s^p (p = order-1-k) differentiated DER times
+          integer   p{ order-1-k };
+          real_type f{1};
+          for ( integer j{0}; j < DER; ++j ) f *= p-j;
+          res = res*s + f*c[k];
+        }
+        return res;
+      }
+    }
+
+    template <integer DER>
+    real_type
+    eval_der( real_type x ) const {
+      if constexpr ( BC == SplineBoundary::CONSTANT ) {
+        if ( x <= m_X.front() ) return DER == 0 ? eval_poly<0>( 0, m_X.front() ) : 0;
+        if ( x >= m_X.back()  ) return DER == 0 ? eval_poly<0>( nseg()-1, m_X.back() ) : 0;
+      }
+      integer i{ locate( x ) };
+      return eval_poly<DER>( i, x );
+    }
+
+    // store polynomials from values `y` and slopes `yp` at the nodes
+    void
+    from_hermite( real_type const y[], real_type const yp[], real_type const ypp[] ) {
+      integer n{ nseg() };
+      m_C.resize( size_t(n*order) );
+      for ( integer i{0}; i < n; ++i ) {
+        real_type * c{ m_C.data() + size_t(i)*order };
+        real_type   h{ m_X[size_t(i+1)] - m_X[size_t(i)] };
+        if constexpr ( order == 1 ) {
+          c[0] = y[i];
+        } else if constexpr ( order == 2 ) {
+          c[0] = (y[i+1]-y[i])/h;
+          c[1] = y[i];
+        } else if constexpr ( order == 4 ) {
+          Hermite3_to_poly( h, y[i], y[i+1], yp[i], yp[i+1], c[0], c[1], c[2], c[3] );
+        } else {
+          Hermite5_to_poly(
+            h, y[i], y[i+1], yp[i], yp[i+1], ypp[i], ypp[i+1],
+            c[0], c[1], c[2], c[3], c[4], c[5]
+          );
+        }
+      }
+    }
+
+    #endif
+
+  public:
+
+    //!
+    //! \name Constructors
+    //!
+    ///@{
+
+    StaticSpline() = default;
+
+    //!
+    //! Build from a runtime spline of the same order, see `assign`.
+    //!
+    explicit
+    StaticSpline( Spline const & S ) { this->assign( S ); }
+
+    ///@}
+
+    //!
+    //! \name Build
+    //!
+    ///@{
+
+    //!
+    //! Build interpolating `(x[i],y[i])`, the slopes are computed
+    //! as in the runtime spline of type `KIND`.
+    //!
+    void
+    build( real_type const x[], real_type const y[], integer n ) {
+      static_assert(
+        KIND != SplineType1D::HERMITE && KIND != SplineType1D::QUINTIC,
+        "StaticSpline::build(x,y,n) not available for HERMITE and QUINTIC"
+      );
+      UTILS_ASSERT( n >= 2, "StaticSpline::build, npts = {} must be >= 2\n", n );
+      m_X.assign( x, x+n );
+      vector<real_type> yp;
+      if constexpr ( order == 4 ) {
+        yp.resize( size_t(n) );
+        if constexpr ( KIND == SplineType1D::CUBIC ) {
+          CubicSpline_build( x, y, yp.data(), n, CubicSpline_BC::EXTRAPOLATE, CubicSpline_BC::EXTRAPOLATE );
+        } else if constexpr ( KIND == SplineType1D::AKIMA ) {
+          vector<real_type> work( static_cast<size_t>(n) );
+          Akima_build( x, y, yp.data(), work.data(), n );
+        } else if constexpr ( KIND == SplineType1D::BESSEL ) {
+          Bessel_build( x, y, yp.data(), n );
+        } else {
+          Pchip_build( x, y, yp.data(), n );
+        }
+      }
+      from_hermite( y, yp.data(), nullptr );
+    }
+
+    //!
+    //! Build a piecewise cubic from values and slopes (`order` must be 4).
+    //!
+    void
+    build( real_type const x[], real_type const y[], real_type const yp[], integer n ) {
+      static_assert( order == 4, "StaticSpline::build(x,y,yp,n) needs a cubic KIND" );
+      UTILS_ASSERT( n >= 2, "StaticSpline::build, npts = {} must be >= 2\n", n );
+      m_X.assign( x, x+n );
+      from_hermite( y, yp, nullptr );
+    }
+
+    //!
+    //! Build a piecewise quintic from values and first and second derivatives.
+    //!
+    void
+    build(
+      real_type const x[],
+      real_type const y[],
+      real_type const yp[],
+      real_type const ypp[],
+      integer         n
+    ) {
+      static_assert( order == 6, "StaticSpline::build(x,y,yp,ypp,n) needs KIND = QUINTIC" );
+      UTILS_ASSERT( n >= 2, "StaticSpline::build, npts = {} must be >= 2\n", n );
+      m_X.assign( x, x+n );
+      from_hermite( y, yp, ypp );
+    }
+
+    //!
+    //! Copy the runtime spline `S` (same order, for the cubic kinds `S`
+    //! must derive from `CubicSplineBase`, for `QUINTIC` from `QuinticSplineBase`).
+    //!
+    void
+    assign( Spline const & S ) {
+      integer n{ S.num_points() };
+      UTILS_ASSERT(
+        S.order() == order && n >= 2,
+        "StaticSpline::assign( {} ), order = {} (expected {}), npts = {}\n",
+        S.name(), S.order(), order, n
+      );
+      m_X.resize( size_t(n) );
+      vector<real_type> y( static_cast<size_t>(n) ), yp, ypp;
+      for ( integer i{0}; i < n; ++i ) {
+        m_X[size_t(i)] = S.x_node(i);
+        y[size_t(i)]   = S.y_node(i);
+      }
+      if constexpr ( order == 4 ) {
+        auto * C{ dynamic_cast<CubicSplineBase const *>( &S ) };
+        UTILS_ASSERT( C != nullptr, "StaticSpline::assign( {} ), not a cubic spline\n", S.name() );
+        yp.assign( C->yp_nodes(), C->yp_nodes()+n );
+      } else if constexpr ( order == 6 ) {
+        auto * Q{ dynamic_cast<QuinticSplineBase const *>( &S ) };
+        UTILS_ASSERT( Q != nullptr, "StaticSpline::assign( {} ), not a quintic spline\n", S.name() );
+        yp.assign( Q->yp_nodes(), Q->yp_nodes()+n );
+        ypp.assign( Q->ypp_nodes(), Q->ypp_nodes()+n );
+      }
+      from_hermite( y.data(), yp.data(), ypp.data() );
+    }
+
+    //!
+    //! Build a runtime spline equal to this one
+    //! (`HermiteSpline` for the cubic kinds).
+    //!
+    //! `CLAMP` is mapped to an extended constant spline: the values outside
+    //! the range are the same, but the runtime spline has zero derivatives
+    //! there while `StaticSpline` returns the derivatives at the end point.
+    //!
+    std::unique_ptr<Spline>
+    to_spline( string_view name = "StaticSpline" ) const {
+      integer n{ num_points() };
+      vector<real_type> y( static_cast<size_t>(n) ), yp( static_cast<size_t>(n) ), ypp( static_cast<size_t>(n) );
+      for ( integer i{0}; i < n; ++i ) {
+        integer   k{ std::min( i, n-2 ) };
+        real_type x{ m_X[size_t(i)] };
+        y[size_t(i)]   = eval_poly<0>( k, x );
+        yp[size_t(i)]  = eval_poly<1>( k, x );
+        ypp[size_t(i)] = eval_poly<2>( k, x );
+      }
+      std::unique_ptr<Spline> S;
+      if constexpr ( KIND == SplineType1D::CONSTANT ) {
+        S = std::make_unique<ConstantSpline>( name );
+        S->build( m_X.data(), y.data(), n );
+      } else if constexpr ( KIND == SplineType1D::LINEAR ) {
+        S = std::make_unique<LinearSpline>( name );
+        S->build( m_X.data(), y.data(), n );
+      } else if constexpr ( KIND == SplineType1D::QUINTIC ) {
+        auto Q{ std::make_unique<QuinticSpline>( name ) };
+        Q->QuinticSplineBase::build( m_X.data(), y.data(), yp.data(), ypp.data(), n );
+        S = std::move(Q);
+      } else {
+        auto H{ std::make_unique<HermiteSpline>( name ) };
+        H->build( m_X.data(), y.data(), yp.data(), n );
+        S = std::move(H);
+      }
+      switch ( BC ) {
+      case SplineBoundary::CLAMP:       // same values, see above
+      case SplineBoundary::CONSTANT:    S->make_unbounded(); S->make_extended_constant(); break;
+      case SplineBoundary::EXTRAPOLATE: S->make_unbounded(); S->make_extended_not_constant(); break;
+      case SplineBoundary::PERIODIC:    S->make_closed();    S->make_extended_not_constant(); break;
+      }
+      return S;
+    }
+
+    ///@}
+
+    //!
+    //! \name Info
+    //!
+    ///@{
+
+    integer   num_points()          const { return integer(m_X.size()); }
+    real_type x_node( integer i )   const { return m_X[size_t(i)]; }
+    real_type x_min()               const { return m_X.front(); }
+    real_type x_max()               const { return m_X.back(); }
+    real_type const * coeffs()      const { return m_C.data(); } //!< `order` coefficients per segment
+
+    static constexpr SplineType1D   type()     { return KIND; }
+    static constexpr SplineBoundary boundary() { return BC; }
+
+    ///@}
+
+    //!
+    //! \name Evaluation
+    //!
+    ///@{
+
+    real_type eval ( real_type x ) const { return eval_der<0>( x ); }
+    real_type D    ( real_type x ) const { return eval_der<1>( x ); }
+    real_type DD   ( real_type x ) const { return eval_der<2>( x ); }
+    real_type DDD  ( real_type x ) const { return eval_der<3>( x ); }
+    real_type DDDD ( real_type x ) const { return eval_der<4>( x ); }
+    real_type DDDDD( real_type x ) const { return eval_der<5>( x ); }
+
+    real_type operator () ( real_type x ) const { return eval_der<0>( x ); }
+
+    //!
+    //! `y[k] = S(x[k])` for `k=0..n-1`
+    //!
+    void
+    eval( real_type const x[], real_type y[], integer n ) const
+    { for ( integer k{0}; k < n; ++k ) y[k] = eval_der<0>( x[k] ); }
+
+    ///@}
+  };
+
+}
+
+// EOF: SplineStatic.hxx
@@ -39,6 +39,7 @@ namespace Splines {
 
     Utils::Malloc<real_type>  m_mem;
     Utils::Malloc<real_type*> m_mem_p;
+    Utils::Malloc<real_type>  m_mem_interleaved;
 
     integer m_dim{0};
     integer m_npts{0};
@@ -49,10 +50,61 @@ namespace Splines {
     real_type ** m_Y{nullptr};
     real_type ** m_Yp{nullptr};
 
+    // interleaved copy of `m_Y` and `m_Yp`, `[y0..yd, yp0..ypd]` per knot,
+    // `nullptr` while the slopes are not computed for the current data
+    bool        m_use_interleaved{false};
+    bool        m_slopes_ok{false}; // `m_Yp` computed for the current knots and values
+    real_type * m_YYp{nullptr};
+
     SearchInterval m_search;
 
+    // lazy table of the integrals from `m_X[0]` to `m_X[i]`, `m_npts` per component
+    mutable vector<real_type>          m_integral_table;
+    mutable std::atomic<unsigned long> m_integral_generation{0}; // checked without lock
+    mutable std::mutex                 m_integral_mutex;
+
+    real_type const * integral_table() const;
+    real_type id_integral( integer i, real_type a, real_type b, integer j ) const;
+    real_type primitive( real_type const * T, real_type x, integer j ) const;
+
+    // lazy table of the arc length from `m_X[0]` to `m_X[i]`
+    mutable vector<real_type>          m_arc_table;
+    mutable std::atomic<unsigned long> m_arc_generation{0}; // checked without lock
+    mutable std::mutex                 m_arc_mutex;
+
+    real_type const * arc_table() const;
+    real_type id_speed( integer i, real_type x ) const;
+    real_type id_arc_length( integer i, real_type a, real_type b ) const;
+    real_type find_param_at_length( real_type const * L, real_type s ) const;
+
+    // lazy bounding volume hierarchy over the Bezier hulls of the segments.
+    // Node `k` covers segments `[m_bvh_range[2*k],m_bvh_range[2*k+1])`,
+    // its children are `m_bvh_child[2*k]` and `m_bvh_child[2*k+1]` (`-1` for leafs)
+    // and its box is `m_bvh_box[2*dim*k..2*dim*k+2*dim-1]` (min then max)
+    mutable vector<integer>            m_bvh_range;
+    mutable vector<integer>            m_bvh_child;
+    mutable vector<real_type>          m_bvh_box;
+    mutable std::atomic<unsigned long> m_bvh_generation{0}; // checked without lock
+    mutable std::mutex                 m_bvh_mutex;
+
+    void      build_bvh() const;
+    integer   build_bvh( integer lo, integer hi ) const;
+    real_type bvh_box_dist2( integer node, real_type const p[] ) const;
+    real_type id_closest_point( integer i, real_type const p[], real_type & x ) const;
+
     void allocate( integer dim, integer npts );
     void compute_chords();
+    void pack_interleaved();
+    void knots_changed();  // after a change of knots or values
+    void slopes_changed(); // after a change of `m_Yp`
+
+    void
+    combine(
+      integer   const i,
+      real_type const base[4],
+      real_type       vals[],
+      integer   const inc
+    ) const;
 
   public:
 
@@ -127,6 +179,29 @@ namespace Splines {
     void make_buonded() { m_curve_can_extend = false; }
     ///@}
 
+    //!
+    //! \name Memory layout
+    //!
+    ///@{
+
+    //!
+    //! Keep also an interleaved copy of the data where the values
+    //! and the derivatives of all the components at a knot are stored
+    //! contiguously as `[y0..yd, yp0..ypd]`.
+    //! Evaluation of all the components reads a single stream
+    //! instead of `2*dim` separated arrays.
+    //! The copy is dropped by `setup` and by the `set_knots` methods (the
+    //! slopes must be recomputed) and packed again by `catmull_rom`.
+    //!
+    void use_interleaved( bool yes = true );
+
+    //!
+    //! \return `true` if the interleaved copy is available
+    //!
+    bool is_interleaved() const { return m_YYp != nullptr; }
+
+    ///@}
+
     //!
     //! \name Info
     //!
@@ -157,6 +232,11 @@ namespace Splines {
     //!
     real_type const * y_nodes( integer j ) const { return m_Y[j]; }
 
+    //!
+    //! Return the vector of derivatives at the nodes, component `j`
+    //!
+    real_type const * yp_nodes( integer j ) const { return m_Yp[j]; }
+
     //!
     //! Return the npt-th node of the spline (`j` component of y).
     //!
@@ -343,6 +423,49 @@ namespace Splines {
     void eval_DDDDD( real_type const x, real_type vals[], integer const inc ) const;
     ///@}
 
+    //!
+    //! \name Evaluate all the splines on many parameters.
+    //!
+    ///@{
+
+    //!
+    //! Evaluate all the splines at `x[0..n-1]`.
+    //! The point `k` is stored in `out[k*ld+j]`, `j=0..dim-1`, so that
+    //! `out` is a `dim x n` column major matrix with leading dimension `ld`.
+    //!
+    void
+    eval(
+      real_type const x[],
+      integer   const n,
+      real_type       out[],
+      integer   const ld
+    ) const;
+
+    //!
+    //! Evaluate the first derivative of all the splines at `x[0..n-1]`.
+    //! The point `k` is stored in `out[k*ld+j]`, `j=0..dim-1`.
+    //!
+    void
+    eval_D(
+      real_type const x[],
+      integer   const n,
+      real_type       out[],
+      integer   const ld
+    ) const;
+
+    //!
+    //! Evaluate the second derivative of all the splines at `x[0..n-1]`.
+    //! The point `k` is stored in `out[k*ld+j]`, `j=0..dim-1`.
+    //!
+    void
+    eval_DD(
+      real_type const x[],
+      integer   const n,
+      real_type       out[],
+      integer   const ld
+    ) const;
+    ///@}
+
     //!
     //! \name Evaluate all the splines in an STL vector
     //!
@@ -481,6 +604,33 @@ namespace Splines {
     eval_DDDDD( vec_real_type const & x, GenericContainer & vals ) const;
     ///@}
 
+    //!
+    //! \name Integration
+    //!
+    ///@{
+
+    //!
+    //! Definite integral of the component `j` from `a` to `b`.
+    //! The integrals on the segments are accumulated in a table
+    //! built at the first call after the spline is (re)built.
+    //!
+    real_type
+    integral( real_type const a, real_type const b, integer const j ) const;
+
+    //!
+    //! Definite integrals of the component `j` from `a[k]` to `b[k]`,
+    //! `k=0..n-1`, stored in `out[k]`.
+    //!
+    void
+    integral(
+      real_type const a[],
+      real_type const b[],
+      real_type       out[],
+      integer   const n,
+      integer   const j
+    ) const;
+    ///@}
+
     //!
     //! \name Setup Splines.
     //!
@@ -518,7 +668,7 @@ namespace Splines {
     );
 
     //!
-    //! Copy to SplineVec `S`
+    //! Copy to SplineVec `S` (knots, values, slopes and flags)
     //!
     void deep_copy_to( SplineVec & S ) const;
   
@@ -572,6 +722,88 @@ namespace Splines {
     //!
     real_type curvature_D( real_type x ) const;
 
+    //!
+    //! \name Arc length
+    //!
+    //! The length of each segment (and of a part of it) is computed with
+    //! adaptive 5 points Gauss-Legendre quadrature, halving the intervals
+    //! until the rule and the sum on the halves agree to 1e-13 relative,
+    //! and accumulated in a table built at the first call after the spline
+    //! is (re)built.
+    //!
+    ///@{
+
+    //!
+    //! Length of the curve from `x_min()` to `x`.
+    //!
+    real_type arc_length( real_type x ) const;
+
+    //!
+    //! Total length of the curve.
+    //!
+    real_type length() const;
+
+    //!
+    //! Parameter `x` such that `arc_length(x) == s`.
+    //! The segment is found by binary search on the table and
+    //! `x` is refined by safeguarded Newton iterations.
+    //!
+    real_type param_at_length( real_type s ) const;
+
+    //!
+    //! Evaluate all the splines at the points at arc length `s[k]`,
+    //! `k=0..n-1`. The point `k` is stored in `out[k*dim+j]`, `j=0..dim-1`.
+    //!
+    void
+    eval_at_lengths(
+      real_type const s[],
+      integer   const n,
+      real_type       out[]
+    ) const;
+
+    ///@}
+
+    //!
+    //! \name Closest point
+    //!
+    //! The search uses a bounding volume hierarchy over the convex hulls
+    //! of the Bezier control points of the segments, built at the first call
+    //! after the spline is (re)built. On a candidate segment all the minima
+    //! of the squared distance are found: the roots of its (quartic) second
+    //! derivative split the segment where the first one is monotone, and
+    //! its sign changes are bisected. Concurrent queries are allowed.
+    //!
+    ///@{
+
+    //!
+    //! Find the point of the curve closest to `p`.
+    //!
+    //! \param[in]  p    the query point (`dim` components)
+    //! \param[out] x    the parameter of the closest point
+    //! \param[out] dist the distance from `p` to the curve
+    //!
+    void
+    closest_point(
+      real_type const p[],
+      real_type     & x,
+      real_type     & dist
+    ) const;
+
+    //!
+    //! Find the points of the curve closest to `p[k*ldp+0..dim-1]`,
+    //! `k=0..n-1`, the result is stored in `x[k]` and `dist[k]`.
+    //!
+    void
+    closest_point(
+      real_type const p[],
+      integer   const n,
+      integer   const ldp,
+      real_type       x[],
+      real_type       dist[]
+    ) const;
+
+    ///@}
+
     //!
     //! Return spline type (as number).
     //!
@@ -0,0 +1,435 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+namespace Splines {
+
+  /*\
+   |   ____        _ _          __     __    _
+   |  / ___| _ __ | (_)_ __   __\ \   / /__ | |
+   |  \___ \| '_ \| | | '_ \ / _ \ \ / / _ \| |
+   |   ___) | |_) | | | | | |  __/\ V / (_) | |
+   |  |____/| .__/|_|_|_| |_|\___| \_/ \___/|_|
+   |        |_|
+  \*/
+
+  //!
+  //! Trivariate (tensor product) spline base class.
+  //!
+  //! Values are stored as \f$ v_{ijk} = f(x_i,y_j,z_k) \f$ in
+  //! `m_V[(i*ny+j)*nz+k]`, each axis has its own `SearchInterval`.
+  //!
+  class SplineVol {
+
+    Malloc_real m_mem;
+
+  protected:
+
+    #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+    string const m_name;
+    bool         m_x_closed{false};
+    bool         m_y_closed{false};
+    bool         m_z_closed{false};
+    bool         m_x_can_extend{true};
+    bool         m_y_can_extend{true};
+    bool         m_z_can_extend{true};
+
+    integer      m_nx{0};
+    integer      m_ny{0};
+    integer      m_nz{0};
+
+    real_type *  m_X{nullptr};
+    real_type *  m_Y{nullptr};
+    real_type *  m_Z{nullptr};
+    real_type *  m_V{nullptr};
+
+    real_type    m_V_min{0};
+    real_type    m_V_max{0};
+
+    SearchInterval m_search_x;
+    SearchInterval m_search_y;
+    SearchInterval m_search_z;
+
+    size_t
+    ipos_C( integer const i, integer const j, integer const k ) const
+    { return (size_t(i)*size_t(m_ny)+size_t(j))*size_t(m_nz)+size_t(k); }
+
+    //!
+    //! Find the cell containing `(x,y,z)`, return the cell indices
+    //! and the (possibly wrapped) coordinates.
+    //!
+    void
+    find(
+      real_type & x, real_type & y, real_type & z,
+      integer   & i, integer   & j, integer   & k
+    ) const;
+
+    virtual void make_spline() = 0;
+
+    #endif
+
+  public:
+
+    SplineVol( SplineVol const & ) = delete;
+    SplineVol const & operator = ( SplineVol const & ) = delete;
+
+    //!
+    //! Spline constructor
+    //!
+    explicit
+    SplineVol( string_view name = "SplineVol" );
+
+    //!
+    //! Spline destructor
+    //!
+    virtual
+    ~SplineVol();
+
+    //!
+    //! \name Build
+    //!
+    ///@{
+
+    //!
+    //! Build the spline.
+    //!
+    //! \param x               the `nx` x-nodes
+    //! \param nx              x-dimension
+    //! \param y               the `ny` y-nodes
+    //! \param ny              y-dimension
+    //! \param z               the `nz` z-nodes
+    //! \param nz              z-dimension
+    //! \param v               the values, `v[(i*ny+j)*nz+k]`
+    //! \param fortran_storage if true values are `v[i+nx*(j+ny*k)]`
+    //!
+    void
+    build(
+      real_type const x[], integer nx,
+      real_type const y[], integer ny,
+      real_type const z[], integer nz,
+      real_type const v[],
+      bool            fortran_storage = false
+    );
+
+    //!
+    //! Build the spline with `std::vector` data.
+    //!
+    void
+    build(
+      vector<real_type> const & x,
+      vector<real_type> const & y,
+      vector<real_type> const & z,
+      vector<real_type> const & v,
+      bool                      fortran_storage = false
+    );
+
+    //!
+    //! Cancel the spline
+    //!
+    void clear();
+
+    ///@}
+
+    //!
+    //! \name Info
+    //!
+    ///@{
+
+    //! the name of the spline
+    string_view name() const { return m_name; }
+
+    //! number of points in `x` direction
+    integer num_point_x() const { return m_nx; }
+
+    //! number of points in `y` direction
+    integer num_point_y() const { return m_ny; }
+
+    //! number of points in `z` direction
+    integer num_point_z() const { return m_nz; }
+
+    //! `i`-th node in `x` direction
+    real_type x_node( integer i ) const { return m_X[i]; }
+
+    //! `j`-th node in `y` direction
+    real_type y_node( integer j ) const { return m_Y[j]; }
+
+    //! `k`-th node in `z` direction
+    real_type z_node( integer k ) const { return m_Z[k]; }
+
+    //! value at node `(i,j,k)`
+    real_type v_node( integer i, integer j, integer k ) const { return m_V[this->ipos_C(i,j,k)]; }
+
+    real_type x_min() const { return m_X[0]; }        //!< minimum `x` node
+    real_type x_max() const { return m_X[m_nx-1]; }   //!< maximum `x` node
+    real_type y_min() const { return m_Y[0]; }        //!< minimum `y` node
+    real_type y_max() const { return m_Y[m_ny-1]; }   //!< maximum `y` node
+    real_type z_min() const { return m_Z[0]; }        //!< minimum `z` node
+    real_type z_max() const { return m_Z[m_nz-1]; }   //!< maximum `z` node
+    real_type v_min() const { return m_V_min; }       //!< minimum value at nodes
+    real_type v_max() const { return m_V_max; }       //!< maximum value at nodes
+
+    void make_x_bounded()   { m_x_can_extend = false; } //!< clamp queries on `x`
+    void make_y_bounded()   { m_y_can_extend = false; } //!< clamp queries on `y`
+    void make_z_bounded()   { m_z_can_extend = false; } //!< clamp queries on `z`
+    void make_x_unbounded() { m_x_can_extend = true;  } //!< extrapolate on `x`
+    void make_y_unbounded() { m_y_can_extend = true;  } //!< extrapolate on `y`
+    void make_z_unbounded() { m_z_can_extend = true;  } //!< extrapolate on `z`
+
+    //!
+    //! String information of the kind and order of the spline
+    //!
+    string info() const;
+
+    //!
+    //! Print information of the kind and order of the spline
+    //!
+    void
+    info( ostream_type & stream ) const
+    { stream << this->info() << '\n'; }
+
+    //!
+    //! Return spline typename
+    //!
+    virtual char const * type_name() const = 0;
+
+    ///@}
+
+    //!
+    //! \name Evaluate
+    //!
+    ///@{
+
+    //!
+    //! Evaluate spline value at point \f$ (x,y,z) \f$.
+    //!
+    virtual real_type eval( real_type x, real_type y, real_type z ) const = 0;
+
+    //!
+    //! Evaluate spline value at point \f$ (x,y,z) \f$.
+    //!
+    real_type
+    operator () ( real_type x, real_type y, real_type z ) const
+    { return this->eval(x,y,z); }
+
+    //!
+    //! Value and gradient at point \f$ (x,y,z) \f$:
+    //! `d[0]` value, `d[1]`, `d[2]`, `d[3]` the `x`, `y`, `z` derivatives.
+    //!
+    virtual void D( real_type x, real_type y, real_type z, real_type d[4] ) const = 0;
+
+    //!
+    //! Evaluate `n` points: `v[k]` is the value at `(x[k],y[k],z[k])`.
+    //!
+    virtual
+    void
+    eval(
+      real_type const x[],
+      real_type const y[],
+      real_type const z[],
+      integer         n,
+      real_type       v[]
+    ) const;
+
+    //!
+    //! Evaluate values and gradients at `n` points: `v[k]` is the value,
+    //! `grad[3*k+0..2]` the gradient at `(x[k],y[k],z[k])`.
+    //!
+    virtual
+    void
+    D(
+      real_type const x[],
+      real_type const y[],
+      real_type const z[],
+      integer         n,
+      real_type       v[],
+      real_type       grad[]
+    ) const;
+
+    ///@}
+
+  };
+
+  /*\
+   |   _____     _ _ _
+   |  |_   _| __(_) (_)_ __   ___  __ _ _ __
+   |    | || '__| | | | '_ \ / _ \/ _` | '__|
+   |    | || |  | | | | | | |  __/ (_| | |
+   |    |_||_|  |_|_|_|_| |_|\___|\__,_|_|
+  \*/
+
+  //!
+  //! Trilinear spline
+  //!
+  class TrilinearSpline : public SplineVol {
+    void make_spline() override {}
+  public:
+
+    using SplineVol::eval;
+    using SplineVol::D;
+
+    //!
+    //! Build an empty spline of `TrilinearSpline` type
+    //!
+    //! \param name the name of the spline
+    //!
+    explicit
+    TrilinearSpline( string_view name = "TrilinearSpline" )
+    : SplineVol(name)
+    {}
+
+    ~TrilinearSpline() override {}
+
+    real_type eval( real_type x, real_type y, real_type z ) const override;
+    void D( real_type x, real_type y, real_type z, real_type d[4] ) const override;
+    char const * type_name() const override { return "trilinear"; }
+  };
+
+  /*\
+   |   _____     _  ____      _     _
+   |  |_   _| __(_)/ ___|   _| |__ (_) ___
+   |    | || '__| | |  | | | | '_ \| |/ __|
+   |    | || |  | | |__| |_| | |_) | | (__
+   |    |_||_|  |_|\____\__,_|_.__/|_|\___|
+  \*/
+
+  //!
+  //! Tricubic Hermite spline base class.
+  //!
+  //! The derivatives estimated at the nodes (`x`, `y`, `z`, mixed) are
+  //! packed per cell in blocks of 64 Hermite coefficients stored one after
+  //! the other, so evaluating a cell reads a single contiguous block.
+  //!
+  class TriCubicSplineBase : public SplineVol {
+  protected:
+
+    #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+    Malloc_real m_mem_tricubic;
+    real_type * m_C{nullptr}; // 64 coefficients for each cell
+
+    //
+    // 1D derivative estimate of `Y` on nodes `X`, `work` has size `n`
+    //
+    using Build1D = void (*)(
+      real_type const X[], real_type const Y[], real_type Yp[], real_type work[], integer n
+    );
+
+    //
+    // Estimate the derivatives at nodes applying `build1d` along the axes
+    // (mixed derivatives are limited with minmod as in `BiCubicSpline`)
+    // and pack the 64 coefficients of each cell.
+    //
+    void make_cells( Build1D build1d );
+
+    real_type const *
+    block( integer i, integer j, integer k ) const
+    { return m_C + 64*( (size_t(i)*size_t(m_ny-1)+size_t(j))*size_t(m_nz-1)+size_t(k) ); }
+
+    void
+    eval_cell(
+      integer i, integer j, integer k,
+      real_type x, real_type y, real_type z,
+      real_type d[4], bool grad
+    ) const;
+
+    #endif
+
+  public:
+
+    using SplineVol::eval;
+    using SplineVol::D;
+
+    //! spline constructor
+    explicit
+    TriCubicSplineBase( string_view name = "TriCubicSplineBase" );
+
+    ~TriCubicSplineBase() override {}
+
+    real_type eval( real_type x, real_type y, real_type z ) const override;
+    void D( real_type x, real_type y, real_type z, real_type d[4] ) const override;
+
+    void
+    eval(
+      real_type const x[],
+      real_type const y[],
+      real_type const z[],
+      integer         n,
+      real_type       v[]
+    ) const override;
+
+    void
+    D(
+      real_type const x[],
+      real_type const y[],
+      real_type const z[],
+      integer         n,
+      real_type       v[],
+      real_type       grad[]
+    ) const override;
+  };
+
+  //!
+  //! Tricubic spline, derivatives estimated with PCHIP along each axis
+  //! (as `BiCubicSpline`).
+  //!
+  class TriCubicSpline : public TriCubicSplineBase {
+    void make_spline() override;
+  public:
+
+    //!
+    //! Build an empty spline of `TriCubicSpline` type
+    //!
+    //! \param name the name of the spline
+    //!
+    explicit
+    TriCubicSpline( string_view name = "TriCubicSpline" )
+    : TriCubicSplineBase( name )
+    {}
+
+    ~TriCubicSpline() override {}
+
+    char const * type_name() const override { return "tricubic"; }
+  };
+
+  //!
+  //! Tricubic spline, derivatives estimated with the Akima method along
+  //! each axis (as `Akima2Dspline`).
+  //!
+  class Akima3Dspline : public TriCubicSplineBase {
+    void make_spline() override;
+  public:
+
+    //!
+    //! Build an empty spline of `Akima3Dspline` type
+    //!
+    //! \param name the name of the spline
+    //!
+    explicit
+    Akima3Dspline( string_view name = "Akima3Dspline" )
+    : TriCubicSplineBase( name )
+    {}
+
+    ~Akima3Dspline() override {}
+
+    char const * type_name() const override { return "akima3d"; }
+  };
+
+}
+
+// EOF: SplineVol.hxx
@@ -436,6 +436,72 @@ namespace Splines {
 
     ///@}
 
+    //!
+    //! \name Integration
+    //!
+    ///@{
+
+    //!
+    //! Definite integral of the spline from `a` to `b`.
+    //!
+    real_type
+    integral( real_type const a, real_type const b ) const
+    { return m_spline->integral(a,b); }
+
+    //!
+    //! Definite integrals of the spline from `a[k]` to `b[k]`, `k=0..n-1`.
+    //!
+    void
+    integral(
+      real_type const a[],
+      real_type const b[],
+      real_type       out[],
+      integer   const n
+    ) const
+    { m_spline->integral( a, b, out, n ); }
+
+    ///@}
+
+    //! \name Inverse
+    //!
+    ///@{
+
+    //!
+    //! Solve `eval(x) = y` for a spline with monotone node values.
+    //!
+    bool
+    inverse( real_type const y, real_type & x ) const
+    { return m_spline->inverse( y, x ); }
+
+    //!
+    //! Solve `eval(x[k]) = y[k]`, `k=0..n-1`, return the values out of range.
+    //!
+    integer
+    inverse( real_type const y[], real_type x[], integer const n ) const
+    { return m_spline->inverse( y, x, n ); }
+
+    ///@}
+
+    //!
+    //! Search the max and min values of `y` along the spline
+    //! restricted to `[a,b]`.
+    //!
+    void
+    y_min_max(
+      real_type   a,
+      real_type   b,
+      integer   & i_min_pos,
+      real_type & x_min_pos,
+      real_type & y_min,
+      integer   & i_max_pos,
+      real_type & x_max_pos,
+      real_type & y_max
+    ) const {
+      m_spline->y_min_max(
+        a, b, i_min_pos, x_min_pos, y_min, i_max_pos, x_max_pos, y_max
+      );
+    }
+
     //!
     //! Get the piecewise polinomials of the spline
     //!
@@ -0,0 +1,210 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+namespace Splines {
+
+  /*\
+   |   ____        _       _     _____            _
+   |  | __ )  __ _| |_ ___| |__ | ____|_   ____ _| |
+   |  |  _ \ / _` | __/ __| '_ \|  _| \ \ / / _` | |
+   |  | |_) | (_| | || (__| | | | |___ \ V / (_| | |
+   |  |____/ \__,_|\__\___|_| |_|_____| \_/ \__,_|_|
+  \*/
+
+  //!
+  //! User supplied executor: run `task(0)`, ..., `task(ntasks-1)`
+  //! (in any order, possibly concurrently) and return when all are done.
+  //!
+  using Executor = std::function<void( integer ntasks, std::function<void(integer)> const & task )>;
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  //!
+  //! Fixed size pool running parallel loops over chunks.
+  //! Each worker owns a contiguous range of chunks and, when done,
+  //! steals chunks from the others; chunks are taken with an atomic
+  //! increment, no lock is used while the loop runs.
+  //!
+  class WorkStealingPool {
+
+    struct alignas(64) Range {
+      std::atomic<integer> next{0};
+      integer              end{0};
+    };
+
+    vector<std::thread>        m_threads;
+    std::unique_ptr<Range[]>   m_ranges;
+    integer                    m_size{1};
+
+    std::mutex                 m_mutex;
+    std::condition_variable    m_cv_start;
+    std::condition_variable    m_cv_done;
+    std::function<void(integer)> const * m_task{nullptr};
+    unsigned long              m_job{0};
+    integer                    m_running{0};
+    bool                       m_stop{false};
+    std::exception_ptr         m_error;        // first exception thrown by a task
+    std::atomic<bool>          m_abort{false}; // stop taking tasks after an exception
+
+    void worker( integer id );
+    void work( integer id );
+
+  public:
+
+    WorkStealingPool( WorkStealingPool const & ) = delete;
+    WorkStealingPool const & operator = ( WorkStealingPool const & ) = delete;
+
+    explicit WorkStealingPool( integer num_threads );
+    ~WorkStealingPool();
+
+    integer size() const { return m_size; }
+
+    //!
+    //! Run `task(0..ntasks-1)` on the pool, the calling thread works too.
+    //! Calls from different threads are serialized.
+    //! If a task throws the remaining tasks are skipped and the first
+    //! exception is rethrown after all the workers have finished.
+    //!
+    void run( integer ntasks, std::function<void(integer)> const & task );
+  };
+
+  #endif
+
+  //!
+  //! Parallel front-end for batched evaluation.
+  //!
+  //! Query arrays are split in chunks of `chunk_size` points evaluated
+  //! on an internal work stealing pool or on a user supplied `Executor`.
+  //! Optionally the points of each chunk are evaluated sorted by `x`
+  //! to improve the locality of the interval search and of the coefficients.
+  //! Splines are only read, so many threads can evaluate the same spline.
+  //!
+  class BatchEvaluator {
+
+    std::unique_ptr<WorkStealingPool> m_pool;
+    Executor                          m_executor;
+    integer                           m_chunk_size{2048};
+    bool                              m_sort{false};
+    mutable std::mutex                m_run_mutex;
+
+    void
+    run(
+      integer n,
+      std::function<void(integer,integer)> const & kernel
+    ) const;
+
+    void sorted_index( real_type const x[], integer i0, integer i1, vector<integer> & idx ) const;
+
+  public:
+
+    BatchEvaluator( BatchEvaluator const & ) = delete;
+    BatchEvaluator const & operator = ( BatchEvaluator const & ) = delete;
+
+    //!
+    //! Evaluator using an internal pool of `num_threads` threads
+    //! (0 = hardware concurrency).
+    //!
+    explicit
+    BatchEvaluator( integer num_threads = 0 );
+
+    //!
+    //! Evaluator running the chunks with the user `executor`.
+    //!
+    explicit
+    BatchEvaluator( Executor executor );
+
+    ~BatchEvaluator();
+
+    //!
+    //! \name Setup
+    //!
+    ///@{
+
+    //! number of points evaluated by a single task
+    void set_chunk_size( integer n );
+
+    //! sort points of each chunk before evaluation (NaNs last, they give NaN)
+    void sort_queries( bool yes = true ) { m_sort = yes; }
+
+    //! number of threads of the internal pool (0 with a user executor)
+    integer num_threads() const { return m_pool ? m_pool->size() : 0; }
+
+    integer chunk_size() const { return m_chunk_size; } //!< points per task
+
+    ///@}
+
+    //!
+    //! \name Batched evaluation
+    //!
+    ///@{
+
+    //!
+    //! `y[k] = S^(deriv)(x[k])` for `k=0..n-1`, `deriv` in `0..3`
+    //!
+    void
+    eval(
+      Spline    const & S,
+      real_type const   x[],
+      integer           n,
+      real_type         y[],
+      integer           deriv = 0
+    ) const;
+
+    //!
+    //! `vals[k*ld+spl]` value of spline `spl` of the set at `x[k]`
+    //!
+    void
+    eval(
+      SplineSet const & S,
+      real_type const   x[],
+      integer           n,
+      real_type         vals[],
+      integer           ld
+    ) const;
+
+    //!
+    //! `vals[k*ld+j]` component `j` of the curve at `x[k]`
+    //!
+    void
+    eval(
+      SplineVec const & S,
+      real_type const   x[],
+      integer           n,
+      real_type         vals[],
+      integer           ld
+    ) const;
+
+    //!
+    //! `z[k] = S(x[k],y[k])`
+    //!
+    void
+    eval(
+      SplineSurf const & S,
+      real_type  const   x[],
+      real_type  const   y[],
+      integer            n,
+      real_type          z[]
+    ) const;
+
+    ///@}
+  };
+
+}
+
+// EOF: SplinesParallel.hxx
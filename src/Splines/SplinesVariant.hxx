@@ -0,0 +1,475 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+/*\
+ |  __     __         _             _
+ |  \ \   / /_ _ _ __(_) __ _ _ __ | |_
+ |   \ \ / / _` | '__| |/ _` | '_ \| __|
+ |    \ V / (_| | |  | | (_| | | | | |_
+ |     \_/ \__,_|_|  |_|\__,_|_| |_|\__|
+\*/
+
+namespace Splines {
+
+  //!
+  //! Spline of any 1D type with value semantics.
+  //!
+  //! The concrete spline is held by value in a `std::variant` (constructed
+  //! in place, so its search interval is bound to its own members) and the
+  //! public evaluation methods dispatch with a single `switch` on the type to
+  //! a qualified call of the concrete implementation, e.g.
+  //! `S.CubicSpline::eval(x)`, so the first call is not virtual.
+  //! The concrete `eval`, `D`, ... are compiled in the library and still
+  //! call `id_eval`, `id_D`, ... through the vtable; `integral`, `info` and
+  //! the accessors use the `Spline` interface.
+  //!
+  //! Objects can be copied and moved, so they can be stored in standard
+  //! containers. The splines own their nodes, a copy or a move constructs
+  //! the spline in the target and copies the nodes (a move then empties
+  //! the source).
+  //!
+  class Spline1DVariant {
+
+    #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+    // state with no spline stored, keeps the name for the next `build`
+    struct Unbuilt { string name; };
+
+    // the splines cannot be copied or moved by the variant itself,
+    // they are constructed with `emplace` and filled with `copy_spline`
+    using Storage = std::variant<
+      Unbuilt,
+      ConstantSpline,
+      LinearSpline,
+      CubicSpline,
+      AkimaSpline,
+      BesselSpline,
+      PchipSpline,
+      QuinticSpline,
+      HermiteSpline
+    >;
+
+    SplineType1D m_type{SplineType1D::SPLINE_SET}; // no spline stored
+    Storage      m_spline;
+
+    void emplace( SplineType1D tp );
+    void copy( Spline1DVariant const & S );
+
+    // call `fun` on the stored spline with its concrete type
+    template <typename FUN>
+    decltype(auto)
+    visit( FUN && fun ) const {
+      switch ( m_type ) {
+      case SplineType1D::CONSTANT: return fun( *std::get_if<ConstantSpline>( &m_spline ) );
+      case SplineType1D::LINEAR:   return fun( *std::get_if<LinearSpline>( &m_spline ) );
+      case SplineType1D::CUBIC:    return fun( *std::get_if<CubicSpline>( &m_spline ) );
+      case SplineType1D::AKIMA:    return fun( *std::get_if<AkimaSpline>( &m_spline ) );
+      case SplineType1D::BESSEL:   return fun( *std::get_if<BesselSpline>( &m_spline ) );
+      case SplineType1D::PCHIP:    return fun( *std::get_if<PchipSpline>( &m_spline ) );
+      case SplineType1D::QUINTIC:  return fun( *std::get_if<QuinticSpline>( &m_spline ) );
+      case SplineType1D::HERMITE:  return fun( *std::get_if<HermiteSpline>( &m_spline ) );
+      default: break;
+      }
+      UTILS_ERROR( "Spline1DVariant[{}] spline not built\n", name() );
+    }
+
+    #endif
+
+  public:
+
+    //!
+    //! \name Constructors
+    //!
+    ///@{
+
+    //!
+    //! Build an empty spline.
+    //!
+    explicit
+    Spline1DVariant( string_view name = "Spline1DVariant" )
+    : m_spline( Unbuilt{ string(name) } )
+    {}
+
+    //!
+    //! Build a spline of type `tp` (not yet interpolated).
+    //!
+    Spline1DVariant( string_view name, SplineType1D tp )
+    : m_spline( Unbuilt{ string(name) } )
+    { emplace( tp ); }
+
+    Spline1DVariant( Spline1DVariant const & S ) { copy( S ); }
+
+    Spline1DVariant &
+    operator = ( Spline1DVariant const & S ) {
+      if ( this != &S ) copy( S );
+      return *this;
+    }
+
+    //!
+    //! Move the stored spline, `S` is left empty (with no name).
+    //!
+    Spline1DVariant( Spline1DVariant && S ) {
+      copy( S );
+      S.m_type = SplineType1D::SPLINE_SET;
+      S.m_spline.emplace<Unbuilt>();
+    }
+
+    Spline1DVariant &
+    operator = ( Spline1DVariant && S ) {
+      if ( this != &S ) {
+        copy( S );
+        S.m_type = SplineType1D::SPLINE_SET;
+        S.m_spline.emplace<Unbuilt>();
+      }
+      return *this;
+    }
+
+    ~Spline1DVariant() {}
+
+    ///@}
+
+    //!
+    //! \name Build
+    //!
+    ///@{
+
+    //!
+    //! Build a spline of type `tp` interpolating `(x[i*incx],y[i*incy])`.
+    //! For `HERMITE` use the overload with the derivatives.
+    //!
+    void
+    build(
+      SplineType1D tp,
+      real_type const x[], integer incx,
+      real_type const y[], integer incy,
+      integer n
+    );
+
+    //!
+    //! Build a spline of type `tp` interpolating `(x[i],y[i])`.
+    //!
+    void
+    build( SplineType1D tp, real_type const x[], real_type const y[], integer n )
+    { this->build( tp, x, 1, y, 1, n ); }
+
+    //!
+    //! Build a spline of type `tp` interpolating `(x[i],y[i])`.
+    //!
+    void
+    build( SplineType1D tp, vector<real_type> const & x, vector<real_type> const & y )
+    { this->build( tp, x.data(), y.data(), integer(x.size()) ); }
+
+    //!
+    //! Build an Hermite spline interpolating `(x[i],y[i])` with derivatives `yp[i]`.
+    //!
+    void
+    build_hermite( real_type const x[], real_type const y[], real_type const yp[], integer n );
+
+    //!
+    //! Remove the stored spline.
+    //!
+    void clear();
+
+    //!
+    //! `true` if a spline is stored.
+    //!
+    bool is_built() const { return m_type != SplineType1D::SPLINE_SET; }
+
+    ///@}
+
+    //!
+    //! \name Access
+    //!
+    ///@{
+
+    //!
+    //! The stored spline as base class.
+    //!
+    Spline const & spline() const;
+    Spline       & spline();
+
+    //!
+    //! The stored spline with its concrete type (`T` must match the stored type).
+    //! Calls like `S.as<CubicSpline>().CubicSpline::eval(x)` are resolved at compile time.
+    //!
+    template <typename T> T const & as() const { return std::get<T>( m_spline ); }
+    template <typename T> T       & as()       { return std::get<T>( m_spline ); }
+
+    string_view  name()       const;
+    SplineType1D type()       const { return m_type; }
+    char const * type_name()  const { return spline().type_name(); }
+    integer      num_points() const { return spline().num_points(); }
+    integer      order()      const { return spline().order(); }
+
+    real_type x_node( integer i ) const { return spline().x_node(i); }
+    real_type y_node( integer i ) const { return spline().y_node(i); }
+    real_type x_min()             const { return spline().x_min(); }
+    real_type x_max()             const { return spline().x_max(); }
+
+    string info() const { return spline().info(); }
+    void info( ostream_type & stream ) const { spline().info( stream ); }
+
+    ///@}
+
+    //!
+    //! \name Evaluation
+    //!
+    ///@{
+
+    real_type
+    eval( real_type const x ) const
+    { return visit( [x]( auto const & S ) { using T = std::decay_t<decltype(S)>; return S.T::eval(x); } ); }
+
+    real_type
+    D( real_type const x ) const
+    { return visit( [x]( auto const & S ) { using T = std::decay_t<decltype(S)>; return S.T::D(x); } ); }
+
+    real_type
+    DD( real_type const x ) const
+    { return visit( [x]( auto const & S ) { using T = std::decay_t<decltype(S)>; return S.T::DD(x); } ); }
+
+    real_type
+    DDD( real_type const x ) const
+    { return visit( [x]( auto const & S ) { using T = std::decay_t<decltype(S)>; return S.T::DDD(x); } ); }
+
+    real_type
+    DDDD( real_type const x ) const
+    { return visit( [x]( auto const & S ) { using T = std::decay_t<decltype(S)>; return S.T::DDDD(x); } ); }
+
+    real_type
+    DDDDD( real_type const x ) const
+    { return visit( [x]( auto const & S ) { using T = std::decay_t<decltype(S)>; return S.T::DDDDD(x); } ); }
+
+    void
+    D( real_type const x, real_type dd[2] ) const
+    { visit( [x,dd]( auto const & S ) { using T = std::decay_t<decltype(S)>; S.T::D(x,dd); } ); }
+
+    void
+    DD( real_type const x, real_type dd[3] ) const
+    { visit( [x,dd]( auto const & S ) { using T = std::decay_t<decltype(S)>; S.T::DD(x,dd); } ); }
+
+    real_type operator () ( real_type const x ) const { return this->eval(x); }
+    real_type eval_D      ( real_type const x ) const { return this->D(x); }
+    real_type eval_DD     ( real_type const x ) const { return this->DD(x); }
+    real_type eval_DDD    ( real_type const x ) const { return this->DDD(x); }
+
+    real_type
+    integral( real_type const a, real_type const b ) const
+    { return spline().integral( a, b ); }
+
+    ///@}
+  };
+
+  //!
+  //! Spline surface of any 2D type with value semantics.
+  //!
+  //! The concrete surface is held in a `std::variant` of owning pointers and
+  //! evaluation dispatches with a single `switch` on the type, see
+  //! `Spline1DVariant` for what is and is not devirtualized.
+  //!
+  class Spline2DVariant {
+
+    #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+    // state with no surface stored, keeps the name for the next `build`
+    struct Unbuilt { string name; };
+
+    template <typename T> using Ptr = std::unique_ptr<T>;
+
+    using Storage = std::variant<
+      Unbuilt,
+      Ptr<BilinearSpline>,
+      Ptr<BiCubicSpline>,
+      Ptr<BiQuinticSpline>,
+      Ptr<Akima2Dspline>
+    >;
+
+    integer m_type{-1}; // `SplineType2D` or -1 if no surface stored
+    Storage m_spline;
+
+    void emplace( SplineType2D tp );
+    void copy( Spline2DVariant const & S );
+
+    template <typename FUN>
+    decltype(auto)
+    visit( FUN && fun ) const {
+      switch ( m_type ) {
+      case integer(SplineType2D::BILINEAR):  return fun( static_cast<BilinearSpline const &>( **std::get_if<Ptr<BilinearSpline>>( &m_spline ) ) );
+      case integer(SplineType2D::BICUBIC):   return fun( static_cast<BiCubicSpline const &>( **std::get_if<Ptr<BiCubicSpline>>( &m_spline ) ) );
+      case integer(SplineType2D::BIQUINTIC): return fun( static_cast<BiQuinticSpline const &>( **std::get_if<Ptr<BiQuinticSpline>>( &m_spline ) ) );
+      case integer(SplineType2D::AKIMA2D):   return fun( static_cast<Akima2Dspline const &>( **std::get_if<Ptr<Akima2Dspline>>( &m_spline ) ) );
+      default: break;
+      }
+      UTILS_ERROR( "Spline2DVariant[{}] surface not built\n", name() );
+    }
+
+    #endif
+
+  public:
+
+    //!
+    //! \name Constructors
+    //!
+    ///@{
+
+    explicit
+    Spline2DVariant( string_view name = "Spline2DVariant" )
+    : m_spline( Unbuilt{ string(name) } )
+    {}
+
+    Spline2DVariant( string_view name, SplineType2D tp )
+    : m_spline( Unbuilt{ string(name) } )
+    { emplace( tp ); }
+
+    Spline2DVariant( Spline2DVariant const & S ) { copy( S ); }
+
+    Spline2DVariant &
+    operator = ( Spline2DVariant const & S ) {
+      if ( this != &S ) copy( S );
+      return *this;
+    }
+
+    //!
+    //! Move the stored surface, `S` is left empty (with no name).
+    //!
+    Spline2DVariant( Spline2DVariant && S ) noexcept
+    : m_type( S.m_type )
+    , m_spline( std::move(S.m_spline) )
+    { S.m_type = -1; S.m_spline.emplace<Unbuilt>(); }
+
+    Spline2DVariant &
+    operator = ( Spline2DVariant && S ) noexcept {
+      if ( this != &S ) {
+        m_type   = S.m_type;
+        m_spline = std::move(S.m_spline);
+        S.m_type = -1;
+        S.m_spline.emplace<Unbuilt>();
+      }
+      return *this;
+    }
+
+    ~Spline2DVariant() {}
+
+    ///@}
+
+    //!
+    //! \name Build
+    //!
+    ///@{
+
+    //!
+    //! Build a surface of type `tp`, arguments as in `SplineSurf::build`.
+    //!
+    void
+    build(
+      SplineType2D tp,
+      real_type const x[], integer incx,
+      real_type const y[], integer incy,
+      real_type const z[], integer ldZ,
+      integer nx, integer ny,
+      bool fortran_storage = false,
+      bool transposed      = false
+    );
+
+    //!
+    //! Build a surface of type `tp`, arguments as in `SplineSurf::build`.
+    //!
+    void
+    build(
+      SplineType2D              tp,
+      vector<real_type> const & x,
+      vector<real_type> const & y,
+      vector<real_type> const & z,
+      bool fortran_storage = false,
+      bool transposed      = false
+    );
+
+    void clear();
+
+    bool is_built() const { return m_spline.index() != 0; }
+
+    ///@}
+
+    //!
+    //! \name Access
+    //!
+    ///@{
+
+    SplineSurf const & surface() const;
+    SplineSurf       & surface();
+
+    template <typename T> T const & as() const { return std::get<T>( m_spline ); }
+    template <typename T> T       & as()       { return std::get<T>( m_spline ); }
+
+    string_view  name()        const;
+    SplineType2D type()        const { return SplineType2D(m_type); }
+    char const * type_name()   const { return surface().type_name(); }
+    integer      num_point_x() const { return surface().num_point_x(); }
+    integer      num_point_y() const { return surface().num_point_y(); }
+
+    string info() const { return surface().info(); }
+    void info( ostream_type & stream ) const { surface().info( stream ); }
+
+    ///@}
+
+    //!
+    //! \name Evaluation
+    //!
+    ///@{
+
+    real_type
+    eval( real_type const x, real_type const y ) const
+    { return visit( [x,y]( auto const & S ) { using T = std::decay_t<decltype(S)>; return S.T::eval(x,y); } ); }
+
+    real_type operator () ( real_type const x, real_type const y ) const { return this->eval(x,y); }
+
+    void
+    D( real_type const x, real_type const y, real_type d[3] ) const
+    { visit( [x,y,d]( auto const & S ) { using T = std::decay_t<decltype(S)>; S.T::D(x,y,d); } ); }
+
+    real_type
+    Dx( real_type const x, real_type const y ) const
+    { return visit( [x,y]( auto const & S ) { using T = std::decay_t<decltype(S)>; return S.T::Dx(x,y); } ); }
+
+    real_type
+    Dy( real_type const x, real_type const y ) const
+    { return visit( [x,y]( auto const & S ) { using T = std::decay_t<decltype(S)>; return S.T::Dy(x,y); } ); }
+
+    void
+    DD( real_type const x, real_type const y, real_type dd[6] ) const
+    { visit( [x,y,dd]( auto const & S ) { using T = std::decay_t<decltype(S)>; S.T::DD(x,y,dd); } ); }
+
+    real_type
+    Dxx( real_type const x, real_type const y ) const
+    { return visit( [x,y]( auto const & S ) { using T = std::decay_t<decltype(S)>; return S.T::Dxx(x,y); } ); }
+
+    real_type
+    Dxy( real_type const x, real_type const y ) const
+    { return visit( [x,y]( auto const & S ) { using T = std::decay_t<decltype(S)>; return S.T::Dxy(x,y); } ); }
+
+    real_type
+    Dyy( real_type const x, real_type const y ) const
+    { return visit( [x,y]( auto const & S ) { using T = std::decay_t<decltype(S)>; return S.T::Dyy(x,y); } ); }
+
+    ///@}
+  };
+
+}
+
+// EOF: SplinesVariant.hxx
@@ -0,0 +1,753 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#if !defined(_WIN32)
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+  #define SPLINES_HAS_MMAP
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+using namespace std; // load standard namspace
+#endif
+
+namespace Splines {
+
+  /*\
+   |  ____  _                          _____                          _
+   | | __ )(_)_ __   __ _ _ __ _   _  |  ___|__  _ __ _ __ ___   __ _| |_
+   | |  _ \| | '_ \ / _` | '__| | | | | |_ / _ \| '__| '_ ` _ \ / _` | __|
+   | | |_) | | | | | (_| | |  | |_| | |  _| (_) | |  | | | | | | (_| | |_
+   | |____/|_|_| |_|\__,_|_|   \__, | |_|  \___/|_|  |_| |_| |_|\__,_|\__|
+   |                           |___/
+   |
+   |  magic    char[8]  "SPLINES\0"
+   |  endian   uint32   0x01020304 written in native order
+   |  version  uint32
+   |  kind     int64    1 = SplineSet, 2 = BiCubicSplineBase, 3 = grid
+   |  payload           int64 fields, strings (int64 length + bytes padded
+   |                    to 8), arrays of doubles: every item is 8 bytes aligned
+  \*/
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  static char     const binary_magic[8]{ 'S', 'P', 'L', 'I', 'N', 'E', 'S', '\0' };
+  static uint32_t const binary_endian_tag{ 0x01020304 };
+  static uint32_t const binary_version{ 1 };
+  static int64_t  const binary_kind_spline_set{ 1 };
+  static int64_t  const binary_kind_bicubic{ 2 };
+  static int64_t  const binary_kind_grid{ 3 };
+
+  class BinaryWriter {
+    std::ofstream m_stream;
+    string        m_where;
+
+    void
+    pad( size_t n ) {
+      static char const zeros[8]{0,0,0,0,0,0,0,0};
+      size_t const r{ n % 8 };
+      if ( r != 0 ) m_stream.write( zeros, static_cast<std::streamsize>(8-r) );
+    }
+
+  public:
+
+    BinaryWriter( string_view file_name, string_view where, int64_t kind )
+    : m_stream( string(file_name), std::ios::binary | std::ios::trunc )
+    , m_where( where )
+    {
+      UTILS_ASSERT( m_stream.good(), "{}: cannot open file `{}`\n", m_where, file_name );
+      m_stream.write( binary_magic, 8 );
+      m_stream.write( reinterpret_cast<char const*>(&binary_endian_tag), sizeof(uint32_t) );
+      m_stream.write( reinterpret_cast<char const*>(&binary_version), sizeof(uint32_t) );
+      put_int( kind );
+    }
+
+    ~BinaryWriter() {
+      m_stream.close();
+    }
+
+    void
+    put_int( int64_t v )
+    { m_stream.write( reinterpret_cast<char const*>(&v), sizeof(int64_t) ); }
+
+    void
+    put_string( string_view s ) {
+      put_int( static_cast<int64_t>(s.size()) );
+      m_stream.write( s.data(), static_cast<std::streamsize>(s.size()) );
+      pad( s.size() );
+    }
+
+    void
+    put_reals( real_type const v[], size_t n ) {
+      m_stream.write(
+        reinterpret_cast<char const*>(v),
+        static_cast<std::streamsize>(n*sizeof(real_type))
+      );
+    }
+
+    void
+    put_bytes( void const * v, size_t n ) {
+      m_stream.write( static_cast<char const*>(v), static_cast<std::streamsize>(n) );
+      pad( n );
+    }
+
+    void
+    check() const
+    { UTILS_ASSERT( m_stream.good(), "{}: write failed\n", m_where ); }
+  };
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  class BinaryReader {
+    char * m_data;
+    size_t m_size;
+    size_t m_pos{0};
+    string m_where;
+
+    void
+    need( size_t n ) const {
+      UTILS_ASSERT(
+        m_pos + n <= m_size,
+        "{}: truncated file, need {} bytes at offset {}, size {}\n",
+        m_where, n, m_pos, m_size
+      );
+    }
+
+  public:
+
+    BinaryReader( MappedFile const & file, string_view where, int64_t kind )
+    : m_data( file.data() )
+    , m_size( file.size() )
+    , m_where( where )
+    {
+      need( 16 );
+      UTILS_ASSERT(
+        std::memcmp( m_data, binary_magic, 8 ) == 0,
+        "{}: file `{}` is not a Splines binary file\n", m_where, file.file_name()
+      );
+      uint32_t endian, version;
+      std::memcpy( &endian,  m_data+8,  sizeof(uint32_t) );
+      std::memcpy( &version, m_data+12, sizeof(uint32_t) );
+      m_pos = 16;
+      UTILS_ASSERT(
+        endian == binary_endian_tag,
+        "{}: file `{}` was written on a machine with different endianness\n",
+        m_where, file.file_name()
+      );
+      UTILS_ASSERT(
+        version <= binary_version,
+        "{}: file `{}` has format version {}, supported up to {}\n",
+        m_where, file.file_name(), version, binary_version
+      );
+      int64_t const k{ get_int() };
+      UTILS_ASSERT(
+        k == kind, "{}: file `{}` contains kind {} expected {}\n",
+        m_where, file.file_name(), k, kind
+      );
+    }
+
+    int64_t
+    get_int() {
+      need( sizeof(int64_t) );
+      int64_t v;
+      std::memcpy( &v, m_data+m_pos, sizeof(int64_t) );
+      m_pos += sizeof(int64_t);
+      return v;
+    }
+
+    integer
+    get_size( string_view what ) {
+      int64_t const v{ get_int() };
+      UTILS_ASSERT(
+        v >= 0 && v <= std::numeric_limits<integer>::max(),
+        "{}: bad value {} for `{}`\n", m_where, v, what
+      );
+      return static_cast<integer>(v);
+    }
+
+    string
+    get_string() {
+      size_t const n{ static_cast<size_t>(get_size("string length")) };
+      need( n );
+      string s( m_data+m_pos, n );
+      m_pos += n;
+      if ( n % 8 != 0 ) m_pos += 8 - n % 8;
+      return s;
+    }
+
+    char *
+    get_bytes( size_t n ) {
+      need( n );
+      char * p{ m_data+m_pos };
+      m_pos += n;
+      if ( n % 8 != 0 ) m_pos += 8 - n % 8;
+      return p;
+    }
+
+    real_type *
+    get_reals( size_t n ) {
+      size_t const nb{ n*sizeof(real_type) };
+      need( nb );
+      real_type * p{ reinterpret_cast<real_type*>(m_data+m_pos) };
+      m_pos += nb;
+      return p;
+    }
+  };
+
+  #endif
+
+  /*\
+   |   __  __                             _ _____ _ _
+   |  |  \/  | __ _ _ __  _ __   ___  __| |  ___(_) | ___
+   |  | |\/| |/ _` | '_ \| '_ \ / _ \/ _` | |_  | | |/ _ \
+   |  | |  | | (_| | |_) | |_) |  __/ (_| |  _| | | |  __/
+   |  |_|  |_|\__,_| .__/| .__/ \___|\__,_|_|   |_|_|\___|
+   |               |_|   |_|
+  \*/
+
+  MappedFile::MappedFile( string_view file_name, bool use_mmap )
+  : m_file_name( file_name )
+  {
+    #ifdef SPLINES_HAS_MMAP
+    if ( use_mmap ) {
+      int const fd{ ::open( m_file_name.c_str(), O_RDONLY ) };
+      UTILS_ASSERT( fd >= 0, "MappedFile: cannot open file `{}`\n", m_file_name );
+      struct stat st;
+      if ( ::fstat( fd, &st ) != 0 ) {
+        ::close( fd );
+        UTILS_ERROR( "MappedFile: cannot stat file `{}`\n", m_file_name );
+      }
+      m_size = static_cast<size_t>(st.st_size);
+      if ( m_size > 0 ) {
+        // private writable mapping: pages are shared with the page cache
+        // until written (copy on write), the file is never modified
+        void * p{ ::mmap( nullptr, m_size, PROT_READ|PROT_WRITE, MAP_PRIVATE, fd, 0 ) };
+        ::close( fd );
+        UTILS_ASSERT( p != MAP_FAILED, "MappedFile: mmap of `{}` failed\n", m_file_name );
+        m_data   = static_cast<char*>(p);
+        m_mapped = true;
+      } else {
+        ::close( fd );
+      }
+      return;
+    }
+    #else
+    (void) use_mmap;
+    #endif
+    std::ifstream file( m_file_name, std::ios::binary | std::ios::ate );
+    UTILS_ASSERT( file.good(), "MappedFile: cannot open file `{}`\n", m_file_name );
+    m_size = static_cast<size_t>(file.tellg());
+    m_buffer.resize( (m_size+sizeof(real_type)-1)/sizeof(real_type) );
+    m_data = reinterpret_cast<char*>(m_buffer.data());
+    file.seekg( 0 );
+    file.read( m_data, static_cast<std::streamsize>(m_size) );
+    UTILS_ASSERT( file.good(), "MappedFile: read of `{}` failed\n", m_file_name );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  MappedFile::~MappedFile() {
+    #ifdef SPLINES_HAS_MMAP
+    if ( m_mapped ) ::munmap( m_data, m_size );
+    #endif
+  }
+
+  /*\
+   |   ____        _ _            ____       _
+   |  / ___| _ __ | (_)_ __   ___/ ___|  ___| |_
+   |  \___ \| '_ \| | | '_ \ / _ \___ \ / _ \ __|
+   |   ___) | |_) | | | | | |  __/___) |  __/ |_
+   |  |____/| .__/|_|_|_| |_|\___|____/ \___|\__|
+   |        |_|
+  \*/
+
+  void
+  SplineSet::save_binary( string_view file_name ) const {
+    string const where{ fmt::format( "SplineSet[{}]::save_binary", m_name ) };
+    UTILS_ASSERT( m_nspl > 0, "{}: spline set is empty\n", where );
+
+    BinaryWriter out( file_name, where, binary_kind_spline_set );
+    out.put_int( m_nspl );
+    out.put_int( m_npts );
+    out.put_string( m_name );
+    for ( integer spl{0}; spl < m_nspl; ++spl ) {
+      Spline const * S{ m_splines[spl].get() };
+      int64_t subtype{0};
+      switch ( S->type() ) {
+      case SplineType1D::CUBIC:
+        { CubicSpline const * C{ static_cast<CubicSpline const *>(S) };
+          subtype = int64_t(C->initial_BC()) | (int64_t(C->final_BC()) << 8);
+        }
+        break;
+      case SplineType1D::QUINTIC:
+        subtype = int64_t( static_cast<QuinticSpline const *>(S)->quintic_type() );
+        break;
+      default:
+        break;
+      }
+      out.put_int( int64_t(S->type()) );
+      out.put_int(
+        ( S->m_curve_is_closed         ? 1 : 0 ) |
+        ( S->m_curve_can_extend        ? 2 : 0 ) |
+        ( S->m_curve_extended_constant ? 4 : 0 )
+      );
+      out.put_int( m_is_monotone[spl] );
+      out.put_int( subtype );
+      out.put_string( S->name() );
+    }
+    out.put_reals( m_X,    m_npts );
+    out.put_reals( m_Ymin, m_nspl );
+    out.put_reals( m_Ymax, m_nspl );
+    for ( integer spl{0}; spl < m_nspl; ++spl ) {
+      out.put_reals( m_Y[spl], m_npts );
+      if ( m_Yp[spl]  != nullptr ) out.put_reals( m_Yp[spl],  m_npts );
+      if ( m_Ypp[spl] != nullptr ) out.put_reals( m_Ypp[spl], m_npts );
+    }
+    out.check();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineSet::load_binary( string_view file_name, bool use_mmap ) {
+    string const where{ fmt::format( "SplineSet[{}]::load_binary", m_name ) };
+
+    // the whole file is parsed and validated into locals, `*this` is
+    // modified only after the last read so a bad file leaves it untouched
+    auto file = std::make_unique<MappedFile>( file_name, use_mmap );
+    BinaryReader in( *file, where, binary_kind_spline_set );
+
+    integer const nspl{ in.get_size("nspl") };
+    integer const npts{ in.get_size("npts") };
+    UTILS_ASSERT( nspl > 0 && npts > 1, "{}: bad sizes nspl={} npts={}\n", where, nspl, npts );
+    in.get_string(); // name of the saved set, kept for reference
+
+    struct Info { SplineType1D type; int64_t flags, monotone, subtype; string name; };
+    vector<Info> info( static_cast<size_t>(nspl) );
+    for ( Info & I : info ) {
+      I.type     = SplineType1D( in.get_int() );
+      I.flags    = in.get_int();
+      I.monotone = in.get_int();
+      I.subtype  = in.get_int();
+      I.name     = in.get_string();
+    }
+
+    real_type * X    { in.get_reals( npts ) };
+    real_type * Ymin { in.get_reals( nspl ) };
+    real_type * Ymax { in.get_reals( nspl ) };
+
+    vector<real_type*>              Y( static_cast<size_t>(nspl) );
+    vector<real_type*>              Yp( static_cast<size_t>(nspl), nullptr );
+    vector<real_type*>              Ypp( static_cast<size_t>(nspl), nullptr );
+    vector<std::unique_ptr<Spline>> splines( static_cast<size_t>(nspl) );
+    std::map<string,integer>        header_to_position;
+
+    for ( integer spl{0}; spl < nspl; ++spl ) {
+      Info const  & I{ info[spl] };
+      real_type * & pY{ Y[spl] };
+      real_type * & pYp{ Yp[spl] };
+      real_type * & pYpp{ Ypp[spl] };
+      pY = in.get_reals( npts );
+
+      std::unique_ptr<Spline> & s{ splines[spl] };
+      switch ( I.type ) {
+      case SplineType1D::CONSTANT:
+        { auto S = std::make_unique<ConstantSpline>(I.name);
+          S->reserve_external( npts, X, pY );
+          s = std::move(S);
+        }
+        break;
+      case SplineType1D::LINEAR:
+        { auto S = std::make_unique<LinearSpline>(I.name);
+          S->reserve_external( npts, X, pY );
+          s = std::move(S);
+        }
+        break;
+      case SplineType1D::CUBIC:
+        { pYp = in.get_reals( npts );
+          auto S = std::make_unique<CubicSpline>(I.name);
+          S->reserve_external( npts, X, pY, pYp );
+          S->set_initial_BC( CubicSpline_BC( I.subtype & 0xFF ) );
+          S->set_final_BC( CubicSpline_BC( (I.subtype >> 8) & 0xFF ) );
+          s = std::move(S);
+        }
+        break;
+      case SplineType1D::AKIMA:
+        { pYp = in.get_reals( npts );
+          auto S = std::make_unique<AkimaSpline>(I.name);
+          S->reserve_external( npts, X, pY, pYp );
+          s = std::move(S);
+        }
+        break;
+      case SplineType1D::BESSEL:
+        { pYp = in.get_reals( npts );
+          auto S = std::make_unique<BesselSpline>(I.name);
+          S->reserve_external( npts, X, pY, pYp );
+          s = std::move(S);
+        }
+        break;
+      case SplineType1D::PCHIP:
+        { pYp = in.get_reals( npts );
+          auto S = std::make_unique<PchipSpline>(I.name);
+          S->reserve_external( npts, X, pY, pYp );
+          s = std::move(S);
+        }
+        break;
+      case SplineType1D::HERMITE:
+        { pYp = in.get_reals( npts );
+          auto S = std::make_unique<HermiteSpline>(I.name);
+          S->reserve_external( npts, X, pY, pYp );
+          s = std::move(S);
+        }
+        break;
+      case SplineType1D::QUINTIC:
+        { pYp  = in.get_reals( npts );
+          pYpp = in.get_reals( npts );
+          auto S = std::make_unique<QuinticSpline>(I.name);
+          S->reserve_external( npts, X, pY, pYp, pYpp );
+          S->set_quintic_type( QuinticSpline_sub_type( I.subtype ) );
+          s = std::move(S);
+        }
+        break;
+      default:
+        UTILS_ERROR(
+          "{}: spline n.{} named {} has unsupported type {}\n",
+          where, spl, I.name, int(I.type)
+        );
+      }
+      // arrays are already built, no call to build()
+      s->m_npts                    = npts;
+      s->m_curve_is_closed         = (I.flags & 1) != 0;
+      s->m_curve_can_extend        = (I.flags & 2) != 0;
+      s->m_curve_extended_constant = (I.flags & 4) != 0;
+      s->m_search.must_reset();
+      header_to_position.insert( {s->name().data(), spl} );
+    }
+
+    // commit: from here on only the (small) pointer tables are allocated
+    m_nspl  = nspl;
+    m_npts  = npts;
+    m_owned = false;
+    m_mem.free();
+    m_mem_p.reallocate( 3*nspl );
+    m_Y   = m_mem_p( m_nspl );
+    m_Yp  = m_mem_p( m_nspl );
+    m_Ypp = m_mem_p( m_nspl );
+    m_mem_p.must_be_empty( where );
+    std::copy( Y.begin(),   Y.end(),   m_Y   );
+    std::copy( Yp.begin(),  Yp.end(),  m_Yp  );
+    std::copy( Ypp.begin(), Ypp.end(), m_Ypp );
+    m_is_monotone = m_mem_int.realloc( m_nspl );
+    for ( integer spl{0}; spl < nspl; ++spl )
+      m_is_monotone[spl] = static_cast<int>(info[spl].monotone);
+    m_X    = X;
+    m_Ymin = Ymin;
+    m_Ymax = Ymax;
+    m_splines.swap( splines );
+    m_header_to_position.swap( header_to_position );
+    m_mapped = std::move(file);
+    m_table.reset();
+    build_groups();
+  }
+
+  /*\
+   |   ____  _  ____      _     _      ____        _ _
+   |  | __ )(_)/ ___|   _| |__ (_) ___/ ___| _ __ | (_)_ __   ___
+   |  |  _ \| | |  | | | | '_ \| |/ __\___ \| '_ \| | | '_ \ / _ \
+   |  | |_) | | |__| |_| | |_) | | (__ ___) | |_) | | | | | |  __/
+   |  |____/|_|\____\__,_|_.__/|_|\___|____/| .__/|_|_|_| |_|\___|
+   |                                        |_|
+  \*/
+
+  void
+  BiCubicSplineBase::save_binary( string_view file_name ) const {
+    string const where{ fmt::format( "{}[{}]::save_binary", type_name(), m_name ) };
+    UTILS_ASSERT( m_nx > 1 && m_ny > 1, "{}: spline is empty\n", where );
+
+    size_t const nn{ size_t(m_nx)*size_t(m_ny) };
+    BinaryWriter out( file_name, where, binary_kind_bicubic );
+    out.put_int( m_nx );
+    out.put_int( m_ny );
+    out.put_int(
+      ( m_x_closed     ? 1 : 0 ) |
+      ( m_y_closed     ? 2 : 0 ) |
+      ( m_x_can_extend ? 4 : 0 ) |
+      ( m_y_can_extend ? 8 : 0 )
+    );
+    out.put_string( type_name() );
+    out.put_reals( m_X,      m_nx );
+    out.put_reals( m_Y,      m_ny );
+    out.put_reals( &m_Z_min, 1    );
+    out.put_reals( &m_Z_max, 1    );
+    out.put_reals( m_Z,      nn   );
+    out.put_reals( m_DX,     nn   );
+    out.put_reals( m_DY,     nn   );
+    out.put_reals( m_DXY,    nn   );
+    out.check();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BiCubicSplineBase::load_binary( string_view file_name, bool use_mmap ) {
+    string const where{ fmt::format( "{}[{}]::load_binary", type_name(), m_name ) };
+
+    auto file = std::make_unique<MappedFile>( file_name, use_mmap );
+    BinaryReader in( *file, where, binary_kind_bicubic );
+
+    integer const nx{ in.get_size("nx") };
+    integer const ny{ in.get_size("ny") };
+    UTILS_ASSERT( nx > 1 && ny > 1, "{}: bad sizes nx={} ny={}\n", where, nx, ny );
+    int64_t const flags{ in.get_int() };
+    string  const kind{ in.get_string() };
+    UTILS_ASSERT(
+      kind == type_name(),
+      "{}: file `{}` contains a `{}` spline\n", where, file_name, kind
+    );
+
+    // read everything before touching `*this`
+    size_t      const nn{ size_t(nx)*size_t(ny) };
+    real_type * const X     { in.get_reals( nx ) };
+    real_type * const Y     { in.get_reals( ny ) };
+    real_type   const Z_min { *in.get_reals( 1 ) };
+    real_type   const Z_max { *in.get_reals( 1 ) };
+    real_type * const Z     { in.get_reals( nn ) };
+    real_type * const DX    { in.get_reals( nn ) };
+    real_type * const DY    { in.get_reals( nn ) };
+    real_type * const DXY   { in.get_reals( nn ) };
+
+    SplineSurf::clear();
+    m_mem_bicubic.free();
+
+    m_nx           = nx;
+    m_ny           = ny;
+    m_x_closed     = (flags & 1) != 0;
+    m_y_closed     = (flags & 2) != 0;
+    m_x_can_extend = (flags & 4) != 0;
+    m_y_can_extend = (flags & 8) != 0;
+    m_X            = X;
+    m_Y            = Y;
+    m_Z_min        = Z_min;
+    m_Z_max        = Z_max;
+    m_Z            = Z;
+    m_DX           = DX;
+    m_DY           = DY;
+    m_DXY          = DXY;
+
+    m_search_x.must_reset();
+    m_search_y.must_reset();
+    m_mapped = std::move(file);
+  }
+
+  /*\
+   |   ____        _ _            ____              __
+   |  / ___| _ __ | (_)_ __   ___/ ___| _   _ _ __ / _|
+   |  \___ \| '_ \| | | '_ \ / _ \___ \| | | | '__| |_
+   |   ___) | |_) | | | | | |  __/___) | |_| | |  |  _|
+   |  |____/| .__/|_|_|_| |_|\___|____/ \__,_|_|  |_|
+   |        |_|
+  \*/
+
+  void
+  SplineSurf::save_grid( string_view file_name ) const {
+    string const where{ fmt::format( "SplineSurf[{}]::save_grid", m_name ) };
+    UTILS_ASSERT( m_nx > 1 && m_ny > 1, "{}: spline is empty\n", where );
+    BinaryWriter out( file_name, where, binary_kind_grid );
+    out.put_int( m_nx );
+    out.put_int( m_ny );
+    out.put_int( 2 );                 // internal order: C storage, transposed
+    out.put_int( sizeof(real_type) ); // value size
+    out.put_reals( m_X, m_nx );
+    out.put_reals( m_Y, m_ny );
+    out.put_reals( m_Z, size_t(m_nx)*size_t(m_ny) );
+    out.check();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineSurf::load_grid( string_view file_name, bool use_mmap ) {
+    string const where{ fmt::format( "SplineSurf[{}]::load_grid", m_name ) };
+
+    auto file = std::make_unique<MappedFile>( file_name, use_mmap );
+    BinaryReader in( *file, where, binary_kind_grid );
+
+    integer const nx{ in.get_size("nx") };
+    integer const ny{ in.get_size("ny") };
+    UTILS_ASSERT( nx > 1 && ny > 1, "{}: bad sizes nx={} ny={}\n", where, nx, ny );
+    int64_t const order{ in.get_int() };
+    integer const vsize{ in.get_size("value size") };
+    UTILS_ASSERT(
+      vsize == sizeof(float) || vsize == sizeof(double),
+      "{}: bad value size {}\n", where, vsize
+    );
+    real_type const * x{ in.get_reals( nx ) };
+    real_type const * y{ in.get_reals( ny ) };
+    char      const * z{ in.get_bytes( size_t(nx)*size_t(ny)*size_t(vsize) ) };
+    load_grid_values(
+      std::move(file), z, vsize, x, nx, y, ny, (order & 1) != 0, (order & 2) != 0
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineSurf::load_raster(
+    string_view     file_name,
+    real_type const x[],
+    integer   const nx,
+    real_type const y[],
+    integer   const ny,
+    bool      const single_precision,
+    bool      const fortran_storage,
+    bool      const transposed,
+    bool      const use_mmap
+  ) {
+    integer const vsize{ single_precision ? integer(sizeof(float)) : integer(sizeof(double)) };
+    auto file = std::make_unique<MappedFile>( file_name, use_mmap );
+    UTILS_ASSERT(
+      nx > 1 && ny > 1 && file->size() == size_t(nx)*size_t(ny)*size_t(vsize),
+      "SplineSurf[{}]::load_raster: file `{}` of {} bytes is not a {} x {} raster of {}\n",
+      m_name, file_name, file->size(), nx, ny, single_precision ? "float" : "double"
+    );
+    char const * z{ file->data() };
+    load_grid_values( std::move(file), z, vsize, x, nx, y, ny, fortran_storage, transposed );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineSurf::load_grid_values(
+    std::unique_ptr<MappedFile> file,
+    char            const       z[],
+    integer         const       value_size,
+    real_type       const       x[],
+    integer         const       nx,
+    real_type       const       y[],
+    integer         const       ny,
+    bool            const       fortran_storage,
+    bool            const       transposed
+  ) {
+    // values already in internal order can be used in place
+    bool const borrow{
+      file->is_mapped() &&
+      value_size == integer(sizeof(real_type)) &&
+      transposed != fortran_storage
+    };
+    size_t const nn{ size_t(nx)*size_t(ny) };
+    m_nx = nx;
+    m_ny = ny;
+    m_mem.reallocate( borrow ? size_t(nx+ny) : size_t(nx+ny)+nn );
+    m_X = m_mem( nx );
+    m_Y = m_mem( ny );
+    std::copy_n( x, nx, m_X );
+    std::copy_n( y, ny, m_Y );
+    if ( borrow ) {
+      m_Z = reinterpret_cast<real_type*>( const_cast<char*>(z) );
+      m_Z_max = *std::max_element(m_Z,m_Z+nn);
+      m_Z_min = *std::min_element(m_Z,m_Z+nn);
+    } else {
+      m_Z = m_mem( nn );
+      integer const nr{ transposed ? nx : ny };
+      integer const nc{ transposed ? ny : nx };
+      integer const ldZ{ fortran_storage ? nr : nc };
+      if ( value_size == integer(sizeof(float)) )
+        load_Z( reinterpret_cast<float const*>(z), ldZ, fortran_storage, transposed );
+      else
+        load_Z( reinterpret_cast<real_type const*>(z), ldZ, fortran_storage, transposed );
+    }
+    make_spline();
+    if ( borrow ) m_mapped = std::move(file);
+    else          m_mapped.reset();
+  }
+
+  /*\
+   |   _____ _ _          _ ____  _  ____      _     _
+   |  |_   _(_) | ___  __| | __ )(_)/ ___|   _| |__ (_) ___
+   |    | | | | |/ _ \/ _` |  _ \| | |  | | | | '_ \| |/ __|
+   |    | | | | |  __/ (_| | |_) | | |__| |_| | |_) | | (__
+   |    |_| |_|_|\___|\__,_|____/|_|\____\__,_|_.__/|_|\___|
+  \*/
+
+  void
+  TiledBiCubicSpline::open_grid( string_view file_name ) {
+    string const where{ fmt::format( "TiledBiCubicSpline[{}]::open_grid", m_name ) };
+
+    // read only the header and the axes
+    std::ifstream file( string(file_name), std::ios::binary );
+    UTILS_ASSERT( file.good(), "{}: cannot open file `{}`\n", where, file_name );
+    char     magic[8];
+    uint32_t endian, version;
+    int64_t  head[5]; // kind, nx, ny, order, value size
+    file.read( magic, 8 );
+    file.read( reinterpret_cast<char*>(&endian),  sizeof(uint32_t) );
+    file.read( reinterpret_cast<char*>(&version), sizeof(uint32_t) );
+    file.read( reinterpret_cast<char*>(head),     sizeof(head) );
+    UTILS_ASSERT(
+      file.good() && std::memcmp( magic, binary_magic, 8 ) == 0,
+      "{}: file `{}` is not a Splines binary file\n", where, file_name
+    );
+    UTILS_ASSERT(
+      endian == binary_endian_tag && version <= binary_version,
+      "{}: file `{}` has different endianness or unsupported version {}\n",
+      where, file_name, version
+    );
+    UTILS_ASSERT(
+      head[0] == binary_kind_grid && head[1] > 1 && head[2] > 1 &&
+      ( head[4] == 4 || head[4] == 8 ),
+      "{}: file `{}` is not a valid grid file\n", where, file_name
+    );
+    integer const nx{ integer(head[1]) };
+    integer const ny{ integer(head[2]) };
+    vector<real_type> x( static_cast<size_t>(nx) ), y( static_cast<size_t>(ny) );
+    file.read( reinterpret_cast<char*>(x.data()), std::streamsize(nx*sizeof(real_type)) );
+    file.read( reinterpret_cast<char*>(y.data()), std::streamsize(ny*sizeof(real_type)) );
+    UTILS_ASSERT( file.good(), "{}: file `{}` is truncated\n", where, file_name );
+    size_t const offset{ size_t(file.tellg()) };
+    file.close();
+
+    bool const fortran_storage { (head[3] & 1) != 0 };
+    bool const transposed      { (head[3] & 2) != 0 };
+    open_source(
+      file_name, offset, integer(head[4]), transposed != fortran_storage,
+      x.data(), nx, y.data(), ny
+    );
+  }
+
+}
+
+// EOF: SplinesBinary.cc
@@ -30,6 +30,7 @@
 #include "Splines.hh"
 #include "Utils_fmt.hh"
 
+#include <chrono>
 #include <cmath>
 #include <iomanip>
 #include <set>
@@ -47,7 +48,37 @@ namespace Splines {
 
   string
   SplineSurf::info() const {
-    return fmt::format( "Bivariate spline [{}] of type = {}", name(), type_name() );
+    string res{ fmt::format( "Bivariate spline [{}] of type = {}", name(), type_name() ) };
+    #ifdef SPLINES_STATS
+    res += "\n" + stats().to_string();
+    #endif
+    return res;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  SplineStats
+  SplineSurf::stats() const {
+    SplineStats S;
+    m_search_x.collect_stats( S );
+    m_search_y.collect_stats( S );
+    #ifdef SPLINES_STATS
+    S.copy_ms   = m_build_copy_ms;
+    S.coeffs_ms = m_build_coeffs_ms;
+    #endif
+    return S;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineSurf::reset_stats() {
+    m_search_x.reset_stats();
+    m_search_y.reset_stats();
+    #ifdef SPLINES_STATS
+    m_build_copy_ms   = 0;
+    m_build_coeffs_ms = 0;
+    #endif
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -65,15 +96,58 @@ namespace Splines {
     
     m_Z_min =
     m_Z_max = 0;
+
+    m_mapped.reset();
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+  //
+  // Copy `z` in `Z[ix*ny+iy]`. When the source is stored by `x` rows
+  // (`z[ix*ldZ+iy]`) the rows are copied directly, otherwise the matrix
+  // is transposed by square blocks that fit in cache.
+  //
+  template <typename T>
+  static
   void
-  SplineSurf::load_Z(
-    real_type const z[],
+  copy_Z(
+    T         const z[],
     integer   const ldZ,
-    bool      const fortran_storage,
-    bool      const transposed
+    bool      const by_x_rows,
+    integer   const nx,
+    integer   const ny,
+    real_type       Z[]
+  ) {
+    if ( by_x_rows ) {
+      for ( integer ix{0}; ix < nx; ++ix ) {
+        T const * src{ z + static_cast<size_t>(ix)*ldZ };
+        std::copy( src, src+ny, Z + static_cast<size_t>(ix)*ny );
+      }
+    } else {
+      // z[iy*ldZ+ix]
+      constexpr integer BS{32};
+      for ( integer iy0{0}; iy0 < ny; iy0 += BS ) {
+        integer const iy1{ std::min( iy0+BS, ny ) };
+        for ( integer ix0{0}; ix0 < nx; ix0 += BS ) {
+          integer const ix1{ std::min( ix0+BS, nx ) };
+          for ( integer iy{iy0}; iy < iy1; ++iy ) {
+            T const * src{ z + static_cast<size_t>(iy)*ldZ };
+            for ( integer ix{ix0}; ix < ix1; ++ix )
+              Z[ static_cast<size_t>(ix)*ny + iy ] = static_cast<real_type>(src[ix]);
+          }
+        }
+      }
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  template <typename T>
+  void
+  SplineSurf::load_Z_template(
+    T       const z[],
+    integer const ldZ,
+    bool    const fortran_storage,
+    bool    const transposed
   ) {
     // 
     //  +--------------+
@@ -99,33 +173,37 @@ namespace Splines {
         m_name, ldZ, nr, nc
       );
     }
-    integer const tf{ (transposed ? 1 : 0) + (fortran_storage ? 2 : 0) };
-    switch ( tf ) {
-      case 0: // NO transpose NO fortran
-        for ( integer ix{0}; ix < m_nx; ++ix )
-          for ( integer iy{0}; iy < m_ny; ++iy )
-            z_node_ref(ix,iy) = z[ ipos_C(iy,ix,ldZ) ];
-      break;
-      case 1: // YES transpose NO fortran
-        for ( integer ix{0}; ix < m_nx; ++ix )
-          for ( integer iy{0}; iy < m_ny; ++iy )
-            z_node_ref(ix,iy) = z[ ipos_C(ix,iy,ldZ) ];
-      break;
-      case 2: // NO transpose YES fortran
-        for ( integer ix{0}; ix < m_nx; ++ix )
-          for ( integer iy{0}; iy < m_ny; ++iy )
-            z_node_ref(ix,iy) = z[ ipos_F(iy,ix,ldZ) ];
-      break;
-      case 3: // YES transpose YES fortran
-        for ( integer ix{0}; ix < m_nx; ++ix )
-          for ( integer iy{0}; iy < m_ny; ++iy )
-            z_node_ref(ix,iy) = z[ ipos_F(ix,iy,ldZ) ];
-      break;
-    }
+    // C storage transposed and Fortran storage not transposed
+    // have the same layout of m_Z
+    copy_Z( z, ldZ, transposed != fortran_storage, m_nx, m_ny, m_Z );
     m_Z_max = *std::max_element(m_Z,m_Z+m_nx*m_ny);
     m_Z_min = *std::min_element(m_Z,m_Z+m_nx*m_ny);
   }
 
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineSurf::load_Z(
+    real_type const z[],
+    integer   const ldZ,
+    bool      const fortran_storage,
+    bool      const transposed
+  ) {
+    load_Z_template( z, ldZ, fortran_storage, transposed );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  SplineSurf::load_Z(
+    float   const z[],
+    integer const ldZ,
+    bool    const fortran_storage,
+    bool    const transposed
+  ) {
+    load_Z_template( z, ldZ, fortran_storage, transposed );
+  }
+
   #endif
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -158,6 +236,10 @@ namespace Splines {
     bool      const fortran_storage,
     bool      const transposed
   ) {
+    #ifdef SPLINES_STATS
+    using ms = std::chrono::duration<double,std::milli>;
+    auto t0{ std::chrono::steady_clock::now() };
+    #endif
     m_nx = nx;
     m_ny = ny;
     m_mem.reallocate( (nx+1)*(ny+1) );
@@ -167,7 +249,15 @@ namespace Splines {
     for ( integer i{0}; i < nx; ++i ) m_X[i] = x[i*incx];
     for ( integer j{0}; j < ny; ++j ) m_Y[j] = y[j*incy];
     load_Z( z, ldZ, fortran_storage, transposed );
+    #ifdef SPLINES_STATS
+    auto t1{ std::chrono::steady_clock::now() };
+    #endif
     make_spline();
+    m_mapped.reset();
+    #ifdef SPLINES_STATS
+    m_build_copy_ms   = ms( t1 - t0 ).count();
+    m_build_coeffs_ms = ms( std::chrono::steady_clock::now() - t1 ).count();
+    #endif
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -202,6 +292,10 @@ namespace Splines {
     bool      const fortran_storage,
     bool      const transposed
   ) {
+    #ifdef SPLINES_STATS
+    using ms = std::chrono::duration<double,std::milli>;
+    auto t0{ std::chrono::steady_clock::now() };
+    #endif
     m_nx = nx;
     m_ny = ny;
     m_mem.reallocate( (nx+1)*(ny+1) );
@@ -211,7 +305,15 @@ namespace Splines {
     for ( integer i{0}; i < nx; ++i ) m_X[i] = static_cast<real_type>(i);
     for ( integer j{0}; j < ny; ++j ) m_Y[j] = static_cast<real_type>(j);
     load_Z( z, ldZ, fortran_storage, transposed );
+    #ifdef SPLINES_STATS
+    auto t1{ std::chrono::steady_clock::now() };
+    #endif
     make_spline();
+    m_mapped.reset();
+    #ifdef SPLINES_STATS
+    m_build_copy_ms   = ms( t1 - t0 ).count();
+    m_build_coeffs_ms = ms( std::chrono::steady_clock::now() - t1 ).count();
+    #endif
   }
 
   // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -944,6 +1046,7 @@ namespace Splines {
     );
 
     make_spline();
+    m_mapped.reset();
   }
 
   void
@@ -46,4 +46,16 @@
 
 #define AUTIDIFF_SUPPORT
 
+// Uncomment this (or define it when compiling the library) to collect counters
+// of the interval search and build timings, see `Spline::stats()`.
+// The counters are members of the classes only when it is defined: the code
+// using the library must see the same definition (the CMake target exports it).
+// #define SPLINES_STATS
+
+#ifdef SPLINES_STATS
+  #define SPLINES_STATS_ADD(C,N) (C).fetch_add( (N), std::memory_order_relaxed )
+#else
+  #define SPLINES_STATS_ADD(C,N)
+#endif
+
 #endif
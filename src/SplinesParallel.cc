@@ -0,0 +1,345 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+
+#include "Splines.hh"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+using namespace std; // load standard namspace
+#endif
+
+namespace Splines {
+
+  #ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+  /*\
+   |  __        __         _    ____  _             _ _
+   |  \ \      / /__  _ __| | __/ ___|| |_ ___  __ _| (_)_ __   __ _
+   |   \ \ /\ / / _ \| '__| |/ /\___ \| __/ _ \/ _` | | | '_ \ / _` |
+   |    \ V  V / (_) | |  |   <  ___) | ||  __/ (_| | | | | | | (_| |
+   |     \_/\_/ \___/|_|  |_|\_\|____/ \__\___|\__,_|_|_|_| |_|\__, |
+   |                                                          |___/
+  \*/
+
+  WorkStealingPool::WorkStealingPool( integer num_threads ) {
+    if ( num_threads <= 0 ) num_threads = integer(std::thread::hardware_concurrency());
+    if ( num_threads <= 0 ) num_threads = 1;
+    m_size   = num_threads;
+    m_ranges = std::unique_ptr<Range[]>( new Range[size_t(m_size)] );
+    // worker 0 is the thread calling `run`
+    m_threads.reserve( size_t(m_size-1) );
+    for ( integer id{1}; id < m_size; ++id )
+      m_threads.emplace_back( &WorkStealingPool::worker, this, id );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  WorkStealingPool::~WorkStealingPool() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_cv_start.notify_all();
+    for ( auto & t : m_threads ) t.join();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  WorkStealingPool::work( integer id ) {
+    std::function<void(integer)> const & task{ *m_task };
+    // own range first, then steal from the others
+    try {
+      for ( integer k{0}; k < m_size; ++k ) {
+        Range & R{ m_ranges[size_t((id+k)%m_size)] };
+        while ( !m_abort.load( std::memory_order_relaxed ) ) {
+          integer i{ R.next.fetch_add( 1, std::memory_order_relaxed ) };
+          if ( i >= R.end ) break;
+          task(i);
+        }
+      }
+    } catch ( ... ) {
+      // keep the first exception, rethrown by `run` when all the workers are done
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if ( !m_error ) m_error = std::current_exception();
+      m_abort.store( true, std::memory_order_relaxed );
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  WorkStealingPool::worker( integer id ) {
+    unsigned long job{0};
+    while ( true ) {
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv_start.wait( lock, [&]{ return m_stop || m_job != job; } );
+        if ( m_stop ) return;
+        job = m_job;
+      }
+      work( id );
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if ( --m_running == 0 ) m_cv_done.notify_one();
+      }
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  WorkStealingPool::run( integer ntasks, std::function<void(integer)> const & task ) {
+    if ( ntasks <= 0 ) return;
+    if ( m_size == 1 || ntasks == 1 ) {
+      for ( integer i{0}; i < ntasks; ++i ) task(i);
+      return;
+    }
+    // split the tasks in contiguous ranges, one for each worker
+    for ( integer id{0}; id < m_size; ++id ) {
+      m_ranges[size_t(id)].next.store( (ntasks*id)/m_size, std::memory_order_relaxed );
+      m_ranges[size_t(id)].end = (ntasks*(id+1))/m_size;
+    }
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_task    = &task;
+      m_running = m_size-1;
+      m_error   = nullptr;
+      m_abort.store( false, std::memory_order_relaxed );
+      ++m_job;
+    }
+    m_cv_start.notify_all();
+    work( 0 );
+    // always wait the workers: they use `task` owned by the caller
+    std::exception_ptr error;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv_done.wait( lock, [&]{ return m_running == 0; } );
+      m_task = nullptr;
+      std::swap( error, m_error );
+    }
+    if ( error ) std::rethrow_exception( error );
+  }
+
+  #endif
+
+  /*\
+   |   ____        _       _     _____            _
+   |  | __ )  __ _| |_ ___| |__ | ____|_   ____ _| |
+   |  |  _ \ / _` | __/ __| '_ \|  _| \ \ / / _` | |
+   |  | |_) | (_| | || (__| | | | |___ \ V / (_| | |
+   |  |____/ \__,_|\__\___|_| |_|_____| \_/ \__,_|_|
+  \*/
+
+  BatchEvaluator::BatchEvaluator( integer num_threads )
+  : m_pool( new WorkStealingPool( num_threads ) )
+  {}
+
+  BatchEvaluator::BatchEvaluator( Executor executor )
+  : m_executor( std::move(executor) )
+  {
+    UTILS_ASSERT0( m_executor, "BatchEvaluator: empty executor\n" );
+  }
+
+  BatchEvaluator::~BatchEvaluator() {}
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BatchEvaluator::set_chunk_size( integer n ) {
+    UTILS_ASSERT( n > 0, "BatchEvaluator::set_chunk_size( n = {} ) n must be positive\n", n );
+    m_chunk_size = n;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BatchEvaluator::sorted_index(
+    real_type const   x[],
+    integer           i0,
+    integer           i1,
+    vector<integer> & idx
+  ) const {
+    idx.resize( size_t(i1-i0) );
+    std::iota( idx.begin(), idx.end(), i0 );
+    // NaNs at the end, `<` is not an ordering with them
+    auto const last{ std::partition( idx.begin(), idx.end(), [x]( integer a ) { return !std::isnan(x[a]); } ) };
+    std::sort(
+      idx.begin(), last,
+      [x]( integer a, integer b ) { return x[a] < x[b]; }
+    );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BatchEvaluator::run(
+    integer n,
+    std::function<void(integer,integer)> const & kernel
+  ) const {
+    if ( n <= 0 ) return;
+    integer nchunk{ (n+m_chunk_size-1)/m_chunk_size };
+    // `kernel(i0,i1)` evaluates points `i0..i1-1`
+    std::function<void(integer)> task = [&]( integer c ) {
+      integer i0{ c*m_chunk_size };
+      integer i1{ std::min( n, i0+m_chunk_size ) };
+      kernel( i0, i1 );
+    };
+    if ( m_executor ) {
+      m_executor( nchunk, task );
+    } else {
+      // the pool runs one job at a time
+      std::lock_guard<std::mutex> lock(m_run_mutex);
+      m_pool->run( nchunk, task );
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BatchEvaluator::eval(
+    Spline    const & S,
+    real_type const   x[],
+    integer           n,
+    real_type         y[],
+    integer           deriv
+  ) const {
+    UTILS_ASSERT(
+      deriv >= 0 && deriv <= 3,
+      "BatchEvaluator::eval( {}, ..., deriv = {} ) deriv must be in 0..3\n",
+      S.name(), deriv
+    );
+    auto kernel = [&]( integer i0, integer i1 ) {
+      vector<integer> idx;
+      if ( m_sort ) sorted_index( x, i0, i1, idx );
+      for ( integer k{i0}; k < i1; ++k ) {
+        integer i{ m_sort ? idx[size_t(k-i0)] : k };
+        real_type xi{ x[i] };
+        switch ( deriv ) {
+        case 0:  y[i] = S.eval(xi); break;
+        case 1:  y[i] = S.D(xi);    break;
+        case 2:  y[i] = S.DD(xi);   break;
+        default: y[i] = S.DDD(xi);  break;
+        }
+      }
+    };
+    run( n, kernel );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BatchEvaluator::eval(
+    SplineSet const & S,
+    real_type const   x[],
+    integer           n,
+    real_type         vals[],
+    integer           ld
+  ) const {
+    UTILS_ASSERT(
+      ld >= S.num_splines(),
+      "BatchEvaluator::eval( SplineSet {}, ..., ld = {} ) ld must be >= {}\n",
+      S.name(), ld, S.num_splines()
+    );
+    auto kernel = [&]( integer i0, integer i1 ) {
+      vector<integer> idx;
+      if ( m_sort ) sorted_index( x, i0, i1, idx );
+      for ( integer k{i0}; k < i1; ++k ) {
+        integer i{ m_sort ? idx[size_t(k-i0)] : k };
+        S.eval( x[i], vals + size_t(i)*size_t(ld), 1 );
+      }
+    };
+    run( n, kernel );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BatchEvaluator::eval(
+    SplineVec const & S,
+    real_type const   x[],
+    integer           n,
+    real_type         vals[],
+    integer           ld
+  ) const {
+    UTILS_ASSERT(
+      ld >= S.dimension(),
+      "BatchEvaluator::eval( SplineVec {}, ..., ld = {} ) ld must be >= {}\n",
+      S.name(), ld, S.dimension()
+    );
+    auto kernel = [&]( integer i0, integer i1 ) {
+      if ( m_sort ) {
+        vector<integer> idx;
+        sorted_index( x, i0, i1, idx );
+        for ( integer const & i : idx ) S.eval( x[i], vals + size_t(i)*size_t(ld), 1 );
+      } else {
+        S.eval( x + i0, i1 - i0, vals + size_t(i0)*size_t(ld), ld );
+      }
+    };
+    run( n, kernel );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  BatchEvaluator::eval(
+    SplineSurf const & S,
+    real_type  const   x[],
+    real_type  const   y[],
+    integer            n,
+    real_type          z[]
+  ) const {
+    auto kernel = [&]( integer i0, integer i1 ) {
+      vector<integer> idx;
+      if ( m_sort ) {
+        // sort by rows of the grid first, then by column
+        idx.resize( size_t(i1-i0) );
+        std::iota( idx.begin(), idx.end(), i0 );
+        auto const last{ std::partition(
+          idx.begin(), idx.end(),
+          [x,y]( integer a ) { return !std::isnan(x[a]) && !std::isnan(y[a]); }
+        ) };
+        std::sort(
+          idx.begin(), last,
+          [x,y]( integer a, integer b ) { return x[a] < x[b] || ( x[a] == x[b] && y[a] < y[b] ); }
+        );
+      }
+      for ( integer k{i0}; k < i1; ++k ) {
+        integer i{ m_sort ? idx[size_t(k-i0)] : k };
+        z[i] = S.eval( x[i], y[i] );
+      }
+    };
+    run( n, kernel );
+  }
+
+}
+
+// EOF: SplinesParallel.cc
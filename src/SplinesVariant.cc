@@ -0,0 +1,268 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+
+#include "Splines.hh"
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+using namespace std; // load standard namspace
+#endif
+
+namespace Splines {
+
+  /*\
+   |   ____        _ _            _ ____ __     __         _             _
+   |  / ___| _ __ | (_)_ __   ___/ |  _ \\ \   / /_ _ _ __(_) __ _ _ __ | |_
+   |  \___ \| '_ \| | | '_ \ / _ \ | | | |\ \ / / _` | '__| |/ _` | '_ \| __|
+   |   ___) | |_) | | | | | |  __/ | |_| | \ V / (_| | |  | | (_| | | | | |_
+   |  |____/| .__/|_|_|_| |_|\___|_|____/   \_/ \__,_|_|  |_|\__,_|_| |_|\__|
+   |        |_|
+  \*/
+
+  static_assert(
+    std::is_copy_constructible_v<Spline1DVariant> &&
+    std::is_move_constructible_v<Spline1DVariant>,
+    "Spline1DVariant must be copyable and movable"
+  );
+
+  void
+  Spline1DVariant::emplace( SplineType1D tp ) {
+    // the name is stored in the spline, take it before replacing the spline
+    string const name{ this->name() };
+    m_type = SplineType1D::SPLINE_SET; // until the new spline is constructed
+    switch ( tp ) {
+    case SplineType1D::CONSTANT: m_spline.emplace<ConstantSpline>( name ); break;
+    case SplineType1D::LINEAR:   m_spline.emplace<LinearSpline>( name );   break;
+    case SplineType1D::CUBIC:    m_spline.emplace<CubicSpline>( name );    break;
+    case SplineType1D::AKIMA:    m_spline.emplace<AkimaSpline>( name );    break;
+    case SplineType1D::BESSEL:   m_spline.emplace<BesselSpline>( name );   break;
+    case SplineType1D::PCHIP:    m_spline.emplace<PchipSpline>( name );    break;
+    case SplineType1D::QUINTIC:  m_spline.emplace<QuinticSpline>( name );  break;
+    case SplineType1D::HERMITE:  m_spline.emplace<HermiteSpline>( name );  break;
+    default:
+      UTILS_ERROR( "Spline1DVariant[{}] type {} not supported\n", name, to_string(tp) );
+    }
+    m_type = tp;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Spline1DVariant::clear() {
+    m_spline.emplace<Unbuilt>( Unbuilt{ string( this->name() ) } );
+    m_type = SplineType1D::SPLINE_SET;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  string_view
+  Spline1DVariant::name() const {
+    Unbuilt const * U{ std::get_if<Unbuilt>( &m_spline ) };
+    if ( U != nullptr ) return U->name;
+    return is_built() ? spline().name() : string_view(); // after a failed `emplace`
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Spline1DVariant::copy( Spline1DVariant const & S ) {
+    // `emplace` takes the name from the current state
+    m_type = SplineType1D::SPLINE_SET;
+    m_spline.emplace<Unbuilt>( Unbuilt{ string( S.name() ) } );
+    if ( !S.is_built() ) return;
+    emplace( S.m_type );
+    switch ( m_type ) {
+    case SplineType1D::CONSTANT: as<ConstantSpline>().copy_spline( S.as<ConstantSpline>() ); break;
+    case SplineType1D::LINEAR:   as<LinearSpline>().copy_spline( S.as<LinearSpline>() );     break;
+    case SplineType1D::CUBIC:
+      as<CubicSpline>().copy_spline( S.as<CubicSpline>() );
+      as<CubicSpline>().set_initial_BC( S.as<CubicSpline>().initial_BC() );
+      as<CubicSpline>().set_final_BC( S.as<CubicSpline>().final_BC() );
+      break;
+    case SplineType1D::AKIMA:    as<AkimaSpline>().copy_spline( S.as<AkimaSpline>() );       break;
+    case SplineType1D::BESSEL:   as<BesselSpline>().copy_spline( S.as<BesselSpline>() );     break;
+    case SplineType1D::PCHIP:    as<PchipSpline>().copy_spline( S.as<PchipSpline>() );       break;
+    case SplineType1D::QUINTIC:
+      as<QuinticSpline>().copy_spline( S.as<QuinticSpline>() );
+      as<QuinticSpline>().set_quintic_type( S.as<QuinticSpline>().quintic_type() );
+      break;
+    case SplineType1D::HERMITE:  as<HermiteSpline>().copy_spline( S.as<HermiteSpline>() );   break;
+    default: break;
+    }
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Spline1DVariant::build(
+    SplineType1D    tp,
+    real_type const x[], integer incx,
+    real_type const y[], integer incy,
+    integer         n
+  ) {
+    UTILS_ASSERT(
+      tp != SplineType1D::HERMITE,
+      "Spline1DVariant[{}]::build, use `build_hermite` for HERMITE splines\n", name()
+    );
+    emplace( tp );
+    spline().build( x, incx, y, incy, n );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Spline1DVariant::build_hermite(
+    real_type const x[],
+    real_type const y[],
+    real_type const yp[],
+    integer         n
+  ) {
+    emplace( SplineType1D::HERMITE );
+    as<HermiteSpline>().build( x, y, yp, n );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  Spline const &
+  Spline1DVariant::spline() const
+  { return visit( []( Spline const & S ) -> Spline const & { return S; } ); }
+
+  Spline &
+  Spline1DVariant::spline()
+  { return const_cast<Spline &>( static_cast<Spline1DVariant const *>(this)->spline() ); }
+
+  /*\
+   |   ____        _ _            ____  ______     __         _             _
+   |  / ___| _ __ | (_)_ __   ___|___ \|  _ \ \   / /_ _ _ __(_) __ _ _ __ | |_
+   |  \___ \| '_ \| | | '_ \ / _ \ __) | | | \ \ / / _` | '__| |/ _` | '_ \| __|
+   |   ___) | |_) | | | | | |  __// __/| |_| |\ V / (_| | |  | | (_| | | | | |_
+   |  |____/| .__/|_|_|_| |_|\___|_____|____/  \_/ \__,_|_|  |_|\__,_|_| |_|\__|
+   |        |_|
+  \*/
+
+  static_assert(
+    std::is_nothrow_move_constructible_v<Spline2DVariant> &&
+    std::is_nothrow_move_assignable_v<Spline2DVariant>,
+    "Spline2DVariant must be nothrow movable"
+  );
+
+  void
+  Spline2DVariant::emplace( SplineType2D tp ) {
+    // the name is stored in the surface, take it before replacing the surface
+    string const name{ this->name() };
+    switch ( tp ) {
+    case SplineType2D::BILINEAR:  m_spline = std::make_unique<BilinearSpline>( name );  break;
+    case SplineType2D::BICUBIC:   m_spline = std::make_unique<BiCubicSpline>( name );   break;
+    case SplineType2D::BIQUINTIC: m_spline = std::make_unique<BiQuinticSpline>( name ); break;
+    case SplineType2D::AKIMA2D:   m_spline = std::make_unique<Akima2Dspline>( name );   break;
+    }
+    m_type = integer(tp);
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Spline2DVariant::clear() {
+    m_spline.emplace<Unbuilt>( Unbuilt{ string( this->name() ) } );
+    m_type = -1;
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  string_view
+  Spline2DVariant::name() const {
+    Unbuilt const * U{ std::get_if<Unbuilt>( &m_spline ) };
+    return U != nullptr ? string_view( U->name ) : surface().name();
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Spline2DVariant::copy( Spline2DVariant const & S ) {
+    // `emplace` takes the name from the current state
+    m_type = -1;
+    m_spline.emplace<Unbuilt>( Unbuilt{ string( S.name() ) } );
+    if ( !S.is_built() ) return;
+    // the surface is fully determined by the data, rebuild it
+    SplineSurf const & SS{ S.surface() };
+    integer nx{ SS.num_point_x() };
+    integer ny{ SS.num_point_y() };
+    emplace( S.type() );
+    SplineSurf & D{ surface() };
+    D.m_x_closed     = SS.m_x_closed;
+    D.m_y_closed     = SS.m_y_closed;
+    D.m_x_can_extend = SS.m_x_can_extend;
+    D.m_y_can_extend = SS.m_y_can_extend;
+    if ( nx > 0 && ny > 0 )
+      D.build( SS.m_X, 1, SS.m_Y, 1, SS.m_Z, ny, nx, ny, true, false ); // internal storage
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Spline2DVariant::build(
+    SplineType2D    tp,
+    real_type const x[], integer incx,
+    real_type const y[], integer incy,
+    real_type const z[], integer ldZ,
+    integer         nx,
+    integer         ny,
+    bool            fortran_storage,
+    bool            transposed
+  ) {
+    emplace( tp );
+    surface().build( x, incx, y, incy, z, ldZ, nx, ny, fortran_storage, transposed );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  void
+  Spline2DVariant::build(
+    SplineType2D              tp,
+    vector<real_type> const & x,
+    vector<real_type> const & y,
+    vector<real_type> const & z,
+    bool                      fortran_storage,
+    bool                      transposed
+  ) {
+    emplace( tp );
+    surface().build( x, y, z, fortran_storage, transposed );
+  }
+
+  // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+  SplineSurf const &
+  Spline2DVariant::surface() const
+  { return visit( []( SplineSurf const & S ) -> SplineSurf const & { return S; } ); }
+
+  SplineSurf &
+  Spline2DVariant::surface()
+  { return const_cast<SplineSurf &>( static_cast<Spline2DVariant const *>(this)->surface() ); }
+
+}
+
+// EOF: SplinesVariant.cc
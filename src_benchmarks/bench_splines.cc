@@ -0,0 +1,410 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+/*\
+ |  Timing of build and evaluation of all the spline types.
+ |
+ |  usage: bench_splines.exe [--max-size N] [--queries M] [--out file.json]
+ |
+ |  For every spline type and size (10, 100, ..., max-size knots) the
+ |  build time and the time per point of scalar and batched evaluation
+ |  are measured on uniform, clustered and random query patterns.
+ |  Results are written in JSON to compare different commits.
+\*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#pragma clang diagnostic ignored "-Wsign-conversion"
+#endif
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <random>
+
+using namespace Splines;
+using namespace std;
+
+using Clock = chrono::steady_clock;
+
+static double
+elapsed_ns( Clock::time_point t0 ) {
+  return double( chrono::duration_cast<chrono::nanoseconds>( Clock::now() - t0 ).count() );
+}
+
+// prevent the compiler to remove the evaluations
+static volatile real_type sink{0};
+
+/*\
+ |   ____        _
+ |  |  _ \  __ _| |_ __ _
+ |  | | | |/ _` | __/ _` |
+ |  | |_| | (_| | || (_| |
+ |  |____/ \__,_|\__\__,_|
+\*/
+
+static char const * pattern_name[] = { "uniform", "clustered", "random" };
+
+//
+// nodes on [0,1] slightly perturbed from uniform
+//
+static void
+make_nodes( integer n, vector<real_type> & X, mt19937 & gen ) {
+  uniform_real_distribution<real_type> U( -0.3, 0.3 );
+  X.resize( size_t(n) );
+  real_type h{ 1.0/(n-1) };
+  for ( integer i{0}; i < n; ++i ) X[size_t(i)] = (i+U(gen))*h;
+  X.front() = 0;
+  X.back()  = 1;
+  sort( X.begin(), X.end() );
+}
+
+//
+// queries on [a,b]:
+//   uniform   = sorted equispaced sweep
+//   clustered = gaussian clouds around few centers
+//   random    = uniform random
+//
+static void
+make_queries(
+  integer             pattern,
+  integer             m,
+  real_type           a,
+  real_type           b,
+  vector<real_type> & q,
+  mt19937           & gen
+) {
+  q.resize( size_t(m) );
+  switch ( pattern ) {
+  case 0:
+    for ( integer i{0}; i < m; ++i ) q[size_t(i)] = a + ((b-a)*i)/max(m-1,1);
+    break;
+  case 1: {
+    uniform_real_distribution<real_type> C( a, b );
+    real_type center[8];
+    for ( real_type & c : center ) c = C(gen);
+    normal_distribution<real_type> N( 0, (b-a)/200 );
+    for ( integer i{0}; i < m; ++i )
+      q[size_t(i)] = max( a, min( b, center[i%8] + N(gen) ) );
+    } break;
+  default: {
+    uniform_real_distribution<real_type> U( a, b );
+    for ( real_type & x : q ) x = U(gen);
+    } break;
+  }
+}
+
+/*\
+ |   ____                 _ _
+ |  |  _ \ ___  ___ _   _| | |_ ___
+ |  | |_) / _ \/ __| | | | | __/ __|
+ |  |  _ <  __/\__ \ |_| | | |_\__ \
+ |  |_| \_\___||___/\__,_|_|\__|___/
+\*/
+
+class Results {
+  vector<string> m_records;
+public:
+  void
+  add(
+    string const & spline,
+    integer        size,
+    integer        pattern,
+    double         build_ns,
+    double         eval_ns,
+    double         batch_ns
+  ) {
+    m_records.emplace_back( fmt::format(
+      "    {{ \"spline\": \"{}\", \"size\": {}, \"pattern\": \"{}\", "
+      "\"build_ms\": {:.6g}, \"eval_ns\": {:.6g}, \"batch_ns\": {:.6g} }}",
+      spline, size, pattern_name[pattern], build_ns/1e6, eval_ns, batch_ns
+    ) );
+    fmt::print(
+      "{:<22} n={:<9} {:<10} build {:>10.3f} ms  eval {:>8.2f} ns/pt  batch {:>8.2f} ns/pt\n",
+      spline, size, pattern_name[pattern], build_ns/1e6, eval_ns, batch_ns
+    );
+  }
+
+  void
+  write( ostream & s, integer max_size, integer nq ) const {
+    s << "{\n"
+      << "  \"benchmark\": \"Splines\",\n"
+      << "  \"max_size\": " << max_size << ",\n"
+      << "  \"queries\": " << nq << ",\n"
+      << "  \"results\": [\n";
+    for ( size_t i{0}; i < m_records.size(); ++i )
+      s << m_records[i] << ( i+1 < m_records.size() ? ",\n" : "\n" );
+    s << "  ]\n}\n";
+  }
+};
+
+/*\
+ |   ____                  _                          _
+ |  | __ )  ___ _ __   ___| |__  _ __ ___   __ _ _ __| | _____
+ |  |  _ \ / _ \ '_ \ / __| '_ \| '_ ` _ \ / _` | '__| |/ / __|
+ |  | |_) |  __/ | | | (__| | | | | | | | | (_| | |  |   <\__ \
+ |  |____/ \___|_| |_|\___|_| |_|_| |_| |_|\__,_|_|  |_|\_\___/
+\*/
+
+using Factory = function<unique_ptr<Spline>()>;
+
+static void
+bench_1D(
+  string const & name,
+  Factory const & factory,
+  integer         n,
+  integer         nq,
+  Results       & R,
+  mt19937       & gen
+) {
+  vector<real_type> X, Y, Yp;
+  make_nodes( n, X, gen );
+  Y.resize( size_t(n) );
+  Yp.resize( size_t(n) );
+  for ( integer i{0}; i < n; ++i ) {
+    Y[size_t(i)]  = sin( 20*X[size_t(i)] );
+    Yp[size_t(i)] = 20*cos( 20*X[size_t(i)] );
+  }
+
+  unique_ptr<Spline> S{ factory() };
+  Clock::time_point t0{ Clock::now() };
+  if ( S->type() == SplineType1D::HERMITE )
+    static_cast<HermiteSpline*>(S.get())->build( X.data(), Y.data(), Yp.data(), n );
+  else
+    S->build( X.data(), Y.data(), n );
+  double build_ns{ elapsed_ns( t0 ) };
+
+  BatchEvaluator BE(1);
+  vector<real_type> q, v( static_cast<size_t>(nq) );
+  for ( integer p{0}; p < 3; ++p ) {
+    make_queries( p, nq, X.front(), X.back(), q, gen );
+    real_type acc{0};
+    t0 = Clock::now();
+    for ( real_type const & x : q ) acc += S->eval( x );
+    double eval_ns{ elapsed_ns( t0 )/nq };
+    t0 = Clock::now();
+    BE.eval( *S, q.data(), nq, v.data() );
+    double batch_ns{ elapsed_ns( t0 )/nq };
+    sink = acc + v.back();
+    R.add( name, n, p, build_ns, eval_ns, batch_ns );
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+static void
+bench_set( integer n, integer nq, Results & R, mt19937 & gen ) {
+  constexpr integer nspl{4};
+  char const * headers[nspl] = { "linear", "akima", "pchip", "cubic" };
+  SplineType1D stype[nspl] = {
+    SplineType1D::LINEAR, SplineType1D::AKIMA, SplineType1D::PCHIP, SplineType1D::CUBIC
+  };
+  vector<real_type> X, Y( size_t(nspl*n) );
+  make_nodes( n, X, gen );
+  real_type const * pY[nspl];
+  for ( integer k{0}; k < nspl; ++k ) {
+    for ( integer i{0}; i < n; ++i ) Y[size_t(k*n+i)] = sin( (k+1)*10*X[size_t(i)] );
+    pY[k] = Y.data() + k*n;
+  }
+
+  SplineSet S;
+  Clock::time_point t0{ Clock::now() };
+  S.build( nspl, n, headers, stype, X.data(), pY, nullptr );
+  double build_ns{ elapsed_ns( t0 ) };
+
+  BatchEvaluator BE(1);
+  vector<real_type> q, v( static_cast<size_t>(nspl*nq) );
+  for ( integer p{0}; p < 3; ++p ) {
+    make_queries( p, nq, X.front(), X.back(), q, gen );
+    real_type vals[nspl];
+    real_type acc{0};
+    t0 = Clock::now();
+    for ( real_type const & x : q ) { S.eval( x, vals ); acc += vals[0]; }
+    double eval_ns{ elapsed_ns( t0 )/nq };
+    t0 = Clock::now();
+    BE.eval( S, q.data(), nq, v.data(), nspl );
+    double batch_ns{ elapsed_ns( t0 )/nq };
+    sink = acc + v.back();
+    R.add( "SplineSet", n, p, build_ns, eval_ns, batch_ns );
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+static void
+bench_vec( integer n, integer nq, Results & R, mt19937 & gen ) {
+  constexpr integer dim{3};
+  vector<real_type> X, P( size_t(dim*n) );
+  make_nodes( n, X, gen );
+  real_type const * pP[dim];
+  for ( integer k{0}; k < dim; ++k ) {
+    for ( integer i{0}; i < n; ++i ) P[size_t(k*n+i)] = cos( (k+1)*10*X[size_t(i)] );
+    pP[k] = P.data() + k*n;
+  }
+
+  SplineVec S;
+  Clock::time_point t0{ Clock::now() };
+  S.setup( dim, n, pP );
+  S.set_knots( X.data() );
+  S.catmull_rom();
+  double build_ns{ elapsed_ns( t0 ) };
+
+  vector<real_type> q, v( static_cast<size_t>(dim*nq) );
+  for ( integer p{0}; p < 3; ++p ) {
+    make_queries( p, nq, X.front(), X.back(), q, gen );
+    real_type vals[dim];
+    real_type acc{0};
+    t0 = Clock::now();
+    for ( real_type const & x : q ) { S.eval( x, vals, 1 ); acc += vals[0]; }
+    double eval_ns{ elapsed_ns( t0 )/nq };
+    t0 = Clock::now();
+    S.eval( q.data(), nq, v.data(), dim );
+    double batch_ns{ elapsed_ns( t0 )/nq };
+    sink = acc + v.back();
+    R.add( "SplineVec", n, p, build_ns, eval_ns, batch_ns );
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+using Factory2D = function<unique_ptr<SplineSurf>()>;
+
+static void
+bench_2D(
+  string const    & name,
+  Factory2D const & factory,
+  integer           n,
+  integer           nq,
+  Results         & R,
+  mt19937         & gen
+) {
+  // `n` is the total number of knots of the grid
+  integer nx{ max( integer(4), integer( sqrt( real_type(n) ) ) ) };
+  vector<real_type> X, Y, Z( size_t(nx*nx) );
+  make_nodes( nx, X, gen );
+  make_nodes( nx, Y, gen );
+  for ( integer i{0}; i < nx; ++i )
+    for ( integer j{0}; j < nx; ++j )
+      Z[size_t(i*nx+j)] = sin( 10*X[size_t(i)] ) * cos( 7*Y[size_t(j)] );
+
+  unique_ptr<SplineSurf> S{ factory() };
+  Clock::time_point t0{ Clock::now() };
+  S->build( X.data(), 1, Y.data(), 1, Z.data(), nx, nx, nx );
+  double build_ns{ elapsed_ns( t0 ) };
+
+  BatchEvaluator BE(1);
+  vector<real_type> qx, qy, v( static_cast<size_t>(nq) );
+  for ( integer p{0}; p < 3; ++p ) {
+    make_queries( p, nq, X.front(), X.back(), qx, gen );
+    make_queries( p, nq, Y.front(), Y.back(), qy, gen );
+    if ( p == 0 ) shuffle( qy.begin(), qy.end(), gen ); // sweep in x only
+    real_type acc{0};
+    t0 = Clock::now();
+    for ( integer k{0}; k < nq; ++k ) acc += S->eval( qx[size_t(k)], qy[size_t(k)] );
+    double eval_ns{ elapsed_ns( t0 )/nq };
+    t0 = Clock::now();
+    BE.eval( *S, qx.data(), qy.data(), nq, v.data() );
+    double batch_ns{ elapsed_ns( t0 )/nq };
+    sink = acc + v.back();
+    R.add( name, nx*nx, p, build_ns, eval_ns, batch_ns );
+  }
+}
+
+/*\
+ |   __  __       _
+ |  |  \/  | __ _(_)_ __
+ |  | |\/| |/ _` | | '_ \
+ |  | |  | | (_| | | | | |
+ |  |_|  |_|\__,_|_|_| |_|
+\*/
+
+int
+main( int argc, char const * argv[] ) {
+
+  integer max_size{10000000};
+  integer nq{1000000};
+  string  out_file{"bench_splines.json"};
+
+  for ( int i{1}; i < argc; ++i ) {
+    if      ( strcmp( argv[i], "--max-size" ) == 0 && i+1 < argc ) max_size = integer( atol( argv[++i] ) );
+    else if ( strcmp( argv[i], "--queries"  ) == 0 && i+1 < argc ) nq       = integer( atol( argv[++i] ) );
+    else if ( strcmp( argv[i], "--out"      ) == 0 && i+1 < argc ) out_file = argv[++i];
+    else {
+      fmt::print( "usage: {} [--max-size N] [--queries M] [--out file.json]\n", argv[0] );
+      return 1;
+    }
+  }
+
+  auto cubic = []( CubicSpline_BC bc ) -> Factory {
+    return [bc]() {
+      unique_ptr<CubicSpline> S{ new CubicSpline() };
+      S->set_initial_BC( bc );
+      S->set_final_BC( bc );
+      return unique_ptr<Spline>( S.release() );
+    };
+  };
+
+  vector<pair<string,Factory>> splines_1D {
+    { "Constant",         []() { return unique_ptr<Spline>( new ConstantSpline() ); } },
+    { "Linear",           []() { return unique_ptr<Spline>( new LinearSpline() ); } },
+    { "Akima",            []() { return unique_ptr<Spline>( new AkimaSpline() ); } },
+    { "Bessel",           []() { return unique_ptr<Spline>( new BesselSpline() ); } },
+    { "Pchip",            []() { return unique_ptr<Spline>( new PchipSpline() ); } },
+    { "Cubic_extrapolate", cubic( CubicSpline_BC::EXTRAPOLATE ) },
+    { "Cubic_natural",     cubic( CubicSpline_BC::NATURAL ) },
+    { "Cubic_parabolic",   cubic( CubicSpline_BC::PARABOLIC_RUNOUT ) },
+    { "Cubic_not_a_knot",  cubic( CubicSpline_BC::NOT_A_KNOT ) },
+    { "Quintic",          []() { return unique_ptr<Spline>( new QuinticSpline() ); } },
+    { "Hermite",          []() { return unique_ptr<Spline>( new HermiteSpline() ); } }
+  };
+
+  vector<pair<string,Factory2D>> splines_2D {
+    { "Bilinear",  []() { return unique_ptr<SplineSurf>( new BilinearSpline() ); } },
+    { "BiCubic",   []() { return unique_ptr<SplineSurf>( new BiCubicSpline() ); } },
+    { "BiQuintic", []() { return unique_ptr<SplineSurf>( new BiQuinticSpline() ); } },
+    { "Akima2D",   []() { return unique_ptr<SplineSurf>( new Akima2Dspline() ); } }
+  };
+
+  Results R;
+  mt19937 gen(42);
+  for ( integer n{10}; n <= max_size; n *= 10 ) {
+    for ( auto const & S : splines_1D ) bench_1D( S.first, S.second, n, nq, R, gen );
+    bench_set( n, nq, R, gen );
+    bench_vec( n, nq, R, gen );
+    for ( auto const & S : splines_2D ) bench_2D( S.first, S.second, n, nq, R, gen );
+  }
+
+  ofstream file( out_file );
+  R.write( file, max_size, nq );
+  fmt::print( "\nresults saved on {}\n", out_file );
+  return 0;
+}
@@ -0,0 +1,236 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+/*\
+ |  Contention benchmark: one shared spline evaluated at the same time
+ |  by 1..N threads.
+ |
+ |  usage: bench_threads.exe [--threads N] [--calls M] [--out file.json]
+ |
+ |  For a CubicSpline, a SplineSet and a BiCubicSpline reports the total
+ |  throughput, the percentiles of the latency of a call and the scaling
+ |  efficiency with respect to a single thread. Only the standard library
+ |  is used for threads and timing.
+\*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#pragma clang diagnostic ignored "-Wsign-conversion"
+#endif
+
+#include "Splines.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <thread>
+
+using namespace Splines;
+using namespace std;
+
+using Clock = chrono::steady_clock;
+
+// calls timed together, the latency of a call is the mean on the batch
+static constexpr integer batch{64};
+
+// prevent the compiler to remove the evaluations
+static volatile real_type sink{0};
+
+//
+// `kernel(q)` evaluates the shared spline at query `q` (in [0,1])
+//
+using Kernel = function<real_type(real_type)>;
+
+struct Measure {
+  integer threads;
+  double  throughput; // calls per second, all threads
+  double  p50, p90, p99, max; // ns per call
+  double  efficiency;
+};
+
+static Measure
+run_threads( Kernel const & kernel, integer nthreads, integer ncalls ) {
+
+  integer nbatch{ max( integer(1), ncalls/batch ) };
+  vector<vector<double>> lat( static_cast<size_t>(nthreads), vector<double>( static_cast<size_t>(nbatch) ) );
+  vector<vector<real_type>> query( static_cast<size_t>(nthreads) );
+  for ( integer t{0}; t < nthreads; ++t ) {
+    mt19937 gen( unsigned(1234+t) );
+    uniform_real_distribution<real_type> U(0,1);
+    query[size_t(t)].resize( size_t(nbatch*batch) );
+    for ( real_type & q : query[size_t(t)] ) q = U(gen);
+  }
+
+  vector<real_type> acc_thread( static_cast<size_t>(nthreads), 0 ); // summed after the join
+
+  atomic<integer> ready{0};
+  atomic<bool>    go{false};
+
+  auto worker = [&]( integer t ) {
+    vector<double>    & L{ lat[size_t(t)] };
+    real_type const * Q{ query[size_t(t)].data() };
+    real_type acc{0};
+    ++ready;
+    while ( !go.load( memory_order_acquire ) ) this_thread::yield();
+    for ( integer b{0}; b < nbatch; ++b ) {
+      Clock::time_point t0{ Clock::now() };
+      for ( integer k{0}; k < batch; ++k ) acc += kernel( Q[b*batch+k] );
+      L[size_t(b)] = double( chrono::duration_cast<chrono::nanoseconds>( Clock::now() - t0 ).count() ) / batch;
+    }
+    acc_thread[size_t(t)] = acc;
+  };
+
+  vector<thread> pool;
+  for ( integer t{1}; t < nthreads; ++t ) pool.emplace_back( worker, t );
+  while ( ready.load() < nthreads-1 ) this_thread::yield();
+
+  Clock::time_point t0{ Clock::now() };
+  go.store( true, memory_order_release );
+  worker(0);
+  for ( thread & th : pool ) th.join();
+  double wall{ chrono::duration<double>( Clock::now() - t0 ).count() };
+  sink = sink + accumulate( acc_thread.begin(), acc_thread.end(), real_type(0) );
+
+  vector<double> all;
+  all.reserve( size_t(nthreads*nbatch) );
+  for ( vector<double> const & L : lat ) all.insert( all.end(), L.begin(), L.end() );
+  sort( all.begin(), all.end() );
+  auto pct = [&all]( double p ) { return all[ size_t( p*double(all.size()-1) ) ]; };
+
+  Measure M;
+  M.threads    = nthreads;
+  M.throughput = double(nthreads*nbatch*batch)/wall;
+  M.p50        = pct(0.50);
+  M.p90        = pct(0.90);
+  M.p99        = pct(0.99);
+  M.max        = all.back();
+  M.efficiency = 1;
+  return M;
+}
+
+int
+main( int argc, char const * argv[] ) {
+
+  integer max_threads{ integer( thread::hardware_concurrency() ) };
+  integer ncalls{1000000};
+  string  out_file;
+
+  for ( int i{1}; i < argc; ++i ) {
+    if      ( strcmp( argv[i], "--threads" ) == 0 && i+1 < argc ) max_threads = integer( atol( argv[++i] ) );
+    else if ( strcmp( argv[i], "--calls"   ) == 0 && i+1 < argc ) ncalls      = integer( atol( argv[++i] ) );
+    else if ( strcmp( argv[i], "--out"     ) == 0 && i+1 < argc ) out_file    = argv[++i];
+    else {
+      printf( "usage: %s [--threads N] [--calls M] [--out file.json]\n", argv[0] );
+      return 1;
+    }
+  }
+  if ( max_threads < 1 ) max_threads = 1;
+
+  // data
+  constexpr integer n{1000};
+  constexpr integer nspl{4};
+  vector<real_type> X( static_cast<size_t>(n) ), Y( static_cast<size_t>(nspl*n) );
+  for ( integer i{0}; i < n; ++i ) {
+    X[size_t(i)] = real_type(i)/(n-1);
+    X[size_t(i)] += 0.3*X[size_t(i)]*(1-X[size_t(i)]); // non uniform
+    for ( integer k{0}; k < nspl; ++k ) Y[size_t(k*n+i)] = sin( (k+1)*10*X[size_t(i)] );
+  }
+
+  CubicSpline cubic;
+  cubic.build( X.data(), Y.data(), n );
+
+  SplineSet set;
+  char const * headers[nspl] = { "cubic", "akima", "pchip", "linear" };
+  SplineType1D stype[nspl] = {
+    SplineType1D::CUBIC, SplineType1D::AKIMA, SplineType1D::PCHIP, SplineType1D::LINEAR
+  };
+  real_type const * pY[nspl] = { Y.data(), Y.data()+n, Y.data()+2*n, Y.data()+3*n };
+  set.build( nspl, n, headers, stype, X.data(), pY, nullptr );
+
+  constexpr integer nx{200};
+  vector<real_type> G( static_cast<size_t>(nx) ), Z( static_cast<size_t>(nx*nx) );
+  for ( integer i{0}; i < nx; ++i ) G[size_t(i)] = real_type(i)/(nx-1);
+  for ( integer i{0}; i < nx; ++i )
+    for ( integer j{0}; j < nx; ++j )
+      Z[size_t(i*nx+j)] = sin( 10*G[size_t(i)] ) * cos( 7*G[size_t(j)] );
+  BiCubicSpline bicubic;
+  bicubic.build( G.data(), 1, G.data(), 1, Z.data(), nx, nx, nx );
+
+  vector<pair<string,Kernel>> cases {
+    { "CubicSpline", [&cubic]( real_type q ) { return cubic.eval( q ); } },
+    { "SplineSet",   [&set]( real_type q ) {
+        real_type v[nspl];
+        set.eval( q, v );
+        return v[0]+v[1]+v[2]+v[3];
+      }
+    },
+    { "BiCubicSpline", [&bicubic]( real_type q ) { return bicubic.eval( q, 1-q ); } }
+  };
+
+  vector<integer> nthreads;
+  for ( integer t{1}; t < max_threads; t *= 2 ) nthreads.push_back( t );
+  nthreads.push_back( max_threads );
+
+  string json{ "{\n  \"benchmark\": \"threads\",\n  \"results\": [\n" };
+  bool first{true};
+  for ( auto const & C : cases ) {
+    printf( "\n%s\n", C.first.c_str() );
+    printf( "threads   Mcalls/s    p50[ns]    p90[ns]    p99[ns]    max[ns]  efficiency\n" );
+    double base{0};
+    for ( integer t : nthreads ) {
+      Measure M{ run_threads( C.second, t, ncalls ) };
+      if ( t == 1 ) base = M.throughput;
+      M.efficiency = M.throughput / ( t * base );
+      printf(
+        "%7d %10.3f %10.1f %10.1f %10.1f %10.1f %10.1f%%\n",
+        t, M.throughput/1e6, M.p50, M.p90, M.p99, M.max, 100*M.efficiency
+      );
+      char buffer[512];
+      snprintf(
+        buffer, sizeof(buffer),
+        "%s    { \"spline\": \"%s\", \"threads\": %d, \"calls_per_s\": %.6g, "
+        "\"p50_ns\": %.4g, \"p90_ns\": %.4g, \"p99_ns\": %.4g, \"max_ns\": %.4g, \"efficiency\": %.4g }",
+        first ? "" : ",\n", C.first.c_str(), t, M.throughput, M.p50, M.p90, M.p99, M.max, M.efficiency
+      );
+      json += buffer;
+      first = false;
+    }
+  }
+  json += "\n  ]\n}\n";
+
+  if ( !out_file.empty() ) {
+    ofstream file( out_file );
+    file << json;
+    printf( "\nresults saved on %s\n", out_file.c_str() );
+  }
+  return 0;
+}
@@ -0,0 +1,122 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+
+// integral of `S` on `[a,b]` (a <= b) by 3 points Gauss-Legendre on each
+// piece between the nodes, exact for the polynomials up to degree 5
+static
+real_type
+gauss_integral( Splines::Spline const & S, real_type a, real_type b ) {
+  static real_type const w[3]{ 5.0/9.0, 8.0/9.0, 5.0/9.0 };
+  static real_type const t[3]{ -0.7745966692414834, 0, 0.7745966692414834 };
+  vector<real_type> brk{ a };
+  for ( integer i{0}; i < S.num_points(); ++i )
+    if ( S.x_node(i) > a && S.x_node(i) < b ) brk.push_back( S.x_node(i) );
+  brk.push_back( b );
+  real_type res{0};
+  for ( size_t k{1}; k < brk.size(); ++k ) {
+    real_type const c{ (brk[k]+brk[k-1])/2 };
+    real_type const h{ (brk[k]-brk[k-1])/2 };
+    for ( integer q{0}; q < 3; ++q ) res += h * w[q] * S.eval( c + h*t[q] );
+  }
+  return res;
+}
+
+int
+main() {
+
+  cout << "\n\nTEST N.14 (integral)\n\n";
+
+  integer const npts{ 40 };
+  vector<real_type> xx( npts ), yy( npts );
+  for ( integer i{0}; i < npts; ++i ) {
+    xx[i] = i + 0.3*std::sin(1.7*i);
+    yy[i] = std::sin(0.4*xx[i]) + 0.2*std::cos(1.3*xx[i]);
+  }
+
+  LinearSpline  li;
+  CubicSpline   cs;
+  AkimaSpline   ak;
+  BesselSpline  be;
+  PchipSpline   pc;
+  QuinticSpline qs;
+  Splines::Spline * S[]{ &li, &cs, &ak, &be, &pc, &qs };
+
+  real_type const a[]{ xx[0], 0.5, 3.25, 10, 17.7,  xx[npts-1]-1e-3 };
+  real_type const b[]{ xx[npts-1], 0.75, 30.1, 10, 18.2, xx[npts-1] };
+
+  for ( Splines::Spline * P : S ) {
+    P->build( xx.data(), yy.data(), npts );
+    real_type err{0};
+    for ( size_t k{0}; k < std::size(a); ++k ) {
+      real_type const I { P->integral( a[k], b[k] ) };
+      real_type const G { gauss_integral( *P, a[k], b[k] ) };
+      real_type const IR{ P->integral( b[k], a[k] ) };
+      err = std::max( err, std::abs( I - G ) );
+      UTILS_ASSERT(
+        std::abs( I - G ) <= 1e-10*(1+std::abs(G)) && std::abs( I + IR ) <= 1e-12*(1+std::abs(G)),
+        "{}: integral on [{},{}] = {}, Gauss = {}, reversed = {}\n",
+        P->type_name(), a[k], b[k], I, G, IR
+      );
+    }
+    // batched version
+    real_type out[std::size(a)];
+    P->integral( a, b, out, integer(std::size(a)) );
+    for ( size_t k{0}; k < std::size(a); ++k )
+      UTILS_ASSERT(
+        out[k] == P->integral( a[k], b[k] ),
+        "{}: batched integral differs at {}\n", P->type_name(), k
+      );
+    // the table is rebuilt when the spline changes
+    real_type const I0{ P->integral( 2, 9 ) };
+    for ( real_type & v : yy ) v += 1;
+    P->build( xx.data(), yy.data(), npts );
+    real_type const I1{ P->integral( 2, 9 ) };
+    for ( real_type & v : yy ) v -= 1;
+    UTILS_ASSERT(
+      std::abs( I1 - I0 - 7 ) <= 1e-10, "{}: integral after rebuild {} expected {}\n",
+      P->type_name(), I1, I0+7
+    );
+    fmt::print( "{:<16} max |integral - Gauss| = {:.3e}\n", P->type_name(), err );
+  }
+
+  cout << "\nALL DONE!\n\n";
+}
@@ -0,0 +1,105 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+
+int
+main() {
+
+  cout << "\n\nTEST N.15 (range min/max)\n\n";
+
+  integer const npts{ 60 };
+  vector<real_type> xx( npts ), yy( npts );
+  for ( integer i{0}; i < npts; ++i ) {
+    xx[i] = 0.5*i + 0.1*std::sin(3.1*i);
+    yy[i] = std::sin(0.7*xx[i]) * std::exp(-0.02*xx[i]) + 0.1*std::cos(2.3*xx[i]);
+  }
+
+  ConstantSpline co;
+  LinearSpline   li;
+  CubicSpline    cs;
+  AkimaSpline    ak;
+  PchipSpline    pc;
+  QuinticSpline  qs;
+  Splines::Spline * S[]{ &co, &li, &cs, &ak, &pc, &qs };
+
+  real_type const a[]{ xx[0], 0.33, 4.1, 10, 12.25, 20, xx[npts-1]-0.2 };
+  real_type const b[]{ xx[npts-1], 0.34, 9.9, 10.01, 25.5, 20.5, xx[npts-1] };
+
+  for ( Splines::Spline * P : S ) {
+    P->build( xx.data(), yy.data(), npts );
+    real_type err{0};
+    for ( size_t k{0}; k < std::size(a); ++k ) {
+      integer   i_min, i_max;
+      real_type x_min, y_min, x_max, y_max;
+      P->y_min_max( a[k], b[k], i_min, x_min, y_min, i_max, x_max, y_max );
+
+      // brute force on a dense sampling of [a,b] and on the nodes inside
+      integer const nsmp{ 20000 };
+      real_type bmin{ P->eval(a[k]) }, bmax{ bmin };
+      auto sample = [&]( real_type x ) {
+        real_type const v{ P->eval( x ) };
+        bmin = std::min( bmin, v );
+        bmax = std::max( bmax, v );
+      };
+      for ( integer j{1}; j <= nsmp; ++j ) sample( a[k] + (b[k]-a[k])*j/nsmp );
+      for ( real_type x : xx ) if ( x >= a[k] && x <= b[k] ) sample( x );
+      // the extrema are exact, the sampling can only miss them
+      real_type const tol{ 1e-6 };
+      UTILS_ASSERT(
+        y_min <= bmin + 1e-12 && y_min >= bmin - tol &&
+        y_max >= bmax - 1e-12 && y_max <= bmax + tol,
+        "{}: range [{},{}] min {} max {}, sampled min {} max {}\n",
+        P->type_name(), a[k], b[k], y_min, y_max, bmin, bmax
+      );
+      UTILS_ASSERT(
+        x_min >= a[k] && x_min <= b[k] && x_max >= a[k] && x_max <= b[k] &&
+        std::abs( P->eval(x_min) - y_min ) <= 1e-12 &&
+        std::abs( P->eval(x_max) - y_max ) <= 1e-12,
+        "{}: range [{},{}] positions x_min {} x_max {} not consistent\n",
+        P->type_name(), a[k], b[k], x_min, x_max
+      );
+      err = std::max( { err, bmin - y_min, y_max - bmax } );
+    }
+    fmt::print( "{:<16} max gap to sampled extrema = {:.3e}\n", P->type_name(), err );
+  }
+
+  cout << "\nALL DONE!\n\n";
+}
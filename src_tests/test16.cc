@@ -0,0 +1,151 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+using Splines::SplineType1D;
+
+int
+main() {
+
+  cout << "\n\nTEST N.16 (binary save/load)\n\n";
+
+  string const dir{ std::filesystem::temp_directory_path().string() };
+  string const fset{ dir + "/Splines_test16_set.bin" };
+  string const fbad{ dir + "/Splines_test16_bad.bin" };
+  string const fbic{ dir + "/Splines_test16_bicubic.bin" };
+
+  // spline set with all the supported types
+  integer const npts{ 50 };
+  vector<real_type> xx( npts );
+  vector<vector<real_type>> yy( 7, vector<real_type>( npts ) );
+  for ( integer i{0}; i < npts; ++i ) {
+    xx[i] = i + 0.25*std::sin(2.1*i);
+    for ( size_t k{0}; k < yy.size(); ++k ) yy[k][i] = std::sin( 0.2*(k+1)*xx[i] ) + 0.1*k*xx[i];
+  }
+  char const * headers[]{ "const", "linear", "cubic", "akima", "bessel", "pchip", "quintic" };
+  SplineType1D const stype[]{
+    SplineType1D::CONSTANT, SplineType1D::LINEAR, SplineType1D::CUBIC, SplineType1D::AKIMA,
+    SplineType1D::BESSEL,   SplineType1D::PCHIP,  SplineType1D::QUINTIC
+  };
+  real_type const * Y[]{
+    yy[0].data(), yy[1].data(), yy[2].data(), yy[3].data(), yy[4].data(), yy[5].data(), yy[6].data()
+  };
+  integer const nspl{ integer(std::size(headers)) };
+
+  SplineSet ss( "saved" );
+  ss.build( nspl, npts, headers, stype, xx.data(), Y );
+  ss.save_binary( fset );
+
+  for ( bool use_mmap : { true, false } ) {
+    SplineSet ld( "loaded" );
+    ld.load_binary( fset, use_mmap );
+    UTILS_ASSERT(
+      ld.num_splines() == nspl && ld.num_points() == npts,
+      "load_binary( mmap = {} ): {} splines of {} points\n", use_mmap, ld.num_splines(), ld.num_points()
+    );
+    for ( integer k{0}; k < nspl; ++k ) {
+      UTILS_ASSERT(
+        ld.header(k) == headers[k] && ld.get_spline(k)->type() == stype[k],
+        "load_binary: spline {} is `{}`\n", k, ld.header(k)
+      );
+      for ( integer j{0}; j <= 1000; ++j ) {
+        real_type const x{ -1 + (xx[npts-1]+2)*j/1000 };
+        UTILS_ASSERT(
+          ld.eval( x, k ) == ss.eval( x, k ) &&
+          ld.eval_D( x, k ) == ss.eval_D( x, k ) &&
+          ld.eval_DD( x, k ) == ss.eval_DD( x, k ),
+          "load_binary( mmap = {} ): spline `{}` differs at x = {}\n", use_mmap, headers[k], x
+        );
+      }
+    }
+  }
+  fmt::print( "SplineSet round trip OK\n" );
+
+  // a truncated file is rejected and leaves the set untouched
+  {
+    std::ifstream in( fset, std::ios::binary );
+    std::string data( (std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>() );
+    std::ofstream out( fbad, std::ios::binary );
+    out.write( data.data(), std::streamsize( data.size()/2 ) );
+  }
+  SplineSet ld( "loaded" );
+  ld.load_binary( fset );
+  bool rejected{false};
+  try { ld.load_binary( fbad ); } catch ( std::exception const & ) { rejected = true; }
+  UTILS_ASSERT( rejected, "load_binary: truncated file accepted\n" );
+  UTILS_ASSERT(
+    ld.num_splines() == nspl && ld.eval( 7.3, 2 ) == ss.eval( 7.3, 2 ),
+    "load_binary: failed load modified the spline set\n"
+  );
+  fmt::print( "truncated file rejected, set unchanged\n" );
+
+  // bicubic surface
+  integer const nx{ 12 }, ny{ 9 };
+  vector<real_type> x( nx ), y( ny ), z( nx*ny );
+  for ( integer i{0}; i < nx; ++i ) x[i] = i*i*0.1;
+  for ( integer j{0}; j < ny; ++j ) y[j] = j*0.5;
+  for ( integer i{0}; i < nx; ++i )
+    for ( integer j{0}; j < ny; ++j )
+      z[i+j*nx] = std::sin(x[i]) * std::cos(y[j]);
+
+  BiCubicSpline bc( "saved" );
+  bc.build( x.data(), 1, y.data(), 1, z.data(), nx, nx, ny, false, false );
+  bc.save_binary( fbic );
+  BiCubicSpline bl( "loaded" );
+  bl.load_binary( fbic );
+  for ( integer i{0}; i <= 100; ++i )
+    for ( integer j{0}; j <= 100; ++j ) {
+      real_type const xs{ x[nx-1]*i/100 }, ys{ y[ny-1]*j/100 };
+      UTILS_ASSERT(
+        bl.eval( xs, ys ) == bc.eval( xs, ys ) && bl.Dxy( xs, ys ) == bc.Dxy( xs, ys ),
+        "BiCubicSpline load_binary differs at ({},{})\n", xs, ys
+      );
+    }
+  fmt::print( "BiCubicSpline round trip OK\n" );
+
+  std::remove( fset.c_str() );
+  std::remove( fbad.c_str() );
+  std::remove( fbic.c_str() );
+
+  cout << "\nALL DONE!\n\n";
+}
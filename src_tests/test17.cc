@@ -0,0 +1,178 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+
+static integer const nx{ 7 }, ny{ 6 }, nz{ 5 };
+static real_type xx[nx], yy[ny], zz[nz];
+
+template <typename FUN>
+static
+vector<real_type>
+sample( FUN const & f ) {
+  vector<real_type> v( nx*ny*nz );
+  for ( integer i{0}; i < nx; ++i )
+    for ( integer j{0}; j < ny; ++j )
+      for ( integer k{0}; k < nz; ++k )
+        v[(i*ny+j)*nz+k] = f( xx[i], yy[j], zz[k] );
+  return v;
+}
+
+// value and gradient of `S` agree with `f` on a grid of points inside the nodes
+template <typename FUN>
+static
+real_type
+max_error( Splines::SplineVol const & S, FUN const & f, bool grad ) {
+  real_type err{0};
+  integer const m{ 13 };
+  for ( integer a{0}; a <= m; ++a )
+    for ( integer b{0}; b <= m; ++b )
+      for ( integer c{0}; c <= m; ++c ) {
+        real_type const x{ xx[0] + (xx[nx-1]-xx[0])*a/m };
+        real_type const y{ yy[0] + (yy[ny-1]-yy[0])*b/m };
+        real_type const z{ zz[0] + (zz[nz-1]-zz[0])*c/m };
+        real_type d[4];
+        S.D( x, y, z, d );
+        err = std::max( err, std::abs( S.eval( x, y, z ) - f( x, y, z ) ) );
+        err = std::max( err, std::abs( d[0] - f( x, y, z ) ) );
+        if ( grad ) {
+          real_type const h{ 1e-6 };
+          err = std::max( err, std::abs( d[1] - ( f(x+h,y,z) - f(x-h,y,z) )/(2*h) ) );
+          err = std::max( err, std::abs( d[2] - ( f(x,y+h,z) - f(x,y-h,z) )/(2*h) ) );
+          err = std::max( err, std::abs( d[3] - ( f(x,y,z+h) - f(x,y,z-h) )/(2*h) ) );
+        }
+      }
+  return err;
+}
+
+int
+main() {
+
+  cout << "\n\nTEST N.17 (SplineVol)\n\n";
+
+  for ( integer i{0}; i < nx; ++i ) xx[i] = i + 0.2*std::sin(1.3*i);
+  for ( integer j{0}; j < ny; ++j ) yy[j] = 0.5*j*j;
+  for ( integer k{0}; k < nz; ++k ) zz[k] = -1 + 0.7*k;
+
+  auto smooth = []( real_type x, real_type y, real_type z ) {
+    return std::sin(0.7*x) * std::cos(0.3*y) + 0.2*z*z;
+  };
+  auto affine = []( real_type x, real_type y, real_type z ) {
+    return 1 + 2*x - y + 0.5*z;
+  };
+  auto trilinear = []( real_type x, real_type y, real_type z ) {
+    return 1 + 2*x - y + 0.5*z + 0.3*x*y - 0.1*y*z + 0.05*x*y*z;
+  };
+
+  Splines::TrilinearSpline tl;
+  Splines::TriCubicSpline  tc;
+  Splines::Akima3Dspline   ak;
+  Splines::SplineVol * V[]{ &tl, &tc, &ak };
+
+  vector<real_type> vs{ sample( smooth ) };
+  for ( Splines::SplineVol * S : V ) {
+    S->build( xx, nx, yy, ny, zz, nz, vs.data() );
+    // interpolation of the nodes
+    for ( integer i{0}; i < nx; ++i )
+      for ( integer j{0}; j < ny; ++j )
+        for ( integer k{0}; k < nz; ++k )
+          UTILS_ASSERT(
+            std::abs( S->eval( xx[i], yy[j], zz[k] ) - vs[(i*ny+j)*nz+k] ) <= 1e-12,
+            "{}: node ({},{},{}) not interpolated\n", S->type_name(), i, j, k
+          );
+    // batched evaluation equals the single point one
+    integer const n{ 500 };
+    vector<real_type> px( n ), py( n ), pz( n ), v( n ), g( 3*n );
+    for ( integer q{0}; q < n; ++q ) {
+      px[q] = xx[0] + (xx[nx-1]-xx[0]) * std::abs( std::sin( 1.1*q ) );
+      py[q] = yy[0] + (yy[ny-1]-yy[0]) * std::abs( std::sin( 2.3*q ) );
+      pz[q] = zz[0] + (zz[nz-1]-zz[0]) * std::abs( std::sin( 3.7*q ) );
+    }
+    S->eval( px.data(), py.data(), pz.data(), n, v.data() );
+    S->D( px.data(), py.data(), pz.data(), n, v.data(), g.data() );
+    for ( integer q{0}; q < n; ++q ) {
+      real_type d[4];
+      S->D( px[q], py[q], pz[q], d );
+      UTILS_ASSERT(
+        v[q] == d[0] && g[3*q] == d[1] && g[3*q+1] == d[2] && g[3*q+2] == d[3],
+        "{}: batched evaluation differs at point {}\n", S->type_name(), q
+      );
+    }
+  }
+
+  // the trilinear spline reproduces trilinear data, the tricubic ones affine data
+  vector<real_type> vt{ sample( trilinear ) };
+  tl.build( xx, nx, yy, ny, zz, nz, vt.data() );
+  real_type const e_tl{ max_error( tl, trilinear, false ) };
+  UTILS_ASSERT( e_tl <= 1e-12, "trilinear data not reproduced, error {}\n", e_tl );
+
+  vector<real_type> va{ sample( affine ) };
+  Splines::SplineVol * C[]{ &tc, &ak };
+  for ( Splines::SplineVol * S : C ) {
+    S->build( xx, nx, yy, ny, zz, nz, va.data() );
+    real_type const e{ max_error( *S, affine, true ) };
+    UTILS_ASSERT( e <= 1e-8, "{}: affine data not reproduced, error {}\n", S->type_name(), e );
+    fmt::print( "{:<10} affine data error = {:.3e}\n", S->type_name(), e );
+  }
+  fmt::print( "{:<10} trilinear data error = {:.3e}\n", tl.type_name(), e_tl );
+
+  // data constant along `z`: each slice is the bicubic spline of the same data
+  vector<real_type> v2( nx*ny ), v3( nx*ny*nz );
+  for ( integer i{0}; i < nx; ++i )
+    for ( integer j{0}; j < ny; ++j ) {
+      real_type const s{ smooth( xx[i], yy[j], 0 ) };
+      v2[i+j*nx] = s;
+      for ( integer k{0}; k < nz; ++k ) v3[(i*ny+j)*nz+k] = s;
+    }
+  BiCubicSpline bc;
+  bc.build( vector<real_type>( xx, xx+nx ), vector<real_type>( yy, yy+ny ), v2 );
+  tc.build( xx, nx, yy, ny, zz, nz, v3.data() );
+  real_type e_bc{0};
+  for ( integer a{0}; a <= 40; ++a )
+    for ( integer b{0}; b <= 40; ++b ) {
+      real_type const x{ xx[0] + (xx[nx-1]-xx[0])*a/40 };
+      real_type const y{ yy[0] + (yy[ny-1]-yy[0])*b/40 };
+      e_bc = std::max( e_bc, std::abs( tc.eval( x, y, 0.1 ) - bc.eval( x, y ) ) );
+    }
+  fmt::print( "tricubic vs bicubic on z slices, error = {:.3e}\n", e_bc );
+  UTILS_ASSERT( e_bc <= 1e-12, "tricubic does not reduce to bicubic, error {}\n", e_bc );
+
+  cout << "\nALL DONE!\n\n";
+}
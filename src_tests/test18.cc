@@ -0,0 +1,152 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+#include <memory>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+using Splines::SplineBank;
+
+static
+std::unique_ptr<Splines::Spline>
+make_spline( SplineType1D type ) {
+  switch ( type ) {
+  case SplineType1D::LINEAR:  return std::make_unique<LinearSpline>();
+  case SplineType1D::CUBIC:   return std::make_unique<CubicSpline>();
+  case SplineType1D::AKIMA:   return std::make_unique<AkimaSpline>();
+  case SplineType1D::BESSEL:  return std::make_unique<BesselSpline>();
+  case SplineType1D::PCHIP:   return std::make_unique<PchipSpline>();
+  default:                    return std::make_unique<Splines::HermiteSpline>();
+  }
+}
+
+int
+main() {
+
+  cout << "\n\nTEST N.18 (SplineBank)\n\n";
+
+  // members of different sizes and node spacings
+  integer const nspl{ 200 };
+  vector<integer>   offset{ 0 };
+  vector<real_type> X, Y, Yp;
+  for ( integer id{0}; id < nspl; ++id ) {
+    integer const n{ 2 + (7*id) % 23 };
+    real_type x{ -1.0 + 0.01*id };
+    for ( integer i{0}; i < n; ++i ) {
+      x += 0.1 + 0.3*std::abs( std::sin( 1.7*i + 0.3*id ) );
+      X.emplace_back( x );
+      Y.emplace_back( std::sin( x + 0.1*id ) + 0.2*std::cos( 3*x ) );
+      Yp.emplace_back( std::cos( x + 0.1*id ) - 0.6*std::sin( 3*x ) );
+    }
+    offset.emplace_back( integer( X.size() ) );
+  }
+
+  // random queries (members and abscissae) inside the nodes of each member
+  integer const nq{ 20000 };
+  vector<integer>   ids( nq );
+  vector<real_type> xs( nq ), out( nq );
+  for ( integer k{0}; k < nq; ++k ) {
+    integer const id{ (k*37) % nspl };
+    real_type const a{ X[size_t(offset[id])] }, b{ X[size_t(offset[id+1]-1)] };
+    ids[k] = id;
+    xs[k]  = a + (b-a) * std::abs( std::sin( 0.37*k ) );
+  }
+
+  SplineType1D const types[]{
+    SplineType1D::LINEAR, SplineType1D::CUBIC, SplineType1D::AKIMA,
+    SplineType1D::BESSEL, SplineType1D::PCHIP, SplineType1D::HERMITE
+  };
+  for ( SplineType1D type : types ) {
+    bool const hermite{ type == SplineType1D::HERMITE };
+
+    // the same members added one at a time and in CSR format
+    SplineBank bank( "bank", 4 ), bank_csr( "bank_csr", 1 );
+    bank.setup( type );
+    bank_csr.setup( type );
+    for ( integer id{0}; id < nspl; ++id ) {
+      size_t  const i0{ size_t(offset[id]) };
+      integer const n { offset[id+1]-offset[id] };
+      integer const k { hermite ? bank.add( &X[i0], &Y[i0], &Yp[i0], n ) : bank.add( &X[i0], &Y[i0], n ) };
+      UTILS_ASSERT( k == id, "{}: add returned id {} instead of {}\n", to_string(type), k, id );
+    }
+    bank.build();
+    bank_csr.build( nspl, offset.data(), X.data(), Y.data(), hermite ? Yp.data() : nullptr );
+
+    // per-member runtime splines
+    vector<std::unique_ptr<Splines::Spline>> S;
+    for ( integer id{0}; id < nspl; ++id ) {
+      size_t  const i0{ size_t(offset[id]) };
+      integer const n { offset[id+1]-offset[id] };
+      S.emplace_back( make_spline( type ) );
+      if ( hermite )
+        static_cast<Splines::CubicSplineBase*>(S.back().get())->build( &X[i0], &Y[i0], &Yp[i0], n );
+      else
+        S.back()->build( &X[i0], &Y[i0], n );
+    }
+
+    real_type err{0};
+    for ( integer deriv{0}; deriv <= 3; ++deriv ) {
+      bank.eval( ids.data(), xs.data(), out.data(), nq, deriv );
+      for ( integer k{0}; k < nq; ++k ) {
+        Splines::Spline const & s{ *S[size_t(ids[k])] };
+        real_type ref, one, csr;
+        switch ( deriv ) {
+        case 0:  ref = s.eval(xs[k]); one = bank.eval(ids[k],xs[k]); csr = bank_csr.eval(ids[k],xs[k]); break;
+        case 1:  ref = s.D(xs[k]);    one = bank.D(ids[k],xs[k]);    csr = bank_csr.D(ids[k],xs[k]);    break;
+        case 2:  ref = s.DD(xs[k]);   one = bank.DD(ids[k],xs[k]);   csr = bank_csr.DD(ids[k],xs[k]);   break;
+        default: ref = s.DDD(xs[k]);  one = bank.DDD(ids[k],xs[k]);  csr = bank_csr.DDD(ids[k],xs[k]);  break;
+        }
+        UTILS_ASSERT(
+          out[k] == one && csr == one,
+          "{}: member {} at x = {}, batched {}, single {}, CSR {} differ\n",
+          to_string(type), ids[k], xs[k], out[k], one, csr
+        );
+        real_type const e{ std::abs( one - ref ) / ( 1 + std::abs( ref ) ) };
+        UTILS_ASSERT(
+          e <= 1e-9,
+          "{}: member {} derivative {} at x = {}, bank {}, spline {}\n",
+          to_string(type), ids[k], deriv, xs[k], one, ref
+        );
+        err = std::max( err, e );
+      }
+    }
+    fmt::print( "{:<16} max relative difference with the splines = {:.3e}\n", to_string(type), err );
+  }
+
+  cout << "\nALL DONE!\n\n";
+}
@@ -0,0 +1,198 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+#include <memory>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+
+static
+std::unique_ptr<Splines::Spline>
+make_spline( SplineType1D type ) {
+  switch ( type ) {
+  case SplineType1D::CONSTANT: return std::make_unique<ConstantSpline>();
+  case SplineType1D::LINEAR:   return std::make_unique<LinearSpline>();
+  case SplineType1D::CUBIC:    return std::make_unique<CubicSpline>();
+  case SplineType1D::AKIMA:    return std::make_unique<AkimaSpline>();
+  case SplineType1D::BESSEL:   return std::make_unique<BesselSpline>();
+  case SplineType1D::PCHIP:    return std::make_unique<PchipSpline>();
+  default:                     return std::make_unique<QuinticSpline>();
+  }
+}
+
+// max |A-B| on a dense sampling of [a,b] plus the points `x`
+template <typename FA, typename FB>
+static
+real_type
+dense_error( FA const & A, FB const & B, real_type a, real_type b, vector<real_type> const & x ) {
+  real_type err{0};
+  integer const nsmp{ 100000 };
+  for ( integer j{0}; j <= nsmp; ++j ) {
+    real_type const t{ a + (b-a)*j/nsmp };
+    err = std::max( err, std::abs( A(t) - B(t) ) );
+  }
+  for ( real_type t : x ) err = std::max( err, std::abs( A(t) - B(t) ) );
+  return err;
+}
+
+int
+main() {
+
+  cout << "\n\nTEST N.19 (compression)\n\n";
+
+  integer const npts{ 2000 };
+  vector<real_type> xx( npts ), yy( npts );
+  for ( integer i{0}; i < npts; ++i ) {
+    xx[i] = 0.01*i + 0.002*std::sin(1.9*i);
+    yy[i] = std::sin(xx[i]) + 0.3*std::cos(2.7*xx[i]) + 0.01*xx[i]*xx[i];
+  }
+  real_type const a{ xx.front() }, b{ xx.back() };
+
+  Splines::SplineCompressor comp( 1e-5, 2 );
+
+  // a spline against its compressed version: the error is bounded everywhere
+  SplineType1D const types[]{
+    SplineType1D::CONSTANT, SplineType1D::LINEAR, SplineType1D::CUBIC,
+    SplineType1D::AKIMA,    SplineType1D::BESSEL, SplineType1D::PCHIP,
+    SplineType1D::QUINTIC
+  };
+  for ( SplineType1D type : types ) {
+    std::unique_ptr<Splines::Spline> S{ make_spline( type ) };
+    S->build( xx.data(), yy.data(), npts );
+    std::unique_ptr<Splines::Spline> C{ comp.compress( *S ) };
+    Splines::SplineCompressInfo const & info{ comp.info() };
+    real_type const err{ dense_error(
+      [&S]( real_type t ) { return S->eval(t); },
+      [&C]( real_type t ) { return C->eval(t); },
+      a, b, xx
+    ) };
+    fmt::print(
+      "{:<16} nodes {:>4} -> {:>4}, bound {:.3e}, sampled error {:.3e}\n",
+      to_string(type), info.npts_in, info.npts_out, info.max_error, err
+    );
+    UTILS_ASSERT(
+      C->type() == type && info.npts_out == C->num_points() && info.npts_out <= npts,
+      "{}: compressed spline of type {} with {} nodes\n",
+      to_string(type), to_string(C->type()), C->num_points()
+    );
+    UTILS_ASSERT(
+      err <= info.max_error*(1+1e-8) + 1e-14,
+      "{}: sampled error {} exceeds the bound {}\n", to_string(type), err, info.max_error
+    );
+    UTILS_ASSERT(
+      !info.bounded || info.max_error <= comp.tolerance(),
+      "{}: bound {} above the tolerance\n", to_string(type), info.max_error
+    );
+  }
+
+  // raw data: the error is measured on the data points
+  {
+    std::unique_ptr<Splines::Spline> C{ comp.compress( SplineType1D::CUBIC, xx.data(), yy.data(), npts ) };
+    real_type err{0};
+    for ( integer i{0}; i < npts; ++i ) err = std::max( err, std::abs( C->eval(xx[i]) - yy[i] ) );
+    fmt::print( "raw data         nodes {:>4} -> {:>4}, error on the data {:.3e}\n", npts, C->num_points(), err );
+    UTILS_ASSERT(
+      err <= comp.info().max_error*(1+1e-8) + 1e-14 && err <= comp.tolerance(),
+      "raw data: error {} bound {}\n", err, comp.info().max_error
+    );
+  }
+
+  // a set: common nodes, each column bounded
+  {
+    vector<real_type> y1( npts ), y2( npts );
+    for ( integer i{0}; i < npts; ++i ) {
+      y1[i] = std::exp( -0.1*xx[i] ) * std::cos( 3*xx[i] );
+      y2[i] = xx[i];
+    }
+    char const * headers[]{ "y", "y1", "y2" };
+    SplineType1D const stype[]{ SplineType1D::CUBIC, SplineType1D::AKIMA, SplineType1D::LINEAR };
+    real_type const * Y[]{ yy.data(), y1.data(), y2.data() };
+    SplineSet in( "in" ), out( "out" );
+    in.build( 3, npts, headers, stype, xx.data(), Y );
+    comp.compress( in, out );
+    UTILS_ASSERT( out.num_splines() == 3, "set: {} columns\n", out.num_splines() );
+    for ( integer k{0}; k < 3; ++k ) {
+      real_type const err{ dense_error(
+        [&in,k]( real_type t ) { return in.eval(t,k); },
+        [&out,k]( real_type t ) { return out.eval(t,k); },
+        a, b, xx
+      ) };
+      fmt::print( "set column {}     nodes {:>4} -> {:>4}, sampled error {:.3e}\n", k, npts, out.num_points(), err );
+      UTILS_ASSERT(
+        err <= comp.info().max_error*(1+1e-8) + 1e-14,
+        "set column {}: sampled error {} exceeds the bound {}\n", k, err, comp.info().max_error
+      );
+    }
+  }
+
+  // settings of the input columns: the vector evaluation of the compressed
+  // set sees them, also outside the nodes
+  {
+    vector<real_type> y1( npts );
+    for ( integer i{0}; i < npts; ++i ) y1[i] = std::sin( 0.7*xx[i] ) + 0.1*xx[i];
+    char const * headers[]{ "y", "y1" };
+    SplineType1D const stype[]{ SplineType1D::CUBIC, SplineType1D::CUBIC };
+    real_type const * Y[]{ yy.data(), y1.data() };
+    SplineSet in( "in" ), out( "out" );
+    in.build( 2, npts, headers, stype, xx.data(), Y );
+    in.get_spline(0)->make_extended_constant();
+    CubicSpline * C{ dynamic_cast<CubicSpline*>( in.get_spline(1) ) };
+    UTILS_ASSERT( C != nullptr, "set column 1 is not a CubicSpline\n" );
+    C->set_initial_BC( Splines::CubicSpline_BC::NATURAL );
+    C->set_final_BC( Splines::CubicSpline_BC::NATURAL );
+    C->build();
+    comp.compress( in, out );
+    UTILS_ASSERT( out.get_spline(0)->is_extended_constant(), "set column 0 is not extended constant\n" );
+    real_type vals[2], err{0};
+    for ( integer j{0}; j <= 200; ++j ) {
+      real_type const x{ a - 1 + (b-a+2)*j/200 };
+      out.eval( x, vals );
+      for ( integer k{0}; k < 2; ++k ) {
+        real_type const ref{ out.get_spline(k)->eval(x) };
+        UTILS_ASSERT(
+          std::abs( vals[k] - ref ) <= 1e-12*( 1 + std::abs(ref) ),
+          "set settings: column {} at x = {}: eval(x,vals) = {}, spline = {}\n", k, x, vals[k], ref
+        );
+        err = std::max( err, std::abs( vals[k] - ref ) );
+      }
+    }
+    fmt::print( "set settings     eval(x,vals) vs columns on [a-1,b+1], max difference {:.3e}\n", err );
+  }
+
+  cout << "\nALL DONE!\n\n";
+}
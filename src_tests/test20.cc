@@ -0,0 +1,154 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+using Splines::SplineLUTType;
+
+int
+main() {
+
+  cout << "\n\nTEST N.20 (lookup tables)\n\n";
+
+  integer const npts{ 300 };
+  vector<real_type> xx( npts ), yy( npts );
+  for ( integer i{0}; i < npts; ++i ) {
+    xx[i] = 0.05*i + 0.01*std::sin(1.9*i);
+    yy[i] = std::sin(xx[i]) + 0.3*std::cos(2.7*xx[i]);
+  }
+
+  CubicSpline   cs;
+  QuinticSpline qs;
+  cs.build( xx, yy );
+  qs.build( xx, yy );
+  Splines::Spline const * S[]{ &cs, &qs };
+
+  real_type const tol{ 1e-6 };
+  for ( SplineLUTType t : { SplineLUTType::HERMITE, SplineLUTType::LINEAR } ) {
+    Splines::SplineLUTCompiler comp( tol, t, 2 );
+    for ( Splines::Spline const * P : S ) {
+      Splines::SplineLUT1D T;
+      comp.compile( *P, T );
+      // dense sampling, 37 points per cell, and the knots of the input
+      real_type err{0};
+      integer const nsmp{ 37*T.num_cells() };
+      for ( integer j{0}; j <= nsmp; ++j ) {
+        real_type const x{ T.x_min() + (T.x_max()-T.x_min())*j/nsmp };
+        err = std::max( err, std::abs( T.eval(x) - P->eval(x) ) );
+      }
+      for ( real_type x : xx ) err = std::max( err, std::abs( T.eval(x) - P->eval(x) ) );
+      fmt::print(
+        "{:<8} {:<16} cells {:>6}, max_error {:.3e}, sampled error {:.3e}\n",
+        to_string(t), P->type_name(), T.num_cells(), T.max_error(), err
+      );
+      UTILS_ASSERT( T.tolerance_met(), "{} {}: tolerance not met\n", to_string(t), P->type_name() );
+      // `max_error` is a bound of the error
+      UTILS_ASSERT(
+        err <= T.max_error() && T.max_error() <= tol,
+        "{} {}: sampled error {}, max_error {}, tolerance {}\n",
+        to_string(t), P->type_name(), err, T.max_error(), tol
+      );
+    }
+  }
+
+  // a narrow spike between the cells: seen by the bound at the knots
+  {
+    vector<real_type> const xs{ 0, 0.3001, 0.30015, 0.3002, 1 };
+    vector<real_type> const ys{ 0, 0, 1, 0, 0 };
+    LinearSpline ls;
+    ls.build( xs, ys );
+    for ( SplineLUTType t : { SplineLUTType::HERMITE, SplineLUTType::LINEAR } ) {
+      Splines::SplineLUTCompiler comp( tol, t, 2 );
+      comp.set_max_bytes( 16*4*sizeof(real_type) ); // 16 cells
+      Splines::SplineLUT1D T;
+      comp.compile( ls, T );
+      real_type err{0};
+      for ( real_type x : xs ) err = std::max( err, std::abs( T.eval(x) - ls.eval(x) ) );
+      fmt::print(
+        "{:<8} {:<16} cells {:>6}, max_error {:.3e}, error at the knots {:.3e}\n",
+        to_string(t), "spike", T.num_cells(), T.max_error(), err
+      );
+      UTILS_ASSERT(
+        !T.tolerance_met() && err >= 0.9 && err <= T.max_error(),
+        "{} spike: error at the knots {}, max_error {}\n", to_string(t), err, T.max_error()
+      );
+    }
+  }
+
+  // surfaces
+  integer const nx{ 40 }, ny{ 30 };
+  vector<real_type> x2( nx ), y2( ny ), z2( nx*ny );
+  for ( integer i{0}; i < nx; ++i ) x2[i] = 0.1*i + 0.02*std::sin(1.3*i);
+  for ( integer j{0}; j < ny; ++j ) y2[j] = 0.15*j;
+  for ( integer i{0}; i < nx; ++i )
+    for ( integer j{0}; j < ny; ++j )
+      z2[i+j*nx] = std::sin(x2[i]) * std::cos(0.7*y2[j]);
+  BiCubicSpline bc;
+  bc.build( x2, y2, z2 );
+  // the surface is only C1 across its nodes, the cells converge as h^2
+  real_type const tol2{ 1e-5 };
+  for ( SplineLUTType t : { SplineLUTType::HERMITE, SplineLUTType::LINEAR } ) {
+    Splines::SplineLUTCompiler comp( tol2, t, 2 );
+    Splines::SplineLUT2D T;
+    comp.compile( bc, T );
+    real_type err{0};
+    integer const mx{ 1201 }, my{ 997 }; // not aligned with the cells
+    for ( integer a{0}; a <= mx; ++a )
+      for ( integer b{0}; b <= my; ++b ) {
+        real_type const x{ T.x_min() + (T.x_max()-T.x_min())*a/mx };
+        real_type const y{ T.y_min() + (T.y_max()-T.y_min())*b/my };
+        err = std::max( err, std::abs( T.eval(x,y) - bc.eval(x,y) ) );
+      }
+    for ( real_type x : x2 ) // the knots of the input
+      for ( real_type y : y2 )
+        err = std::max( err, std::abs( T.eval(x,y) - bc.eval(x,y) ) );
+    fmt::print(
+      "{:<8} {:<16} cells {:>3}x{:<3}, max_error {:.3e}, sampled error {:.3e}\n",
+      to_string(t), "BiCubic", T.num_cells_x(), T.num_cells_y(), T.max_error(), err
+    );
+    UTILS_ASSERT( T.tolerance_met(), "{} BiCubic: tolerance not met\n", to_string(t) );
+    UTILS_ASSERT(
+      err <= T.max_error() && T.max_error() <= tol2,
+      "{} BiCubic: sampled error {}, max_error {}, tolerance {}\n",
+      to_string(t), err, T.max_error(), tol2
+    );
+  }
+
+  cout << "\nALL DONE!\n\n";
+}
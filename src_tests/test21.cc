@@ -0,0 +1,135 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+#include <memory>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+
+int
+main() {
+
+  cout << "\n\nTEST N.21 (inverse)\n\n";
+
+  // strictly increasing data with flat and steep parts
+  integer const npts{ 80 };
+  vector<real_type> xx( npts ), yy( npts ), yp( npts );
+  for ( integer i{0}; i < npts; ++i ) {
+    xx[i] = 0.25*i + 0.05*std::sin(1.7*i);
+    yy[i] = xx[i] + 0.9*std::sin(xx[i]) + 0.01*xx[i]*xx[i]*xx[i];
+    yp[i] = 1 + 0.9*std::cos(xx[i]) + 0.03*xx[i]*xx[i];
+  }
+
+  LinearSpline          li;
+  CubicSpline           cs;
+  AkimaSpline           ak;
+  BesselSpline          be;
+  PchipSpline           pc;
+  Splines::HermiteSpline he;
+  QuinticSpline         qs;
+  Splines::Spline * S[]{ &li, &cs, &ak, &be, &pc, &he, &qs };
+
+  integer const n{ 5000 };
+  vector<real_type> ys( n ), xs( n ), xs1( n );
+
+  for ( real_type sgn : { 1.0, -1.0 } ) {
+    vector<real_type> y( yy ), d( yp );
+    for ( integer i{0}; i < npts; ++i ) { y[i] *= sgn; d[i] *= sgn; }
+    real_type const y0{ std::min( y.front(), y.back() ) };
+    real_type const y1{ std::max( y.front(), y.back() ) };
+
+    for ( Splines::Spline * P : S ) {
+      if ( P == &he ) he.build( xx.data(), y.data(), d.data(), npts );
+      else            P->build( xx.data(), y.data(), npts );
+
+      // single values: eval(inverse(y)) = y inside, nearest end outside
+      real_type err{0};
+      for ( integer k{0}; k < n; ++k ) {
+        ys[k] = y0 + (y1-y0)*std::abs( std::sin( 0.731*k ) );
+        real_type x;
+        bool const ok{ P->inverse( ys[k], x ) };
+        UTILS_ASSERT(
+          ok && x >= P->x_min() && x <= P->x_max(),
+          "{}: inverse({}) = {} failed\n", P->type_name(), ys[k], x
+        );
+        err = std::max( err, std::abs( P->eval(x) - ys[k] ) );
+        xs1[k] = x;
+      }
+      UTILS_ASSERT( err <= 1e-10, "{}: round trip error {}\n", P->type_name(), err );
+      for ( real_type yo : { y0 - 1, y1 + 1 } ) {
+        real_type x;
+        bool const ok{ P->inverse( yo, x ) };
+        real_type const xe{ (yo < y0) == (sgn > 0) ? P->x_min() : P->x_max() };
+        UTILS_ASSERT( !ok && x == xe, "{}: out of range inverse({}) = {}\n", P->type_name(), yo, x );
+      }
+
+      // batch, unsorted and sorted, with some values out of range
+      ys[7] = y1 + 2;
+      ys[9] = y0 - 2;
+      integer const nout{ P->inverse( ys.data(), xs.data(), n ) };
+      UTILS_ASSERT( nout == 2, "{}: {} values out of range instead of 2\n", P->type_name(), nout );
+      for ( integer k{0}; k < n; ++k ) {
+        real_type x;
+        P->inverse( ys[k], x );
+        UTILS_ASSERT( xs[k] == x, "{}: batched inverse({}) = {}, single {}\n", P->type_name(), ys[k], xs[k], x );
+      }
+      std::sort( ys.begin(), ys.end() );
+      P->inverse( ys.data(), xs.data(), n );
+      for ( integer k{1}; k < n-1; ++k )
+        UTILS_ASSERT(
+          std::abs( P->eval(xs[k]) - ys[k] ) <= 1e-10,
+          "{}: sorted batch, inverse({}) = {}\n", P->type_name(), ys[k], xs[k]
+        );
+      fmt::print( "{:<16} {} data, max |eval(inverse(y))-y| = {:.3e}\n",
+                  P->type_name(), sgn > 0 ? "increasing" : "decreasing", err );
+    }
+  }
+
+  // the table follows a rebuild with new data
+  cs.build( xx.data(), yy.data(), npts );
+  real_type x;
+  cs.inverse( 3.0, x );
+  vector<real_type> y2( yy );
+  for ( real_type & v : y2 ) v = 2*v + 1;
+  cs.build( xx.data(), y2.data(), npts );
+  real_type x2;
+  cs.inverse( 7.0, x2 );
+  UTILS_ASSERT( std::abs( cs.eval(x2) - 7.0 ) <= 1e-10, "inverse after rebuild, eval = {}\n", cs.eval(x2) );
+
+  cout << "\nALL DONE!\n\n";
+}
@@ -0,0 +1,136 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+
+// `eval(x,vals)` and derivatives of the set equal the evaluation of each spline
+static
+real_type
+check_set( SplineSet const & ss, char const where[] ) {
+  integer const nspl{ ss.num_splines() };
+  real_type const a{ ss.x_min() }, b{ ss.x_max() };
+  vector<real_type> vals( size_t(2*nspl) );
+  real_type err{0};
+  for ( integer j{0}; j <= 400; ++j ) {
+    real_type const x{ a - 1 + (b-a+2)*j/400 }; // also outside the nodes
+    for ( integer deriv{0}; deriv <= 3; ++deriv ) {
+      switch ( deriv ) {
+      case 0:  ss.eval    ( x, vals.data(), 2 ); break;
+      case 1:  ss.eval_D  ( x, vals.data(), 2 ); break;
+      case 2:  ss.eval_DD ( x, vals.data(), 2 ); break;
+      default: ss.eval_DDD( x, vals.data(), 2 ); break;
+      }
+      for ( integer k{0}; k < nspl; ++k ) {
+        Splines::Spline const * S{ ss.get_spline(k) };
+        real_type ref;
+        switch ( deriv ) {
+        case 0:  ref = S->eval(x); break;
+        case 1:  ref = S->D(x);    break;
+        case 2:  ref = S->DD(x);   break;
+        default: ref = S->DDD(x);  break;
+        }
+        real_type const e{ std::abs( vals[2*k] - ref ) / ( 1 + std::abs(ref) ) };
+        UTILS_ASSERT(
+          e <= 1e-12,
+          "{}: column {} ({}) derivative {} at x = {}: set {} spline {}\n",
+          where, k, S->type_name(), deriv, x, vals[2*k], ref
+        );
+        err = std::max( err, e );
+      }
+    }
+  }
+  return err;
+}
+
+int
+main() {
+
+  cout << "\n\nTEST N.22 (SplineSet grouped evaluation)\n\n";
+
+  // a wide set: 300 columns of all the types
+  SplineType1D const types[]{
+    SplineType1D::CONSTANT, SplineType1D::LINEAR, SplineType1D::CUBIC,
+    SplineType1D::AKIMA,    SplineType1D::BESSEL, SplineType1D::PCHIP,
+    SplineType1D::QUINTIC
+  };
+  integer const npts{ 50 };
+  integer const nspl{ 300 };
+  vector<real_type>         xx( npts );
+  vector<vector<real_type>> yy( nspl, vector<real_type>( npts ) );
+  vector<string>            names( nspl );
+  vector<char const *>      headers( nspl );
+  vector<SplineType1D>      stype( nspl );
+  vector<real_type const *> Y( nspl );
+  for ( integer i{0}; i < npts; ++i ) xx[i] = 0.2*i + 0.05*std::sin(1.3*i);
+  for ( integer k{0}; k < nspl; ++k ) {
+    for ( integer i{0}; i < npts; ++i ) yy[k][i] = std::sin( 0.3*xx[i] + 0.1*k ) + 0.01*k*xx[i];
+    names[k]   = fmt::format( "col{}", k );
+    headers[k] = names[k].c_str();
+    stype[k]   = types[k % std::size(types)];
+    Y[k]       = yy[k].data();
+  }
+
+  SplineSet owned( "owned" ), borrowed( "borrowed" );
+  owned.build( nspl, npts, headers.data(), stype.data(), xx.data(), Y.data() );
+  borrowed.build_external( nspl, npts, headers.data(), stype.data(), xx.data(), Y.data() );
+
+  for ( SplineSet * ss : { &owned, &borrowed } ) {
+    string const name{ ss->name() };
+    fmt::print( "{:<9} built:           max relative difference {:.3e}\n", name, check_set( *ss, "built" ) );
+
+    // flags changed through `get_spline` are seen by the grouped evaluation
+    for ( integer k{0}; k < nspl; k += 3 ) ss->get_spline(k)->make_extended_constant();
+    fmt::print( "{:<9} extended const.: max relative difference {:.3e}\n", name, check_set( *ss, "extended constant" ) );
+    for ( integer k{0}; k < nspl; k += 3 ) ss->get_spline(k)->make_extended_not_constant();
+    ss->get_spline(7)->make_closed();
+    fmt::print( "{:<9} closed column:   max relative difference {:.3e}\n", name, check_set( *ss, "closed" ) );
+    ss->get_spline(7)->make_opened();
+
+    // a cubic column rebuilt with other boundary conditions
+    CubicSpline * C{ dynamic_cast<CubicSpline*>( ss->get_spline(2) ) };
+    UTILS_ASSERT( C != nullptr, "column 2 is not a CubicSpline\n" );
+    C->set_initial_BC( Splines::CubicSpline_BC::NATURAL );
+    C->set_final_BC( Splines::CubicSpline_BC::NOT_A_KNOT );
+    C->build();
+    fmt::print( "{:<9} BC changed:      max relative difference {:.3e}\n", name, check_set( *ss, "BC changed" ) );
+  }
+
+  cout << "\nALL DONE!\n\n";
+}
@@ -0,0 +1,100 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+
+int
+main() {
+
+  cout << "\n\nTEST N.23 (SplineVec closest point)\n\n";
+
+  // a planar curve with few, strongly bent segments: several local
+  // minima of the distance on a segment
+  integer const npts{ 12 };
+  vector<real_type> px( npts ), py( npts );
+  for ( integer i{0}; i < npts; ++i ) {
+    real_type const t{ 1.9*i };
+    px[i] = std::cos(t) * (1 + 0.3*std::sin(3.1*t));
+    py[i] = std::sin(t) * (1 + 0.3*std::cos(2.3*t)) + 0.05*t;
+  }
+  real_type const * Y[]{ px.data(), py.data() };
+  Splines::SplineVec S( "curve" );
+  S.setup( 2, npts, Y );
+  S.set_knots_centripetal();
+  S.catmull_rom();
+
+  // dense samples of the curve for the brute force search
+  integer const nsmp{ 4000 };
+  integer const ns{ (npts-1)*nsmp };
+  vector<real_type> cx( size_t(ns)+1 ), cy( size_t(ns)+1 );
+  for ( integer k{0}; k <= ns; ++k ) {
+    real_type const x{ S.x_min() + (S.x_max()-S.x_min())*k/ns };
+    real_type v[2];
+    S.eval( x, v, 1 );
+    cx[size_t(k)] = v[0];
+    cy[size_t(k)] = v[1];
+  }
+
+  // the closest point is never farther than the best sample, and the
+  // best sample is within the sampling error of it
+  integer const nq{ 5000 };
+  real_type worst{0};
+  for ( integer q{0}; q < nq; ++q ) {
+    real_type const p[2]{ -2.5 + 5.0*std::fmod( 0.6180339887*q, 1.0 ), -2 + 5.0*std::fmod( 0.7548776662*q, 1.0 ) };
+    real_type x, dist;
+    S.closest_point( p, x, dist );
+    real_type brute{ std::numeric_limits<real_type>::infinity() };
+    for ( integer k{0}; k <= ns; ++k )
+      brute = std::min( brute, std::hypot( cx[size_t(k)]-p[0], cy[size_t(k)]-p[1] ) );
+    real_type v[2];
+    S.eval( x, v, 1 );
+    UTILS_ASSERT(
+      std::abs( std::hypot( v[0]-p[0], v[1]-p[1] ) - dist ) <= 1e-12,
+      "query {}: dist {} but the point at x = {} is at {}\n", q, dist, x, std::hypot( v[0]-p[0], v[1]-p[1] )
+    );
+    UTILS_ASSERT(
+      dist <= brute + 1e-12 && brute - dist <= 1e-3,
+      "query ({},{}): closest_point dist {}, brute force {}\n", p[0], p[1], dist, brute
+    );
+    worst = std::max( worst, brute - dist );
+  }
+  fmt::print( "{} queries, max (brute force - closest_point) = {:.3e}\n", nq, worst );
+
+  cout << "\nALL DONE!\n\n";
+}
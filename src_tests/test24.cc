@@ -0,0 +1,104 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+
+// every allocation of the program is counted
+static std::atomic<long> num_new{0};
+
+void *
+operator new( size_t n ) {
+  ++num_new;
+  void * p{ std::malloc( n > 0 ? n : 1 ) };
+  if ( p == nullptr ) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete( void * p ) noexcept { std::free( p ); }
+void operator delete( void * p, size_t ) noexcept { std::free( p ); }
+
+int
+main() {
+
+  cout << "\n\nTEST N.24 (SplineArena without heap allocations)\n\n";
+
+  integer const npts{ 100 };
+  vector<real_type> xx( npts ), yy( npts );
+  for ( integer i{0}; i < npts; ++i ) {
+    xx[i] = i + 0.3*std::sin(1.7*i);
+    yy[i] = std::sin( 0.2*xx[i] );
+  }
+
+  // the arena on a caller buffer, no upstream: making, building and
+  // evaluating the splines must not touch the heap
+  static std::byte buffer[1<<20];
+  Splines::SplineArena arena( buffer, sizeof(buffer), std::pmr::null_memory_resource() );
+
+  real_type sum{0};
+  long const n0{ num_new.load() };
+  for ( integer k{0}; k < 50; ++k ) {
+    LinearSpline * L{ arena.make<LinearSpline>( npts ) };
+    L->build( xx.data(), yy.data(), npts );
+    CubicSpline * C{ arena.make<CubicSpline>( npts ) };
+    C->build( xx.data(), yy.data(), npts );
+    for ( integer i{0}; i < 10; ++i ) sum += L->eval( 7.3*i ) + C->eval( 7.3*i );
+  }
+  long const n_make{ num_new.load() - n0 };
+  fmt::print( "100 splines made and built in the arena, {} allocations (sum {:.6f})\n", n_make, sum );
+  UTILS_ASSERT( n_make == 0, "SplineArena: {} heap allocations\n", n_make );
+
+  // named splines keep the formatted name
+  LinearSpline * named{ arena.make<LinearSpline>( npts, "named" ) };
+  UTILS_ASSERT( named->name() == "named", "name {}\n", named->name() );
+
+  // the same splines outside the arena give the same values
+  LinearSpline L;
+  CubicSpline  C;
+  L.build( xx.data(), yy.data(), npts );
+  C.build( xx.data(), yy.data(), npts );
+  real_type ref{0};
+  for ( integer k{0}; k < 50; ++k )
+    for ( integer i{0}; i < 10; ++i ) ref += L.eval( 7.3*i ) + C.eval( 7.3*i );
+  UTILS_ASSERT( std::abs( sum - ref ) <= 1e-12*std::abs(ref), "arena sum {} vs {}\n", sum, ref );
+
+  cout << "\nALL DONE!\n\n";
+}
@@ -0,0 +1,100 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+
+// length of the polyline through `n+1` points of `S` on [a,b]
+static
+real_type
+polyline( Splines::SplineVec const & S, real_type a, real_type b, integer n ) {
+  real_type L{0}, p0[3], p1[3];
+  S.eval( a, p0, 1 );
+  for ( integer k{1}; k <= n; ++k ) {
+    S.eval( a + (b-a)*k/n, p1, 1 );
+    L += std::sqrt( (p1[0]-p0[0])*(p1[0]-p0[0]) + (p1[1]-p0[1])*(p1[1]-p0[1]) + (p1[2]-p0[2])*(p1[2]-p0[2]) );
+    std::copy_n( p1, 3, p0 );
+  }
+  return L;
+}
+
+int
+main() {
+
+  cout << "\n\nTEST N.25 (SplineVec arc length)\n\n";
+
+  // a space curve with sharp turns: the speed is far from a polynomial
+  integer const npts{ 9 };
+  vector<real_type> px( npts ), py( npts ), pz( npts );
+  for ( integer i{0}; i < npts; ++i ) {
+    px[i] = i + 0.8*( i % 2 == 0 ? 1 : -1 );
+    py[i] = ( i % 3 ) * 1.5;
+    pz[i] = 0.3*i*i;
+  }
+  real_type const * Y[]{ px.data(), py.data(), pz.data() };
+  Splines::SplineVec S( "curve" );
+  S.setup( 3, npts, Y );
+  S.set_knots_centripetal();
+  S.catmull_rom();
+
+  // the polyline converges as h^2: one Richardson step
+  real_type const a{ S.x_min() }, b{ S.x_max() };
+  real_type worst{0};
+  for ( integer q{1}; q <= 40; ++q ) {
+    real_type const x  { a + (b-a)*q/40 };
+    integer   const n  { 20000*q };
+    real_type const ref{ ( 4*polyline( S, a, x, 2*n ) - polyline( S, a, x, n ) )/3 };
+    real_type const len{ S.arc_length( x ) };
+    real_type const err{ std::abs( len - ref )/ref };
+    UTILS_ASSERT(
+      err <= 1e-9,
+      "arc_length({}) = {}, polyline {}, relative error {}\n", x, len, ref, err
+    );
+    // and back to the parameter
+    real_type const xb{ S.param_at_length( len ) };
+    UTILS_ASSERT(
+      std::abs( xb - x ) <= 1e-9*(b-a),
+      "param_at_length( arc_length({}) ) = {}\n", x, xb
+    );
+    worst = std::max( worst, err );
+  }
+  UTILS_ASSERT( std::abs( S.length() - S.arc_length( b ) ) <= 1e-12*S.length(), "length {}\n", S.length() );
+  fmt::print( "length {:.12f}, max relative error against the polyline {:.3e}\n", S.length(), worst );
+
+  cout << "\nALL DONE!\n\n";
+}
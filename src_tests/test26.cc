@@ -0,0 +1,151 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+using Splines::Spline1DVariant;
+
+static integer const npts{ 30 };
+static real_type     xx[npts], yy[npts], yp[npts];
+
+// the variant equals the spline `S` (value and derivatives), also outside the nodes
+static
+void
+check_equal( Spline1DVariant const & V, Splines::Spline const & S, char const where[] ) {
+  UTILS_ASSERT( V.is_built() && V.type() == S.type(), "{}: {} not built or wrong type\n", where, S.type_name() );
+  real_type const a{ S.x_min() }, b{ S.x_max() };
+  for ( integer j{0}; j <= 200; ++j ) {
+    real_type const x{ a - 1 + (b-a+2)*j/200 };
+    real_type const d[3]{ V.eval(x) - S.eval(x), V.D(x) - S.D(x), V.DD(x) - S.DD(x) };
+    for ( real_type e : d )
+      UTILS_ASSERT(
+        std::abs( e ) <= 1e-12, "{}: {} at x = {} differs by {}\n", where, S.type_name(), x, e
+      );
+  }
+}
+
+static
+void
+build_variant( Spline1DVariant & V, SplineType1D tp ) {
+  if ( tp == SplineType1D::HERMITE ) V.build_hermite( xx, yy, yp, npts );
+  else                               V.build( tp, xx, yy, npts );
+}
+
+int
+main() {
+
+  cout << "\n\nTEST N.26 (Spline1DVariant copy and move)\n\n";
+
+  for ( integer i{0}; i < npts; ++i ) {
+    xx[i] = i + 0.3*std::sin(1.7*i);
+    yy[i] = std::sin( 0.4*xx[i] ) + 0.1*xx[i];
+    yp[i] = 0.4*std::cos( 0.4*xx[i] ) + 0.1;
+  }
+
+  SplineType1D const types[]{
+    SplineType1D::CONSTANT, SplineType1D::LINEAR, SplineType1D::CUBIC,
+    SplineType1D::AKIMA,    SplineType1D::BESSEL, SplineType1D::PCHIP,
+    SplineType1D::QUINTIC,  SplineType1D::HERMITE
+  };
+
+  // the reference splines, built directly
+  ConstantSpline       c0;
+  LinearSpline         c1;
+  CubicSpline          c2;
+  AkimaSpline          c3;
+  BesselSpline         c4;
+  PchipSpline          c5;
+  QuinticSpline        c6;
+  Splines::HermiteSpline c7;
+  c0.build( xx, yy, npts );
+  c1.build( xx, yy, npts );
+  c2.build( xx, yy, npts );
+  c3.build( xx, yy, npts );
+  c4.build( xx, yy, npts );
+  c5.build( xx, yy, npts );
+  c6.build( xx, yy, npts );
+  static_cast<Splines::CubicSplineBase&>(c7).build( xx, yy, yp, npts );
+  Splines::Spline * ref[]{ &c0, &c1, &c2, &c3, &c4, &c5, &c6, &c7 };
+  for ( Splines::Spline * S : ref ) S->make_extended_constant();
+
+  // build, copy, move, copy and move assignment
+  vector<Spline1DVariant> all;
+  for ( integer k{0}; k < 8; ++k ) {
+    string const name{ fmt::format( "V{}", k ) };
+    Spline1DVariant V( name );
+    build_variant( V, types[k] );
+    V.spline().make_extended_constant();
+    check_equal( V, *ref[k], "built" );
+
+    Spline1DVariant C( V );
+    check_equal( C, *ref[k], "copy" );
+    UTILS_ASSERT( C.name() == name, "copy: name {}\n", C.name() );
+
+    Spline1DVariant M( std::move(C) );
+    check_equal( M, *ref[k], "move" );
+    UTILS_ASSERT( !C.is_built(), "moved from variant still built\n" );
+
+    Spline1DVariant A( "A" ), B( "B" );
+    A = V;
+    B = std::move(M);
+    check_equal( A, *ref[k], "copy assignment" );
+    check_equal( B, *ref[k], "move assignment" );
+
+    // the copy is independent of the original
+    V.build( SplineType1D::LINEAR, xx, xx, npts );
+    check_equal( A, *ref[k], "copy after the original changed" );
+
+    all.emplace_back( A );
+  }
+
+  // in containers: reallocations and sorting move the elements around
+  for ( integer r{0}; r < 5; ++r )
+    for ( integer k{0}; k < 8; ++k ) all.emplace_back( all[size_t(k)] );
+  std::stable_sort(
+    all.begin(), all.end(),
+    []( Spline1DVariant const & a, Spline1DVariant const & b ) { return a.type() < b.type(); }
+  );
+  for ( Spline1DVariant const & V : all ) {
+    integer k{0};
+    while ( types[k] != V.type() ) ++k;
+    check_equal( V, *ref[k], "in a vector" );
+  }
+  fmt::print( "{} variants in a vector equal their reference splines\n", all.size() );
+
+  cout << "\nALL DONE!\n\n";
+}
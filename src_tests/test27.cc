@@ -0,0 +1,185 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+using Splines::BatchEvaluator;
+
+// equal values, NaN equal to NaN
+static
+bool
+same( real_type a, real_type b ) {
+  return ( std::isnan(a) && std::isnan(b) ) || a == b;
+}
+
+int
+main() {
+
+  cout << "\n\nTEST N.27 (BatchEvaluator and WorkStealingPool)\n\n";
+
+  integer const npts{ 200 };
+  vector<real_type> xx( npts ), y0( npts ), y1( npts ), y2( npts );
+  for ( integer i{0}; i < npts; ++i ) {
+    xx[i] = 0.1*i + 0.02*std::sin(1.3*i);
+    y0[i] = std::sin( xx[i] );
+    y1[i] = std::cos( 0.7*xx[i] );
+    y2[i] = 0.1*xx[i]*xx[i];
+  }
+  CubicSpline cs;
+  cs.build( xx, y0 );
+
+  char const *       headers[]{ "a", "b", "c" };
+  SplineType1D const stype[]{ SplineType1D::CUBIC, SplineType1D::AKIMA, SplineType1D::QUINTIC };
+  real_type const *  Y[]{ y0.data(), y1.data(), y2.data() };
+  SplineSet ss( "set" );
+  ss.build( 3, npts, headers, stype, xx.data(), Y );
+
+  SplineVec sv( "curve" );
+  sv.setup( 3, npts, Y );
+  sv.set_knots_chord_length();
+  sv.catmull_rom();
+
+  integer const nx{ 30 }, ny{ 20 };
+  vector<real_type> gx( nx ), gy( ny ), gz( nx*ny );
+  for ( integer i{0}; i < nx; ++i ) gx[i] = 0.2*i;
+  for ( integer j{0}; j < ny; ++j ) gy[j] = 0.3*j;
+  for ( integer i{0}; i < nx; ++i )
+    for ( integer j{0}; j < ny; ++j )
+      gz[i+j*nx] = std::sin(gx[i]) * std::cos(gy[j]);
+  BiCubicSpline bc;
+  bc.build( gx, gy, gz );
+
+  // queries in random order, with NaNs among them
+  integer const n{ 100003 };
+  real_type const nan{ std::numeric_limits<real_type>::quiet_NaN() };
+  vector<real_type> qx( n ), qy( n );
+  for ( integer k{0}; k < n; ++k ) {
+    qx[k] = -1 + 22*std::fmod( 0.6180339887*k, 1.0 );
+    qy[k] = -1 + 7*std::fmod( 0.7548776662*k, 1.0 );
+    if ( k % 997 == 0 ) qx[k] = nan;
+    if ( k % 991 == 0 ) qy[k] = nan;
+  }
+
+  // serial reference
+  integer const ld{ 4 };
+  vector<real_type> r_spl( 4*size_t(n) ), r_set( size_t(ld)*n ), r_vec( size_t(ld)*n ), r_surf( n );
+  for ( integer k{0}; k < n; ++k ) {
+    r_spl[size_t(k)]       = cs.eval( qx[k] );
+    r_spl[size_t(k+n)]     = cs.D( qx[k] );
+    r_spl[size_t(k+2*n)]   = cs.DD( qx[k] );
+    r_spl[size_t(k+3*n)]   = cs.DDD( qx[k] );
+    ss.eval( qx[k], r_set.data() + size_t(k)*ld, 1 );
+    sv.eval( qx[k], r_vec.data() + size_t(k)*ld, 1 );
+    r_surf[size_t(k)]      = bc.eval( qx[k], qy[k] );
+  }
+
+  // internal pool, sorted or not, and a user executor
+  BatchEvaluator pool( 4 );
+  BatchEvaluator user( []( integer ntasks, std::function<void(integer)> const & task ) {
+    for ( integer i{ntasks-1}; i >= 0; --i ) task(i);
+  } );
+  pool.set_chunk_size( 1000 );
+  user.set_chunk_size( 777 );
+  for ( BatchEvaluator * E : { &pool, &user } ) {
+    for ( bool sort : { false, true } ) {
+      E->sort_queries( sort );
+      vector<real_type> v( 4*size_t(n) ), vs( size_t(ld)*n ), vv( size_t(ld)*n ), vz( n );
+      for ( integer d{0}; d < 4; ++d ) E->eval( cs, qx.data(), n, v.data() + size_t(d)*n, d );
+      E->eval( ss, qx.data(), n, vs.data(), ld );
+      E->eval( sv, qx.data(), n, vv.data(), ld );
+      E->eval( bc, qx.data(), qy.data(), n, vz.data() );
+      for ( size_t k{0}; k < v.size(); ++k )
+        UTILS_ASSERT( same( v[k], r_spl[k] ), "Spline: entry {} {} vs {}\n", k, v[k], r_spl[k] );
+      for ( integer k{0}; k < n; ++k ) {
+        for ( integer j{0}; j < 3; ++j ) {
+          size_t const kj{ size_t(k)*ld + size_t(j) };
+          UTILS_ASSERT( same( vs[kj], r_set[kj] ), "SplineSet: point {} spline {}\n", k, j );
+          UTILS_ASSERT( same( vv[kj], r_vec[kj] ), "SplineVec: point {} component {}\n", k, j );
+        }
+        UTILS_ASSERT( same( vz[size_t(k)], r_surf[size_t(k)] ), "SplineSurf: point {}\n", k );
+      }
+      fmt::print(
+        "{:<8} sorted = {:<5} {} points: equal to the serial evaluation\n",
+        E == &pool ? "pool" : "executor", sort, n
+      );
+    }
+  }
+
+  // an exception of a task reaches the caller, the pool is usable after it
+  Splines::WorkStealingPool wsp( 4 );
+  std::atomic<integer> done{0};
+  bool caught{false};
+  try {
+    wsp.run( 1000, [&done]( integer i ) {
+      if ( i == 617 ) throw std::runtime_error( "task 617" );
+      ++done;
+    } );
+  } catch ( std::runtime_error const & e ) {
+    caught = string( e.what() ) == "task 617";
+  }
+  UTILS_ASSERT( caught, "WorkStealingPool: exception of a task not rethrown\n" );
+  done = 0;
+  wsp.run( 1000, [&done]( integer ) { ++done; } );
+  UTILS_ASSERT( done == 1000, "WorkStealingPool: {} tasks run after an exception\n", done.load() );
+
+  caught = false;
+  try {
+    vector<real_type> v( n );
+    pool.eval( cs, qx.data(), n, v.data(), 7 ); // invalid derivative
+  } catch ( std::exception const & ) {
+    caught = true;
+  }
+  UTILS_ASSERT( caught, "BatchEvaluator: invalid derivative accepted\n" );
+
+  caught = false;
+  BatchEvaluator failing( []( integer, std::function<void(integer)> const & ) {
+    throw std::runtime_error( "executor" );
+  } );
+  try {
+    vector<real_type> v( n );
+    failing.eval( cs, qx.data(), n, v.data() );
+  } catch ( std::runtime_error const & ) {
+    caught = true;
+  }
+  UTILS_ASSERT( caught, "BatchEvaluator: exception of the executor not rethrown\n" );
+  fmt::print( "exceptions of the tasks and of the executor reach the caller\n" );
+
+  cout << "\nALL DONE!\n\n";
+}
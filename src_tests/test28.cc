@@ -0,0 +1,133 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+
+int
+main() {
+
+  cout << "\n\nTEST N.28 (SplineVec interleaved layout and batched evaluation)\n\n";
+
+  integer const dim{ 3 };
+  integer const npts{ 40 };
+  vector<real_type> p0( npts ), p1( npts ), p2( npts );
+  for ( integer i{0}; i < npts; ++i ) {
+    real_type const t{ 0.3*i };
+    p0[i] = std::cos(t) + 0.1*t;
+    p1[i] = std::sin(1.3*t);
+    p2[i] = 0.05*t*t;
+  }
+  real_type const * Y[]{ p0.data(), p1.data(), p2.data() };
+
+  // same curve with the separated and the interleaved layout
+  Splines::SplineVec S( "separated" ), I( "interleaved" );
+  for ( Splines::SplineVec * C : { &S, &I } ) {
+    C->setup( dim, npts, Y );
+    C->set_knots_chord_length();
+    C->catmull_rom();
+  }
+  UTILS_ASSERT( !I.is_interleaved(), "interleaved copy not requested\n" );
+  I.use_interleaved();
+  UTILS_ASSERT( I.is_interleaved(), "interleaved copy not packed\n" );
+
+  integer const n{ 1000 };
+  vector<real_type> x( n );
+  for ( integer k{0}; k < n; ++k )
+    x[k] = S.x_min() + (S.x_max()-S.x_min())*std::fmod( 0.6180339887*k, 1.0 );
+
+  // all the components at once, batched with a padded leading dimension
+  // and point by point, on both layouts: the same values
+  auto check = [&]( char const * what ) {
+    integer const ld{ dim+2 };
+    for ( integer d{0}; d < 3; ++d ) {
+      vector<real_type> bs( size_t(ld)*n ), bi( size_t(ld)*n );
+      switch ( d ) {
+        case 0: S.eval( x.data(), n, bs.data(), ld );    I.eval( x.data(), n, bi.data(), ld );    break;
+        case 1: S.eval_D( x.data(), n, bs.data(), ld );  I.eval_D( x.data(), n, bi.data(), ld );  break;
+        case 2: S.eval_DD( x.data(), n, bs.data(), ld ); I.eval_DD( x.data(), n, bi.data(), ld ); break;
+      }
+      for ( integer k{0}; k < n; ++k ) {
+        real_type vs[dim], vi[dim];
+        switch ( d ) {
+          case 0: S.eval( x[k], vs, 1 );    I.eval( x[k], vi, 1 );    break;
+          case 1: S.eval_D( x[k], vs, 1 );  I.eval_D( x[k], vi, 1 );  break;
+          case 2: S.eval_DD( x[k], vs, 1 ); I.eval_DD( x[k], vi, 1 ); break;
+        }
+        for ( integer j{0}; j < dim; ++j ) {
+          real_type const ref{ vs[j] };
+          real_type const tol{ 1e-13*(1+std::abs(ref)) };
+          UTILS_ASSERT(
+            std::abs( vi[j]-ref ) <= tol &&
+            std::abs( bs[size_t(k)*ld+j]-ref ) <= tol &&
+            std::abs( bi[size_t(k)*ld+j]-ref ) <= tol,
+            "{}: derivative {} at x = {}, component {}: {} {} {} {}\n",
+            what, d, x[k], j, ref, vi[j], bs[size_t(k)*ld+j], bi[size_t(k)*ld+j]
+          );
+        }
+      }
+    }
+    fmt::print( "{:<28} {} points: layouts and batched evaluation agree\n", what, n );
+  };
+  check( "catmull_rom" );
+
+  // new knots drop the interleaved copy, new slopes pack it again
+  S.set_knots_centripetal();
+  I.set_knots_centripetal();
+  UTILS_ASSERT( !I.is_interleaved(), "interleaved copy kept after set_knots\n" );
+  S.catmull_rom();
+  I.catmull_rom();
+  UTILS_ASSERT( I.is_interleaved(), "interleaved copy not packed by catmull_rom\n" );
+  check( "set_knots + catmull_rom" );
+
+  // a deep copy of the separated curve, packed on the target
+  Splines::SplineVec C( "copy" );
+  C.use_interleaved();
+  S.deep_copy_to( C );
+  UTILS_ASSERT( C.is_interleaved(), "interleaved copy not packed by deep_copy_to\n" );
+  for ( integer k{0}; k < n; ++k ) {
+    real_type vs[dim], vc[dim];
+    S.eval( x[k], vs, 1 );
+    C.eval( x[k], vc, 1 );
+    for ( integer j{0}; j < dim; ++j )
+      UTILS_ASSERT( std::abs( vs[j]-vc[j] ) <= 1e-13*(1+std::abs(vs[j])), "deep_copy_to: x = {}, component {}: {} vs {}\n", x[k], j, vs[j], vc[j] );
+  }
+  fmt::print( "deep_copy_to: the interleaved copy matches the source\n" );
+
+  cout << "\nALL DONE!\n\n";
+}
@@ -0,0 +1,124 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+using Splines::SplineType1D;
+
+int
+main() {
+
+  cout << "\n\nTEST N.29 (SplineSet build_external)\n\n";
+
+  integer const nspl{ 8 };
+  integer const npts{ 60 };
+  char const * headers[]{ "const", "lin", "cubic", "akima", "bessel", "pchip", "hermite", "quintic" };
+  SplineType1D const stype[]{
+    SplineType1D::CONSTANT, SplineType1D::LINEAR,   SplineType1D::CUBIC,   SplineType1D::AKIMA,
+    SplineType1D::BESSEL,   SplineType1D::PCHIP,    SplineType1D::HERMITE, SplineType1D::QUINTIC
+  };
+
+  // caller owned columns, and a copy to check they are never written
+  vector<real_type> X( npts );
+  vector<vector<real_type>> Yv( nspl, vector<real_type>( npts ) ), Ypv( nspl, vector<real_type>( npts ) );
+  for ( integer i{0}; i < npts; ++i ) {
+    X[i] = 0.25*i + 0.05*std::sin(2.1*i);
+    for ( integer s{0}; s < nspl; ++s ) {
+      Yv[s][i]  = std::sin( (1+0.2*s)*X[i] ) + 0.01*s*X[i]*X[i];
+      Ypv[s][i] = (1+0.2*s)*std::cos( (1+0.2*s)*X[i] ) + 0.02*s*X[i];
+    }
+  }
+  vector<real_type> const X0{ X };
+  vector<vector<real_type>> const Y0{ Yv }, Yp0{ Ypv };
+  real_type const * Y[nspl];
+  real_type const * Yp[nspl];
+  for ( integer s{0}; s < nspl; ++s ) { Y[s] = Yv[s].data(); Yp[s] = Ypv[s].data(); }
+
+  SplineSet copied( "copied" ), borrowed( "borrowed" );
+  copied.build( nspl, npts, headers, stype, X.data(), Y, Yp );
+  borrowed.build_external( nspl, npts, headers, stype, X.data(), Y, Yp );
+
+  // the borrowed set reads the caller arrays in place
+  UTILS_ASSERT( borrowed.x_nodes() == X.data(), "build_external: X copied\n" );
+  UTILS_ASSERT( copied.x_nodes() != X.data(), "build: X not copied\n" );
+  for ( integer s{0}; s < nspl; ++s )
+    UTILS_ASSERT( borrowed.y_nodes(s) == Y[s], "build_external: Y of `{}` copied\n", headers[s] );
+
+  // same splines
+  integer const n{ 2000 };
+  for ( integer k{0}; k <= n; ++k ) {
+    real_type const x{ X.front() + (X.back()-X.front())*k/n };
+    for ( integer s{0}; s < nspl; ++s ) {
+      Spline const * C{ copied.get_spline(s) };
+      Spline const * B{ borrowed.get_spline(s) };
+      UTILS_ASSERT(
+        C->eval(x) == B->eval(x) && C->D(x) == B->D(x) && C->DD(x) == B->DD(x),
+        "`{}` at x = {}: {} {} {} vs {} {} {}\n", headers[s], x,
+        C->eval(x), C->D(x), C->DD(x), B->eval(x), B->D(x), B->DD(x)
+      );
+    }
+  }
+  for ( integer s{0}; s < nspl; ++s ) {
+    UTILS_ASSERT(
+      copied.y_min(s) == borrowed.y_min(s) && copied.y_max(s) == borrowed.y_max(s),
+      "`{}`: range [{},{}] vs [{},{}]\n", headers[s],
+      copied.y_min(s), copied.y_max(s), borrowed.y_min(s), borrowed.y_max(s)
+    );
+  }
+  fmt::print( "{} splines, {} points: build and build_external agree\n", nspl, n+1 );
+
+  // the caller arrays are untouched
+  UTILS_ASSERT( X == X0, "build_external wrote X\n" );
+  UTILS_ASSERT( Yv == Y0 && Ypv == Yp0, "build_external wrote Y or Yp\n" );
+
+  // a new (copying) build of the same set releases the caller arrays
+  borrowed.build( nspl, npts, headers, stype, X.data(), Y, Yp );
+  UTILS_ASSERT( borrowed.x_nodes() != X.data(), "build after build_external: X still borrowed\n" );
+  std::fill( X.begin(), X.end(), 0 );
+  for ( integer k{0}; k <= n; ++k ) {
+    real_type const x{ X0.front() + (X0.back()-X0.front())*k/n };
+    for ( integer s{0}; s < nspl; ++s )
+      UTILS_ASSERT(
+        copied.get_spline(s)->eval(x) == borrowed.get_spline(s)->eval(x),
+        "`{}` at x = {} after rebuild\n", headers[s], x
+      );
+  }
+  fmt::print( "build after build_external owns its data\n" );
+
+  cout << "\nALL DONE!\n\n";
+}
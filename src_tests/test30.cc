@@ -0,0 +1,173 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+
+int
+main() {
+
+  cout << "\n\nTEST N.30 (SplineSet CSV and raw loaders)\n\n";
+
+  string const dir{ std::filesystem::temp_directory_path().string() };
+  string const fcsv{ dir + "/Splines_test30.csv" };
+  string const fraw{ dir + "/Splines_test30.raw" };
+
+  // more rows than a parsing block: lines cross the block boundaries
+  integer const npts{ 150000 };
+  integer const nspl{ 3 };
+  vector<real_type> xx( npts );
+  vector<vector<real_type>> yy( nspl, vector<real_type>( npts ) );
+  for ( integer i{0}; i < npts; ++i ) {
+    xx[i] = 0.01*i + 0.002*std::sin(1.7*i);
+    yy[0][i] = std::sin( xx[i] );
+    yy[1][i] = std::cos( 0.3*xx[i] ) * 1e5;
+    yy[2][i] = 1e-7*xx[i]*xx[i] - 3;
+  }
+  char const * headers[]{ "a", "b", "c" };
+  SplineType1D const stype[]{ SplineType1D::LINEAR, SplineType1D::CUBIC, SplineType1D::PCHIP };
+  real_type const * Y[]{ yy[0].data(), yy[1].data(), yy[2].data() };
+  SplineSet ref( "reference" );
+  ref.build( nspl, npts, headers, stype, xx.data(), Y );
+  vector<SplineType1D> const vtype( std::begin(stype), std::end(stype) );
+
+  // the loaded set is the reference: same headers, same knots
+  auto check = [&]( SplineSet const & S, string_view what ) {
+    UTILS_ASSERT(
+      S.num_splines() == nspl && S.num_points() == npts,
+      "{}: {} splines of {} points\n", what, S.num_splines(), S.num_points()
+    );
+    for ( integer k{0}; k < nspl; ++k ) {
+      UTILS_ASSERT(
+        S.header(k) == headers[k] && S.get_spline(k)->type() == stype[k],
+        "{}: spline {} is `{}`\n", what, k, S.header(k)
+      );
+      UTILS_ASSERT(
+        std::equal( xx.begin(), xx.end(), S.x_nodes() ) &&
+        std::equal( yy[k].begin(), yy[k].end(), S.y_nodes(k) ),
+        "{}: values of spline `{}` differ\n", what, headers[k]
+      );
+    }
+    for ( integer j{0}; j <= 1000; ++j ) {
+      real_type const x{ xx.front() + (xx.back()-xx.front())*j/1000 };
+      for ( integer k{0}; k < nspl; ++k )
+        UTILS_ASSERT(
+          S.eval( x, k ) == ref.eval( x, k ) && S.eval_D( x, k ) == ref.eval_D( x, k ),
+          "{}: spline `{}` differs at x = {}\n", what, headers[k], x
+        );
+    }
+    fmt::print( "{} OK\n", what );
+  };
+
+  // write the table with the given end of line and separator, with or
+  // without the newline after the last row
+  auto write_csv = [&]( string_view eol, char sep, bool final_eol ) {
+    std::ofstream out( fcsv, std::ios::binary );
+    out << "x" << sep << " a" << sep << "b " << sep << "\"c\"" << eol;
+    for ( integer i{0}; i < npts; ++i ) {
+      out << fmt::format( "{:.17g}", xx[i] );
+      for ( integer k{0}; k < nspl; ++k ) out << sep << fmt::format( "{:.17g}", yy[k][i] );
+      if ( final_eol || i+1 < npts ) out << eol;
+    }
+  };
+
+  for ( string_view eol : { "\n", "\r\n" } ) {
+    for ( bool final_eol : { true, false } ) {
+      for ( char sep : { ',', ';' } ) {
+        write_csv( eol, sep, final_eol );
+        for ( integer nth : { 1, 4 } ) {
+          SplineSet S( "csv" );
+          S.load_csv( fcsv, vtype, sep, nth );
+          check( S, fmt::format(
+            "load_csv( {}, final newline = {}, sep = '{}', threads = {} )",
+            eol.size() == 1 ? "LF  " : "CRLF", final_eol, sep, nth
+          ) );
+        }
+      }
+    }
+  }
+
+  // same type for all the columns
+  write_csv( "\r\n", ',', false );
+  {
+    SplineSet S( "csv" );
+    S.load_csv( fcsv, SplineType1D::AKIMA );
+    UTILS_ASSERT(
+      S.num_splines() == nspl && S.num_points() == npts && S.get_spline(2)->type() == SplineType1D::AKIMA,
+      "load_csv( AKIMA ): wrong set\n"
+    );
+  }
+
+  // a row with a missing field is rejected
+  {
+    std::ofstream out( fcsv, std::ios::binary );
+    out << "x,a,b,c\r\n0,1,2,3\r\n1,2,3\r\n2,3,4,5";
+  }
+  bool rejected{false};
+  try {
+    SplineSet S( "csv" );
+    S.load_csv( fcsv, vtype );
+  } catch ( std::exception const & ) {
+    rejected = true;
+  }
+  UTILS_ASSERT( rejected, "load_csv: row with a missing field accepted\n" );
+  fmt::print( "row with a missing field rejected\n" );
+
+  // raw little endian columns, rows given or deduced from the size
+  {
+    std::ofstream out( fraw, std::ios::binary );
+    out.write( reinterpret_cast<char const*>(xx.data()), std::streamsize( npts*sizeof(real_type) ) );
+    for ( integer k{0}; k < nspl; ++k )
+      out.write( reinterpret_cast<char const*>(yy[k].data()), std::streamsize( npts*sizeof(real_type) ) );
+  }
+  vector<string> const vhdr( std::begin(headers), std::end(headers) );
+  for ( integer n : { npts, 0 } ) {
+    SplineSet S( "raw" );
+    S.load_raw( fraw, vhdr, vtype, n );
+    check( S, fmt::format( "load_raw( npts = {} )", n ) );
+  }
+
+  std::remove( fcsv.c_str() );
+  std::remove( fraw.c_str() );
+
+  cout << "\nALL DONE!\n\n";
+}
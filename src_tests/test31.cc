@@ -0,0 +1,148 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+using Splines::TiledBiCubicSpline;
+
+int
+main() {
+
+  cout << "\n\nTEST N.31 (TiledBiCubicSpline)\n\n";
+
+  string const dir{ std::filesystem::temp_directory_path().string() };
+  string const fgrid{ dir + "/Splines_test31_grid.bin" };
+
+  // non uniform grid, tile sizes that do not divide the number of cells
+  integer const nx{ 61 }, ny{ 47 };
+  vector<real_type> gx( nx ), gy( ny ), gz( size_t(nx)*ny );
+  for ( integer i{0}; i < nx; ++i ) gx[i] = 0.1*i + 0.03*std::sin(1.9*i);
+  for ( integer j{0}; j < ny; ++j ) gy[j] = 0.15*j + 0.04*std::cos(2.3*j);
+  for ( integer i{0}; i < nx; ++i )
+    for ( integer j{0}; j < ny; ++j )
+      gz[i+j*nx] = std::sin( 2*gx[i] ) * std::cos( 1.5*gy[j] ) + 0.1*gx[i]*gy[j];
+  BiCubicSpline mono( "monolithic" );
+  mono.build( gx, gy, gz );
+  mono.save_grid( fgrid );
+
+  TiledBiCubicSpline T( "tiled" );
+  T.set_tile_size( 7, 5 );
+  T.open_grid( fgrid );
+  T.set_cache_bytes( 0 ); // a single tile: every change of tile reloads
+  UTILS_ASSERT(
+    T.num_tiles_x() == 9 && T.num_tiles_y() == 10,
+    "{} x {} tiles, expected 9 x 10\n", T.num_tiles_x(), T.num_tiles_y()
+  );
+
+  // the tiled surface is the monolithic one
+  auto check = [&mono]( TiledBiCubicSpline const & S, real_type x, real_type y ) {
+    real_type dm[3], dt[3], ddm[6], ddt[6];
+    mono.D( x, y, dm );
+    S.D( x, y, dt );
+    mono.DD( x, y, ddm );
+    S.DD( x, y, ddt );
+    for ( integer k{0}; k < 3; ++k )
+      UTILS_ASSERT(
+        std::abs( dm[k]-dt[k] ) <= 1e-12*(1+std::abs(dm[k])),
+        "({},{}): D[{}] tiled {} monolithic {}\n", x, y, k, dt[k], dm[k]
+      );
+    for ( integer k{0}; k < 6; ++k )
+      UTILS_ASSERT(
+        std::abs( ddm[k]-ddt[k] ) <= 1e-10*(1+std::abs(ddm[k])),
+        "({},{}): DD[{}] tiled {} monolithic {}\n", x, y, k, ddt[k], ddm[k]
+      );
+  };
+
+  // on the seams, at their nodes and just beside them
+  integer nseam{0};
+  for ( integer i{0}; i < nx; i += 7 ) {
+    for ( integer j{0}; j < ny; ++j ) {
+      for ( real_type dx : { -1e-9, 0.0, 1e-9 } ) {
+        real_type const x{ std::clamp( gx[i]+dx, gx.front(), gx.back() ) };
+        check( T, x, gy[j] );
+        check( T, x, 0.5*(gy[j]+gy[std::min(j+1,ny-1)]) );
+        nseam += 2;
+      }
+    }
+  }
+  for ( integer j{0}; j < ny; j += 5 ) {
+    for ( integer i{0}; i < nx; ++i ) {
+      for ( real_type dy : { -1e-9, 0.0, 1e-9 } ) {
+        real_type const y{ std::clamp( gy[j]+dy, gy.front(), gy.back() ) };
+        check( T, gx[i], y );
+        check( T, 0.5*(gx[i]+gx[std::min(i+1,nx-1)]), y );
+        nseam += 2;
+      }
+    }
+  }
+  fmt::print( "{} points on the seams: tiled == monolithic\n", nseam );
+
+  // scattered points with a small cache: tiles are evicted and reloaded
+  integer const n{ 20000 };
+  auto px = [&]( integer k ) { return gx.front() + (gx.back()-gx.front())*std::fmod( 0.6180339887*k, 1.0 ); };
+  auto py = [&]( integer k ) { return gy.front() + (gy.back()-gy.front())*std::fmod( 0.7548776662*k, 1.0 ); };
+  for ( integer k{0}; k < n; ++k ) check( T, px(k), py(k) );
+  UTILS_ASSERT(
+    T.cached_tiles() == 1 && T.tile_loads() > size_t(T.num_tiles_x()*T.num_tiles_y()),
+    "cache of one tile: {} tiles cached, {} loads\n", T.cached_tiles(), T.tile_loads()
+  );
+  fmt::print( "{} scattered points, {} tile loads with one cached tile\n", n, T.tile_loads() );
+
+  // concurrent readers sharing a cache smaller than the surface
+  T.clear_cache();
+  T.set_cache_bytes( size_t(1) << 16 );
+  vector<std::thread> readers;
+  for ( integer t{0}; t < 4; ++t )
+    readers.emplace_back( [&,t]() { for ( integer k{t}; k < n; k += 4 ) check( T, px(k), py(k) ); } );
+  for ( std::thread & th : readers ) th.join();
+  UTILS_ASSERT(
+    T.cached_tiles() < T.num_tiles_x()*T.num_tiles_y(),
+    "{} tiles cached over the limit\n", T.cached_tiles()
+  );
+  fmt::print( "4 concurrent readers: tiled == monolithic, {} tiles cached\n", T.cached_tiles() );
+
+  std::remove( fgrid.c_str() );
+
+  cout << "\nALL DONE!\n\n";
+}
@@ -0,0 +1,166 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+
+using Splines::SplineType1D;
+using Splines::SplineBoundary;
+using Splines::StaticSpline;
+
+static integer const npts{ 25 };
+static vector<real_type> xx, yy;
+
+static
+bool
+near( real_type a, real_type b, real_type tol = 1e-11 ) {
+  return std::abs(a-b) <= tol*(1+std::abs(b));
+}
+
+// compare a `StaticSpline` with the runtime spline `R` on [a,b]
+template <typename SS>
+static
+void
+compare(
+  SS const & S, Splines::Spline const & R, real_type a, real_type b, string_view what, real_type tol = 1e-11
+) {
+  integer const n{ 3001 };
+  for ( integer k{0}; k < n; ++k ) {
+    real_type const x{ a + (b-a)*std::fmod( 0.6180339887*k, 1.0 ) };
+    UTILS_ASSERT(
+      near( S.eval(x), R.eval(x), tol ) && near( S.D(x), R.D(x), tol ) &&
+      ( SS::order < 4 || near( S.DD(x), R.DD(x), 100*tol ) ),
+      "{} at x = {}: static {} {} {} runtime {} {} {}\n", what, x,
+      S.eval(x), S.D(x), S.DD(x), R.eval(x), R.D(x), R.DD(x)
+    );
+  }
+  fmt::print( "{:<44} OK\n", what );
+}
+
+// `StaticSpline<KIND,...>` against the runtime spline of the same kind,
+// on every boundary policy
+template <SplineType1D KIND, typename RS>
+static
+void
+check_kind( string_view name ) {
+  real_type const a{ xx.front() }, b{ xx.back() }, L{ b-a };
+  RS R;
+  R.build( xx.data(), yy.data(), npts );
+
+  StaticSpline<KIND> E;
+  E.build( xx.data(), yy.data(), npts );
+  R.make_unbounded();
+  R.make_extended_not_constant();
+  compare( E, R, a, b, fmt::format( "{} build, inside", name ) );
+  if constexpr ( KIND != SplineType1D::CONSTANT )
+    compare( E, R, a-0.3*L, b+0.3*L, fmt::format( "{} EXTRAPOLATE", name ) );
+
+  // from the runtime spline and back
+  if constexpr ( StaticSpline<KIND>::order != 1 ) {
+    StaticSpline<KIND> F( R );
+    compare( F, R, a, b, fmt::format( "{} from runtime", name ) );
+    auto B{ E.to_spline( "back" ) };
+    compare( E, *B, a-0.3*L, b+0.3*L, fmt::format( "{} to_spline", name ) );
+  }
+
+  StaticSpline<KIND,SplineBoundary::CONSTANT> C;
+  C.build( xx.data(), yy.data(), npts );
+  R.make_extended_constant();
+  compare( C, R, a-0.3*L, b+0.3*L, fmt::format( "{} CONSTANT", name ) );
+
+  // clamped: value and derivatives of the end points
+  StaticSpline<KIND,SplineBoundary::CLAMP> K;
+  K.build( xx.data(), yy.data(), npts );
+  for ( real_type d : { 0.01, 0.5, 3.0 } ) {
+    UTILS_ASSERT(
+      K.eval(a-d) == K.eval(a) && K.eval(b+d) == K.eval(b) &&
+      K.D(a-d) == K.D(a) && K.D(b+d) == K.D(b),
+      "{} CLAMP at distance {}\n", name, d
+    );
+  }
+  fmt::print( "{:<44} OK\n", fmt::format( "{} CLAMP", name ) );
+
+  // periodic: same as the runtime closed spline
+  StaticSpline<KIND,SplineBoundary::PERIODIC> P;
+  P.build( xx.data(), yy.data(), npts );
+  R.make_extended_not_constant();
+  R.make_closed();
+  compare( P, R, a-2*L, b+2*L, fmt::format( "{} PERIODIC", name ) );
+}
+
+int
+main() {
+
+  cout << "\n\nTEST N.32 (StaticSpline)\n\n";
+
+  xx.resize( npts );
+  yy.resize( npts );
+  for ( integer i{0}; i < npts; ++i ) {
+    xx[i] = 0.4*i + 0.1*std::sin(2.3*i);
+    yy[i] = std::sin( xx[i] ) + 0.05*xx[i]*xx[i] + ( i == 12 ? 0.8 : 0 ); // a bump for the limiters
+  }
+
+  check_kind<SplineType1D::CONSTANT, ConstantSpline>( "CONSTANT" );
+  check_kind<SplineType1D::LINEAR,   LinearSpline  >( "LINEAR" );
+  check_kind<SplineType1D::CUBIC,    CubicSpline   >( "CUBIC" );
+  check_kind<SplineType1D::AKIMA,    AkimaSpline   >( "AKIMA" );
+  check_kind<SplineType1D::BESSEL,   BesselSpline  >( "BESSEL" );
+  check_kind<SplineType1D::PCHIP,    PchipSpline   >( "PCHIP" );
+
+  // quintic: from the runtime spline and back
+  QuinticSpline Q;
+  Q.build( xx.data(), yy.data(), npts );
+  StaticSpline<SplineType1D::QUINTIC> SQ( Q );
+  compare( SQ, Q, xx.front(), xx.back(), "QUINTIC from runtime" );
+  auto BQ{ SQ.to_spline( "back" ) };
+  compare( SQ, *BQ, xx.front()-1, xx.back()+1, "QUINTIC to_spline", 1e-9 ); // extrapolated quintics
+
+  // the spline type of the runtime spline must match
+  bool rejected{false};
+  try {
+    LinearSpline lin;
+    lin.build( xx.data(), yy.data(), npts );
+    StaticSpline<SplineType1D::CUBIC> bad( lin );
+  } catch ( std::exception const & ) {
+    rejected = true;
+  }
+  UTILS_ASSERT( rejected, "StaticSpline<CUBIC> built from a LinearSpline\n" );
+  fmt::print( "conversion from a spline of a different order rejected\n" );
+
+  cout << "\nALL DONE!\n\n";
+}
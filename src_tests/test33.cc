@@ -0,0 +1,149 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+
+using Splines::SplineType1D;
+using Splines::FixedSpline;
+
+using Table = std::array<real_type,8>;
+
+// a calibration table known at compile time
+static constexpr Table cal_x{ 0, 0.5, 1.2, 2, 2.5, 3.5, 4, 5.5 };
+static constexpr Table cal_y{ 1, 1.4, 1.1, 2.3, 2.2, 0.7, 0.9, 1.5 };
+
+static constexpr FixedSpline<8,SplineType1D::LINEAR> cal_lin{ cal_x, cal_y };
+static constexpr FixedSpline<8,SplineType1D::CUBIC>  cal_cub{ cal_x, cal_y };
+static constexpr FixedSpline<8,SplineType1D::AKIMA>  cal_aki{ cal_x, cal_y };
+static constexpr FixedSpline<8,SplineType1D::PCHIP>  cal_pch{ cal_x, cal_y };
+
+// built and evaluated by the compiler
+static_assert( cal_lin(1.2) == 1.1 && cal_lin(-1) == 1 && cal_lin(9) == 1.5 );
+static_assert( cal_cub(cal_x[3]) == cal_y[3] && cal_cub.DD(cal_x[0]) < 1e-12 && cal_cub.DD(cal_x[0]) > -1e-12 );
+static_assert( cal_aki(cal_x[5]) == cal_y[5] && cal_pch(cal_x[6]) == cal_y[6] );
+static_assert( std::is_trivially_copyable_v<decltype(cal_cub)> );
+static_assert( std::is_trivially_copyable_v<decltype(cal_aki)> );
+
+static
+bool
+near( real_type a, real_type b, real_type tol = 1e-12 ) {
+  return std::abs(a-b) <= tol*(1+std::abs(b));
+}
+
+// the fixed spline against the runtime one on [a,b]
+template <typename FS>
+static
+void
+compare( FS const & F, Splines::Spline const & R, real_type a, real_type b, string_view what ) {
+  integer const n{ 2001 };
+  for ( integer k{0}; k < n; ++k ) {
+    real_type const x{ a + (b-a)*std::fmod( 0.6180339887*k, 1.0 ) };
+    bool const cubic{ FS::type() != SplineType1D::LINEAR };
+    UTILS_ASSERT(
+      near( F.eval(x), R.eval(x) ) && near( F.D(x), R.D(x), 1e-10 ) &&
+      ( !cubic || near( F.DD(x), R.DD(x), 1e-9 ) ),
+      "{} at x = {}: fixed {} {} {} runtime {} {} {}\n", what, x,
+      F.eval(x), F.D(x), F.DD(x), R.eval(x), R.D(x), R.DD(x)
+    );
+  }
+  fmt::print( "{:<24} OK\n", what );
+}
+
+int
+main() {
+
+  cout << "\n\nTEST N.33 (FixedSpline)\n\n";
+
+  real_type const a{ cal_x.front() }, b{ cal_x.back() }, L{ b-a };
+
+  LinearSpline lin;
+  lin.build( cal_x.data(), cal_y.data(), 8 );
+  lin.make_unbounded();
+  lin.make_extended_constant();
+  compare( cal_lin, lin, a-0.3*L, b+0.3*L, "LINEAR" );
+
+  CubicSpline cub;
+  cub.set_initial_BC( Splines::CubicSpline_BC::NATURAL );
+  cub.set_final_BC( Splines::CubicSpline_BC::NATURAL );
+  cub.build( cal_x.data(), cal_y.data(), 8 );
+  cub.make_unbounded();
+  compare( cal_cub, cub, a-0.3*L, b+0.3*L, "CUBIC (natural)" );
+
+  AkimaSpline aki;
+  aki.build( cal_x.data(), cal_y.data(), 8 );
+  aki.make_unbounded();
+  compare( cal_aki, aki, a-0.3*L, b+0.3*L, "AKIMA" );
+
+  PchipSpline pch;
+  pch.build( cal_x.data(), cal_y.data(), 8 );
+  pch.make_unbounded();
+  compare( cal_pch, pch, a-0.3*L, b+0.3*L, "PCHIP" );
+
+  // built at run time, copied as plain bytes and converted to StaticSpline
+  FixedSpline<8,SplineType1D::AKIMA> rt{ cal_x, cal_y };
+  FixedSpline<8,SplineType1D::AKIMA> cp;
+  std::memcpy( static_cast<void*>(&cp), &rt, sizeof(rt) );
+  auto st{ cp.to_static() };
+  for ( integer k{0}; k <= 500; ++k ) {
+    real_type const x{ a - 1 + (L+2)*k/500 };
+    UTILS_ASSERT(
+      cp.eval(x) == cal_aki.eval(x) && near( st.eval(x), cp.eval(x) ) && near( st.D(x), cp.D(x) ),
+      "copy / to_static at x = {}: {} {} {}\n", x, cp.eval(x), cal_aki.eval(x), st.eval(x)
+    );
+  }
+  fmt::print( "{:<24} OK\n", "memcpy and to_static" );
+
+  // nodes not increasing are rejected
+  bool rejected{false};
+  try {
+    Table bad{ cal_x };
+    std::swap( bad[2], bad[3] );
+    FixedSpline<8,SplineType1D::PCHIP> F{ bad, cal_y };
+    (void) F;
+  } catch ( std::exception const & ) {
+    rejected = true;
+  }
+  UTILS_ASSERT( rejected, "FixedSpline: nodes not increasing accepted\n" );
+  fmt::print( "nodes not increasing rejected\n" );
+
+  cout << "\nALL DONE!\n\n";
+}
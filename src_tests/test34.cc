@@ -0,0 +1,195 @@
+/*--------------------------------------------------------------------------*\
+ |                                                                          |
+ |  Copyright (C) 2016                                                      |
+ |                                                                          |
+ |         , __                 , __                                        |
+ |        /|/  \               /|/  \                                       |
+ |         | __/ _   ,_         | __/ _   ,_                                |
+ |         |   \|/  /  |  |   | |   \|/  /  |  |   |                        |
+ |         |(__/|__/   |_/ \_/|/|(__/|__/   |_/ \_/|/                       |
+ |                           /|                   /|                        |
+ |                           \|                   \|                        |
+ |                                                                          |
+ |      Enrico Bertolazzi                                                   |
+ |      Dipartimento di Ingegneria Industriale                              |
+ |      Università degli Studi di Trento                                    |
+ |      email: enrico.bertolazzi@unitn.it                                   |
+ |                                                                          |
+\*--------------------------------------------------------------------------*/
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat-pedantic"
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#pragma clang diagnostic ignored "-Wdocumentation-unknown-command"
+#pragma clang diagnostic ignored "-Wglobal-constructors"
+#pragma clang diagnostic ignored "-Wpoison-system-directories"
+#pragma clang diagnostic ignored "-Wundefined-func-template"
+#endif
+#include "Splines.hh"
+#include "Utils_fmt.hh"
+
+#include <cmath>
+#include <sstream>
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wc++98-compat"
+#endif
+
+using namespace SplinesLoad;
+using namespace std;
+using Splines::real_type;
+using Splines::integer;
+using Splines::SplineType1D;
+
+using Splines::SplineSampler;
+using Splines::SplineSampleMode;
+
+// max distance of `f` from the polyline of the samples `xs` (values `f(xs)`)
+template <typename F>
+static
+real_type
+polyline_error( vector<real_type> const & xs, F const & f ) {
+  real_type err{0};
+  for ( size_t i{1}; i < xs.size(); ++i ) {
+    real_type const a{ xs[i-1] }, b{ xs[i] };
+    real_type const fa{ f(a) }, fb{ f(b) };
+    for ( integer k{1}; k < 64; ++k ) {
+      real_type const t{ k/64.0 };
+      err = std::max( err, std::abs( f( a+t*(b-a) ) - ( fa + t*(fb-fa) ) ) );
+    }
+  }
+  return err;
+}
+
+// every node is a sample, samples increasing
+static
+void
+check_nodes( vector<real_type> const & xs, real_type const X[], integer npts, string_view what ) {
+  UTILS_ASSERT( std::is_sorted( xs.begin(), xs.end() ), "{}: samples not sorted\n", what );
+  for ( integer i{0}; i < npts; ++i )
+    UTILS_ASSERT(
+      std::binary_search( xs.begin(), xs.end(), X[i] ), "{}: node {} not sampled\n", what, i
+    );
+}
+
+int
+main() {
+
+  cout << "\n\nTEST N.34 (SplineSampler)\n\n";
+
+  // many nodes (several blocks of intervals), flat and curved parts
+  integer const npts{ 3000 };
+  vector<real_type> xx( npts ), y0( npts ), y1( npts );
+  for ( integer i{0}; i < npts; ++i ) {
+    xx[i] = 0.01*i + 0.002*std::sin(1.3*i);
+    y0[i] = xx[i] < 10 ? 0.5*xx[i] : std::sin( 3*xx[i] );
+    y1[i] = std::cos( 0.5*xx[i] ) * 100;
+  }
+  real_type const tol{ 1e-4 };
+
+  // value tolerance on a spline, same result with any number of threads
+  CubicSpline cs;
+  cs.build( xx.data(), y0.data(), npts );
+  SplineSampler S1( tol, 1 ), S4( tol, 4 );
+  vector<real_type> xs1, xs4;
+  S1.sample( cs, xs1 );
+  S4.sample( cs, xs4 );
+  UTILS_ASSERT( xs1 == xs4, "sample: 1 thread {} samples, 4 threads {}\n", xs1.size(), xs4.size() );
+  UTILS_ASSERT( S4.num_samples() == integer(xs4.size()), "num_samples {}\n", S4.num_samples() );
+  check_nodes( xs4, xx.data(), npts, "Spline" );
+  real_type const err{ polyline_error( xs4, [&cs]( real_type x ) { return cs.eval(x); } ) };
+  UTILS_ASSERT( err <= tol, "Spline: polyline error {} > {}\n", err, tol );
+  fmt::print( "Spline:    {} samples ({} nodes), error {:.3e} <= {}\n", xs4.size(), npts, err, tol );
+
+  // linear pieces get no extra samples
+  LinearSpline ls;
+  ls.build( xx.data(), y0.data(), npts );
+  vector<real_type> xl;
+  S4.sample( ls, xl );
+  UTILS_ASSERT( xl == xx, "LinearSpline: {} samples for {} nodes\n", xl.size(), npts );
+
+  // the dump is the sampled spline, identical with any number of threads
+  std::ostringstream o1, o4;
+  S1.dump( cs, o1 );
+  S4.dump( cs, o4 );
+  UTILS_ASSERT( o1.str() == o4.str(), "dump: output depends on the number of threads\n" );
+  {
+    std::istringstream in( o4.str() );
+    string line;
+    std::getline( in, line );
+    UTILS_ASSERT( line == "x\ty", "dump: header `{}`\n", line );
+    size_t nrow{0};
+    real_type x, y;
+    while ( in >> x >> y ) {
+      UTILS_ASSERT( x == xs4[nrow], "dump: row {} x = {} expected {}\n", nrow, x, xs4[nrow] );
+      UTILS_ASSERT( std::abs( y-cs.eval(x) ) <= 1e-14*(1+std::abs(y)), "dump: row {} y = {} expected {}\n", nrow, y, cs.eval(x) );
+      ++nrow;
+    }
+    UTILS_ASSERT( nrow == xs4.size(), "dump: {} rows, {} samples\n", nrow, xs4.size() );
+  }
+  fmt::print( "dump:      {} bytes, same with 1 and 4 threads\n", o4.str().size() );
+
+  // visual tolerance: distance from the chord in the scaled plane
+  real_type const sx{ 200 }, sy{ 50 };
+  SplineSampler SC( 0.5, 4 );
+  SC.set_mode( SplineSampleMode::CHORD );
+  SC.set_scale( sx, sy );
+  vector<real_type> xc;
+  SC.sample( cs, xc );
+  check_nodes( xc, xx.data(), npts, "CHORD" );
+  real_type cerr{0};
+  for ( size_t i{1}; i < xc.size(); ++i ) {
+    real_type const ax{ sx*xc[i-1] }, ay{ sy*cs.eval(xc[i-1]) };
+    real_type const dx{ sx*xc[i]-ax }, dy{ sy*cs.eval(xc[i])-ay };
+    for ( integer k{1}; k < 64; ++k ) {
+      real_type const x{ xc[i-1] + (xc[i]-xc[i-1])*k/64.0 };
+      cerr = std::max( cerr, std::abs( (sx*x-ax)*dy - (sy*cs.eval(x)-ay)*dx ) / std::hypot( dx, dy ) );
+    }
+  }
+  UTILS_ASSERT( cerr <= 0.5, "CHORD: distance {} > 0.5\n", cerr );
+  fmt::print( "CHORD:     {} samples, distance {:.3e} <= 0.5\n", xc.size(), cerr );
+
+  // spline set: common abscissae, tolerance on every spline
+  char const * headers[]{ "a", "b" };
+  SplineType1D const stype[]{ SplineType1D::AKIMA, SplineType1D::QUINTIC };
+  real_type const * Y[]{ y0.data(), y1.data() };
+  SplineSet ss( "set" );
+  ss.build( 2, npts, headers, stype, xx.data(), Y );
+  vector<real_type> xset;
+  S4.sample( ss, xset );
+  check_nodes( xset, xx.data(), npts, "SplineSet" );
+  for ( integer j{0}; j < 2; ++j ) {
+    real_type const e{ polyline_error( xset, [&ss,j]( real_type x ) { return ss.eval( x, j ); } ) };
+    UTILS_ASSERT( e <= tol, "SplineSet `{}`: polyline error {} > {}\n", headers[j], e, tol );
+  }
+  fmt::print( "SplineSet: {} samples, error <= {} on every spline\n", xset.size(), tol );
+
+  // curve: euclidean distance of the curve from the chord
+  SplineVec sv( "curve" );
+  sv.setup( 2, npts, Y );
+  sv.set_knots_chord_length();
+  sv.catmull_rom();
+  SplineSampler SV( 1e-3, 4 );
+  SV.set_mode( SplineSampleMode::CHORD );
+  vector<real_type> ts;
+  SV.sample( sv, ts );
+  check_nodes( ts, sv.x_nodes(), npts, "SplineVec" );
+  real_type verr{0};
+  for ( size_t i{1}; i < ts.size(); ++i ) {
+    real_type a[2], b[2], p[2];
+    sv.eval( ts[i-1], a, 1 );
+    sv.eval( ts[i],   b, 1 );
+    real_type const dx{ b[0]-a[0] }, dy{ b[1]-a[1] }, L{ std::hypot( dx, dy ) };
+    for ( integer k{1}; k < 64; ++k ) {
+      sv.eval( ts[i-1] + (ts[i]-ts[i-1])*k/64.0, p, 1 );
+      real_type const d{
+        L > 0 ? std::abs( (p[0]-a[0])*dy - (p[1]-a[1])*dx ) / L : std::hypot( p[0]-a[0], p[1]-a[1] )
+      };
+      verr = std::max( verr, d );
+    }
+  }
+  UTILS_ASSERT( verr <= 1e-3, "SplineVec: distance {} > 1e-3\n", verr );
+  fmt::print( "SplineVec: {} samples, distance {:.3e} <= 1e-3\n", ts.size(), verr );
+
+  cout << "\nALL DONE!\n\n";
+}